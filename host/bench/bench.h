@@ -0,0 +1,69 @@
+/**
+ * @file bench.h
+ *
+ * @brief
+ *  Minimal timing loop for the host microbenchmarks
+ *
+ * @details
+ *  Host numbers rank alternatives against each other; they are not Cortex-M4
+ *  cycle counts. Each case runs a warm-up pass, then reports the best of
+ *  BENCH_REPEATS timed passes in nanoseconds per operation.
+ *
+ *  Benches linked against firmware_prof can also print a PROF probe with
+ *  bench_prof(). Its ticks are cycles on the target, where the same probe
+ *  reads the DWT cycle counter, and nanoseconds on the host.
+ *
+ */
+
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef PROF_ENABLE
+#include "prof.h"
+#endif
+
+#define BENCH_REPEATS   5
+
+static inline double bench_now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// runs fn(ops) and prints the best time per op
+static inline double bench_run(const char *name, void (*fn)(uint32_t ops), uint32_t ops){
+  double best = 0;
+
+  fn(ops);
+  for(int r = 0; r < BENCH_REPEATS; r++){
+      double t0 = bench_now_ns();
+      fn(ops);
+      double t = (bench_now_ns() - t0) / ops;
+      if(r == 0 || t < best){
+          best = t;
+      }
+  }
+  printf("%-32s %8.2f ns/op\n", name, best);
+  return best;
+}
+
+#ifdef PROF_ENABLE
+// prints the durations recorded by one probe, in ticks, p99 is a bucket bound
+static inline void bench_prof(PROF_ID id){
+  PROF_Stats_TypeDef p;
+  uint64_t seen = 0;
+  uint32_t b = 0;
+
+  prof_get(id, &p);
+  while(b < PROF_HIST_BUCKETS - 1 && (seen += p.hist[b]) < p.count * 0.99){
+      b++;
+  }
+  printf("%-32s %9u calls  min %u  mean %u  p99 < %llu  max %u ticks\n", prof_name(id),
+         p.count, p.min, p.mean, 2ull << b, p.max);
+}
+#endif
+
+#endif /* HOST_BENCH_H_ */
@@ -0,0 +1,168 @@
+/**
+ * @file bench_codec.c
+ *
+ * @brief
+ *  Compression ratio and cost of the sample codec on recorded and synthetic
+ *  traces
+ *
+ * @details
+ *  The recorded trace is a file of Si7021 codes, one per line, '#' starts a
+ *  comment, as printed by telemetry_decode -r from a telemetry capture. The
+ *  default, traces/sim_device_1d.txt, was captured from sim_device; a board
+ *  capture is given on the command line instead.
+ *
+ *  Each synthetic trace is 24 h at the 3 s sample period: a daily swing, a
+ *  slower HVAC like wobble and gaussian noise, quantized to Si7021 codes at
+ *  the given resolution. The noise comes from a fixed seed, so runs repeat.
+ *
+ *  Every trace is encoded with the flash log keyframe interval, decoded back
+ *  and checked sample for sample. The encode cost is the PROF_CODEC_ENCODE
+ *  probe over the recorded trace, in ticks, cycles when built for the board.
+ *
+ *  bench_codec [trace]
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include "bench.h"
+#include "host.h"
+#include "codec.h"
+
+#define TRACE_SAMPLES       (24u * 3600u / 3u)  // at most, synthetic traces are this long
+#define TRACE_MEAN          22.0            // degrees C
+#define TRACE_SWING         3.0
+#define TRACE_WOBBLE        0.5             // over TRACE_WOBBLE_S
+#define TRACE_WOBBLE_S      6000.0
+
+static uint16_t trace[TRACE_SAMPLES];
+static uint32_t trace_len;
+static uint8_t encoded[TRACE_SAMPLES * CODEC_MAX_BYTES];
+static uint32_t rng = 1;
+
+static double uniform(void){
+  rng ^= rng << 13;                         // xorshift32
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return (rng + 1.0) / 4294967297.0;
+}
+
+static double gauss(void){
+  return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+// Si7021 code with the bits below the resolution cleared
+static void make_trace(double noise, uint16_t mask){
+  for(uint32_t i = 0; i < TRACE_SAMPLES; i++){
+      double t = i * 3.0;
+      double temp = TRACE_MEAN + TRACE_SWING * sin(2.0 * M_PI * t / 86400.0)
+                  + TRACE_WOBBLE * sin(2.0 * M_PI * t / TRACE_WOBBLE_S) + noise * gauss();
+      trace[i] = (uint16_t)lround((temp + 46.85) * 65536.0 / 175.72) & mask;
+  }
+  trace_len = TRACE_SAMPLES;
+}
+
+static bool load_trace(const char *path){
+  FILE *f = fopen(path, "r");
+  char line[64];
+
+  if(!f){
+      perror(path);
+      return false;
+  }
+  trace_len = 0;
+  while(fgets(line, sizeof(line), f) && trace_len < TRACE_SAMPLES){
+      unsigned raw;
+
+      if(line[0] != '#' && sscanf(line, "%u", &raw) == 1){
+          trace[trace_len++] = (uint16_t)raw;
+      }
+  }
+  fclose(f);
+  return trace_len != 0;
+}
+
+static uint32_t encode_trace(void){
+  CODEC_State_TypeDef enc;
+  uint32_t len = 0;
+
+  codec_init(&enc, CODEC_KEYFRAME_INTERVAL);
+  for(uint32_t i = 0; i < trace_len; i++){
+      len += codec_encode(&enc, trace[i], &encoded[len]);
+  }
+  return len;
+}
+
+static bool decode_trace(uint32_t len){
+  CODEC_State_TypeDef dec;
+  uint32_t pos = 0;
+
+  codec_init(&dec, CODEC_KEYFRAME_INTERVAL);
+  for(uint32_t i = 0; i < trace_len; i++){
+      uint16_t raw;
+      uint32_t used = codec_decode(&dec, &encoded[pos], len - pos, &raw);
+
+      if(!used || !dec.synced || raw != trace[i]){
+          return false;
+      }
+      pos += used;
+  }
+  return pos == len;
+}
+
+static void report(const char *name){
+  uint32_t len = encode_trace();
+
+  printf("%-28s %6u samples %8.3f B/sample %6.2f:1   round trip %s\n", name, trace_len,
+         (double)len / trace_len, 2.0 * trace_len / len, decode_trace(len) ? "ok" : "FAILED");
+}
+
+static void report_synthetic(const char *name, double noise, uint16_t mask){
+  make_trace(noise, mask);
+  report(name);
+}
+
+static void bench_decode(uint32_t ops){
+  CODEC_State_TypeDef dec;
+  uint32_t len = encode_trace();
+  uint32_t pos = 0;
+  volatile uint32_t sink = 0;
+
+  codec_init(&dec, CODEC_KEYFRAME_INTERVAL);
+  for(uint32_t i = 0; i < ops; i++){
+      uint16_t raw;
+
+      if(pos == len){
+          pos = 0;
+      }
+      pos += codec_decode(&dec, &encoded[pos], len - pos, &raw);
+      sink += raw;
+  }
+  (void)sink;
+}
+
+int main(int argc, char **argv){
+  const char *path = argc > 1 ? argv[1] : BENCH_TRACE_DIR "/sim_device_1d.txt";
+
+  host_reset();
+  prof_open();
+
+  printf("keyframe every %u samples, ratio against 16 bit raw\n\n", CODEC_KEYFRAME_INTERVAL);
+  if(!load_trace(path)){
+      return 1;
+  }
+  report("recorded");
+  printf("  %s\n", path);
+
+  prof_clear();
+  encode_trace();
+  bench_prof(PROF_CODEC_ENCODE);
+  bench_run("codec_decode, host ns", bench_decode, 10000000);
+
+  printf("\nsynthetic, 24 h at 3 s\n");
+  report_synthetic("14 bit, 0.01 C noise", 0.01, 0xFFFC);
+  report_synthetic("14 bit, 0.05 C noise", 0.05, 0xFFFC);
+  report_synthetic("12 bit, 0.01 C noise", 0.01, 0xFFF0);
+  report_synthetic("14 bit, 0.20 C noise", 0.20, 0xFFFC);
+  return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file bench_flash_log.c
+ *
+ * @brief
+ *  Write amplification and energy per record of the flash log on the NOR
+ *  flash model
+ *
+ * @details
+ *  Fills the log with fixed size records, running every page commit step
+ *  the log posts, and prints flash_log_get_stats(). Energy is the erases and
+ *  programmed words times approximate EFM32PG12 datasheet figures for a
+ *  page erase and a word write, so it ranks record sizes rather than
+ *  predicting a board. Resume and torn page handling are covered by
+ *  test/test_flash_log.c.
+ *
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "host.h"
+#include "em_msc.h"
+#include "flash_log.h"
+#include "brd_config.h"
+
+#define FLASH_ERASE_UJ      (20000e-6 * 1.6e-3 * 3.0 * 1e6)   // 20 ms at 1.6 mA, 3 V
+#define FLASH_WORD_UJ       (10.6e-6 * 3.5e-3 * 3.0 * 1e6)    // 10.6 us at 3.5 mA, 3 V
+#define BENCH_RECORDS       100000u
+
+static void drain(void){
+  while(get_scheduled_events() & FLASH_LOG_CB){
+      remove_scheduled_event(FLASH_LOG_CB);
+      flash_log_commit();
+  }
+}
+
+static void fresh_log(void){
+  memset(host_flash, 0xFF, FLASH_SIZE);
+  flash_log_open(FLASH_LOG_CB);
+}
+
+static void fill(uint32_t len, uint32_t records){
+  uint8_t record[FLASH_LOG_PAYLOAD_SIZE];
+
+  for(uint32_t i = 0; i < records; i++){
+      memset(record, (int)i, len);
+      flash_log_write(record, len);
+      drain();
+  }
+}
+
+static void report_size(uint32_t len){
+  FLASH_LOG_Stats_TypeDef s;
+  double energy_uj;
+
+  fresh_log();
+  fill(len, BENCH_RECORDS);
+  flash_log_flush();                        // commit the last partial page too
+  drain();
+  flash_log_get_stats(&s);
+  energy_uj = s.erases * FLASH_ERASE_UJ + s.programmed_bytes / 4u * FLASH_WORD_UJ;
+
+  printf("%6u B %9u %7u %6u %6u %11u %8.4f %10.3f\n", len, s.records, s.dropped, s.pages,
+         s.erases, s.programmed_bytes, (double)s.programmed_bytes / s.payload_bytes,
+         s.records ? energy_uj / s.records : 0.0);
+}
+
+static void bench_write(uint32_t ops){
+  uint8_t record[2] = { 0x12, 0x34 };
+
+  for(uint32_t i = 0; i < ops; i++){
+      flash_log_write(record, sizeof(record));
+      drain();
+  }
+}
+
+int main(void){
+  static const uint32_t sizes[] = { 1, 2, 3, 8, 32, 128 };
+
+  host_reset();
+  scheduler_open();
+
+  printf("%d records per size, page erase %.1f uJ, word write %.3f uJ\n\n", BENCH_RECORDS,
+         FLASH_ERASE_UJ, FLASH_WORD_UJ);
+  printf("%8s %9s %7s %6s %6s %11s %8s %10s\n", "record", "records", "dropped", "pages",
+         "erases", "programmed", "amplif", "uJ/record");
+  for(uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++){
+      report_size(sizes[i]);
+  }
+
+  printf("\n");
+  fresh_log();
+  bench_run("flash_log_write 2 B + commits", bench_write, 1000000);
+  return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file bench_history.c
+ *
+ * @brief
+ *  Per insert cost of the trend history
+ *
+ * @details
+ *  Feeds a week of samples at the default rate, long enough for every tier
+ *  to wrap, and prints the PROF_HISTORY_INSERT probe over all of them. The
+ *  sample that closes an hour does the most work, a roll-up into all three
+ *  tiers, so those inserts are also timed on their own.
+ *
+ */
+
+#include "bench.h"
+#include "history.h"
+
+#define SAMPLES_PER_MINUTE  20u
+#define SAMPLES_PER_HOUR    (SAMPLES_PER_MINUTE * 60u)
+#define BENCH_SAMPLES       (SAMPLES_PER_HOUR * 24u * 7u)
+
+static void bench_insert(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      history_insert(0x6000u + (i & 0xFFu));
+  }
+}
+
+// timed on their own, prof_clear() keeps only the closing insert
+static void report_hour_close(void){
+  PROF_Stats_TypeDef p;
+  uint32_t min = UINT32_MAX, max = 0;
+  uint64_t total = 0;
+  uint32_t hours = 0;
+
+  history_open(SAMPLES_PER_MINUTE);
+  for(uint32_t i = 1; i <= BENCH_SAMPLES; i++){
+      if(i % SAMPLES_PER_HOUR){
+          history_insert(0x6000u + (i & 0xFFu));
+          continue;
+      }
+      prof_clear();
+      history_insert(0x6000u + (i & 0xFFu));
+      prof_get(PROF_HISTORY_INSERT, &p);
+      min = p.min < min ? p.min : min;
+      max = p.max > max ? p.max : max;
+      total += p.total;
+      hours++;
+  }
+  printf("%-32s %9u calls  min %u  mean %llu  max %u ticks\n", "history insert, hour close",
+         hours, min, (unsigned long long)((total + hours / 2) / hours), max);
+}
+
+int main(void){
+  printf("%u samples, %u per minute, %u ticks per second\n\n", BENCH_SAMPLES, SAMPLES_PER_MINUTE,
+         prof_tick_hz());
+
+  prof_open();
+  history_open(SAMPLES_PER_MINUTE);
+  bench_insert(BENCH_SAMPLES);
+  bench_prof(PROF_HISTORY_INSERT);
+  report_hour_close();
+
+  printf("\n");
+  history_open(SAMPLES_PER_MINUTE);
+  bench_run("history_insert, probe included", bench_insert, 10000000);
+  return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file bench_isr.c
+ *
+ * @brief
+ *  Cost of the LETIMER0 and GPIO interrupt handlers and the sleep counters
+ *  under the assertion tier the firmware was built with
+ *
+ * @details
+ *  Configure with -DHOST_ASSERT_TIER=OFF, CHEAP or DEBUG to compare tiers.
+ *  Registers are plain memory here, so a read back costs far less than on
+ *  the peripheral bus and the differences are a lower bound. A flag read
+ *  back can't pass on the host either, IFC only reaches IF in host_sync(),
+ *  so at the cheap tier every handler also logs a failure; the debug tier
+ *  without DEBUG_EFM runs the same passing check and is the one to compare.
+ *
+ */
+
+#include "bench.h"
+#include "host.h"
+#include "scheduler.h"
+#include "sleep_routines.h"
+#include "gpio.h"
+#include "letimer.h"
+#include "assert_log.h"
+
+void LETIMER0_IRQHandler(void);
+void GPIO_EVEN_IRQHandler(void);
+
+static void bench_letimer(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      LETIMER0->IF = LETIMER_IF_COMP0 | LETIMER_IF_COMP1 | LETIMER_IF_UF;
+      LETIMER0_IRQHandler();
+  }
+}
+
+static void bench_gpio(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      GPIO->IF = 1u << BUT0_PIN;
+      GPIO_EVEN_IRQHandler();
+      remove_scheduled_event(APP_BTN0_CB);
+  }
+}
+
+static void bench_block_unblock(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      sleep_block_mode(EM2);
+      sleep_unblock_mode(EM2);
+  }
+}
+
+int main(void){
+  host_reset();
+  scheduler_open();
+  sleep_open();
+  LETIMER0->IEN = LETIMER_IF_COMP0 | LETIMER_IF_COMP1 | LETIMER_IF_UF;
+  gpio_exti_open(BUT0_PORT, BUT0_PIN, false, true, APP_BTN0_CB);
+
+  assert_log_clear();
+
+  printf("assertion tiers: letimer %u gpio %u sleep %u (0 off, 1 cheap, 2 debug)\n",
+         LETIMER_ASSERT_TIER, GPIO_ASSERT_TIER, SLEEP_ASSERT_TIER);
+  bench_run("LETIMER0_IRQHandler, 3 flags", bench_letimer, 10000000);
+  bench_run("GPIO_EVEN_IRQHandler + remove", bench_gpio, 10000000);
+  bench_run("sleep_block + unblock_mode", bench_block_unblock, 10000000);
+  printf("failures logged %u\n", assert_log_count());
+  return 0;
+}
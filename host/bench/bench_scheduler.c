@@ -0,0 +1,76 @@
+/**
+ * @file bench_scheduler.c
+ *
+ * @brief
+ *  Cost of the scheduler and sleep routine primitives used on every event
+ *
+ * @details
+ *  Also counts the CORE critical sections each operation opens, which mask
+ *  every interrupt on the target.
+ *
+ */
+
+#include "bench.h"
+#include "host.h"
+#include "scheduler.h"
+#include "sleep_routines.h"
+#include "brd_config.h"
+
+static void bench_add_remove(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      add_scheduled_event(SENSOR_SAMPLE_CB);
+      remove_scheduled_event(SENSOR_SAMPLE_CB);
+  }
+}
+
+static void bench_get(uint32_t ops){
+  volatile uint32_t sink = 0;
+  for(uint32_t i = 0; i < ops; i++){
+      sink += get_scheduled_events();
+  }
+  (void)sink;
+}
+
+static void bench_block_unblock(uint32_t ops){
+  for(uint32_t i = 0; i < ops; i++){
+      sleep_block_mode(EM2);
+      sleep_unblock_mode(EM2);
+  }
+}
+
+static void bench_current_block(uint32_t ops){
+  volatile uint32_t sink = 0;
+  for(uint32_t i = 0; i < ops; i++){
+      sink += current_block_energy_mode();
+  }
+  (void)sink;
+}
+
+// critical sections per op and their host time, from one untimed pass
+static void bench_masked(const char *name, void (*fn)(uint32_t ops), uint32_t ops){
+  uint64_t sections = host_masked_sections;
+  uint64_t ns = host_masked_ns;
+
+  host_masked_max_ns = 0;
+  fn(ops);
+  sections = host_masked_sections - sections;
+  ns = host_masked_ns - ns;
+  printf("%-32s %8.2f sections/op %8.2f ns masked/op, max %llu ns\n", name, (double)sections / ops,
+         (double)ns / ops, (unsigned long long)host_masked_max_ns);
+}
+
+int main(void){
+  host_reset();
+  scheduler_open();
+  sleep_open();
+
+  bench_run("add + remove_scheduled_event", bench_add_remove, 10000000);
+  bench_run("get_scheduled_events", bench_get, 10000000);
+  bench_run("sleep_block + unblock_mode", bench_block_unblock, 10000000);
+  bench_run("current_block_energy_mode", bench_current_block, 10000000);
+
+  printf("\ninterrupts masked\n");
+  bench_masked("add + remove_scheduled_event", bench_add_remove, 1000000);
+  bench_masked("sleep_block + unblock_mode", bench_block_unblock, 1000000);
+  return 0;
+}
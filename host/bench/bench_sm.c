@@ -0,0 +1,101 @@
+/**
+ * @file bench_sm.c
+ *
+ * @brief
+ *  Dispatch cost of the table driven state machine against the switch
+ *  version it replaced
+ *
+ * @details
+ *  The table version dispatches to app_count_table, the ONE/TWO/THREE
+ *  counter in app.c, so it times the firmware's own table and entry action.
+ *  The switch version is the former app_state_machine() with the press
+ *  flags it was driven by. Both are fed the same pseudo random button
+ *  sequence and write the LEDs on the same transitions.
+ *
+ */
+
+#include "bench.h"
+#include "app.h"
+
+#define EVENTS      4096u
+
+static uint8_t events[EVENTS];
+
+//***********************************************************************************
+// switch version
+//***********************************************************************************
+
+typedef enum { ONE, TWO, THREE } tCountState;
+
+static struct {
+  tCountState state;
+  uint32_t num_press;
+  bool btn0;
+  bool btn1;
+} asm_state;
+
+static void switch_set_leds(void){
+  switch(asm_state.state){
+    case ONE:   GPIO_PinOutSet(LED0_PORT, LED0_PIN);   GPIO_PinOutClear(LED1_PORT, LED1_PIN); break;
+    case TWO:   GPIO_PinOutClear(LED0_PORT, LED0_PIN); GPIO_PinOutSet(LED1_PORT, LED1_PIN);   break;
+    case THREE: GPIO_PinOutSet(LED0_PORT, LED0_PIN);   GPIO_PinOutSet(LED1_PORT, LED1_PIN);   break;
+  }
+}
+
+static void switch_new_state(tCountState state){
+  asm_state.state = state;
+  switch_set_leds();
+  asm_state.num_press = 0;
+  asm_state.btn0 = false;
+  asm_state.btn1 = false;
+}
+
+static void switch_machine(void){
+  switch(asm_state.state){
+    case ONE:
+      if(asm_state.btn0) switch_new_state(TWO);
+      break;
+    case TWO:
+      if(asm_state.btn0) switch_new_state(ONE);
+      else if(asm_state.btn1) switch_new_state(THREE);
+      break;
+    case THREE:
+      if(asm_state.num_press == 2) switch_new_state(ONE);
+      break;
+  }
+}
+
+static void bench_switch(uint32_t ops){
+  switch_new_state(ONE);
+  for(uint32_t i = 0; i < ops; i++){
+      if(events[i % EVENTS] == APP_EV_BTN0) asm_state.btn0 = true;
+      else asm_state.btn1 = true;
+      asm_state.num_press++;
+      switch_machine();
+  }
+}
+
+//***********************************************************************************
+// table version
+//***********************************************************************************
+
+static void bench_table(uint32_t ops){
+  SM_Machine_TypeDef sm;
+  sm_open(&sm, &app_count_table);
+  for(uint32_t i = 0; i < ops; i++){
+      sm_dispatch(&sm, events[i % EVENTS]);
+  }
+}
+
+int main(void){
+  uint32_t seed = 12345;
+  for(uint32_t i = 0; i < EVENTS; i++){
+      seed = seed * 1103515245u + 12345u;
+      events[i] = (seed >> 16) & 1u;
+  }
+
+  double s = bench_run("switch app_state_machine", bench_switch, 1000000);
+  double t = bench_run("table sm_dispatch", bench_table, 1000000);
+  printf("table / switch: %.2f\n", t / s);
+  return 0;
+}
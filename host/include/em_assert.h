@@ -0,0 +1,22 @@
+/**
+ * @file em_assert.h
+ *
+ * @brief
+ *  Host stand-in for emlib assertions. As in the SDK the expression is still
+ *  evaluated when DEBUG_EFM is not defined.
+ *
+ */
+
+#ifndef HOST_EM_ASSERT_H_
+#define HOST_EM_ASSERT_H_
+
+#include "em_device.h"
+
+#if defined(DEBUG_EFM) || defined(DEBUG_EFM_USER)
+void assertEFM(const char *file, int line);
+#define EFM_ASSERT(expr)    ((expr) ? ((void)0) : assertEFM(__FILE__, __LINE__))
+#else
+#define EFM_ASSERT(expr)    ((void)(expr))
+#endif
+
+#endif /* HOST_EM_ASSERT_H_ */
@@ -0,0 +1,16 @@
+/**
+ * @file em_chip.h
+ *
+ * @brief
+ *  Host stand-in for emlib CHIP
+ *
+ */
+
+#ifndef HOST_EM_CHIP_H_
+#define HOST_EM_CHIP_H_
+
+#include "em_device.h"
+
+__STATIC_INLINE void CHIP_Init(void){}
+
+#endif /* HOST_EM_CHIP_H_ */
@@ -0,0 +1,69 @@
+/**
+ * @file em_cmu.h
+ *
+ * @brief
+ *  Host stand-in for emlib CMU
+ *
+ */
+
+#ifndef HOST_EM_CMU_H_
+#define HOST_EM_CMU_H_
+
+#include "em_device.h"
+
+typedef enum {
+  cmuClock_HF,
+  cmuClock_HFPER,
+  cmuClock_CORELE,
+  cmuClock_LFA,
+  cmuClock_LFB,
+  cmuClock_GPIO,
+  cmuClock_LETIMER0,
+  cmuClock_I2C0,
+  cmuClock_I2C1,
+  cmuClock_TIMER0,
+  cmuClock_LEUART0,
+  cmuClock_LDMA,
+  cmuClock_COUNT
+} CMU_Clock_TypeDef;
+
+typedef enum {
+  cmuOsc_LFXO,
+  cmuOsc_LFRCO,
+  cmuOsc_HFXO,
+  cmuOsc_HFRCO,
+  cmuOsc_AUXHFRCO,
+  cmuOsc_ULFRCO
+} CMU_Osc_TypeDef;
+
+typedef enum {
+  cmuSelect_Disabled,
+  cmuSelect_LFXO,
+  cmuSelect_LFRCO,
+  cmuSelect_HFXO,
+  cmuSelect_HFRCO,
+  cmuSelect_ULFRCO,
+  cmuSelect_HFCLKLE
+} CMU_Select_TypeDef;
+
+typedef enum {
+  cmuHFRCOFreq_1M0Hz  = 1000000U,
+  cmuHFRCOFreq_19M0Hz = 19000000U,
+  cmuHFRCOFreq_26M0Hz = 26000000U,
+  cmuHFRCOFreq_38M0Hz = 38000000U
+} CMU_HFRCOFreq_TypeDef;
+
+typedef struct {
+  uint32_t ctuneSteadyState;
+} CMU_HFXOInit_TypeDef;
+
+#define CMU_HFXOINIT_DEFAULT  { 0 }
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock);
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref);
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait);
+void CMU_HFRCOBandSet(CMU_HFRCOFreq_TypeDef setFreq);
+void CMU_HFXOInit(const CMU_HFXOInit_TypeDef *hfxoInit);
+
+#endif /* HOST_EM_CMU_H_ */
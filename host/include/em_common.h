@@ -0,0 +1,21 @@
+/**
+ * @file em_common.h
+ *
+ * @brief
+ *  Host stand-in for emlib common helpers
+ *
+ */
+
+#ifndef HOST_EM_COMMON_H_
+#define HOST_EM_COMMON_H_
+
+#include "em_device.h"
+
+#define SL_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define SL_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+__STATIC_INLINE uint32_t SL_CTZ(uint32_t value){
+  return __CLZ(__RBIT(value));
+}
+
+#endif /* HOST_EM_COMMON_H_ */
@@ -0,0 +1,25 @@
+/**
+ * @file em_core.h
+ *
+ * @brief
+ *  Host stand-in for emlib CORE critical sections
+ *
+ */
+
+#ifndef HOST_EM_CORE_H_
+#define HOST_EM_CORE_H_
+
+#include "em_device.h"
+
+typedef uint32_t CORE_irqState_t;
+
+CORE_irqState_t CORE_EnterCritical(void);
+void CORE_ExitCritical(CORE_irqState_t irqState);
+
+#define CORE_DECLARE_IRQ_STATE        CORE_irqState_t irqState
+#define CORE_ENTER_CRITICAL()         irqState = CORE_EnterCritical()
+#define CORE_EXIT_CRITICAL()          CORE_ExitCritical(irqState)
+#define CORE_ENTER_ATOMIC()           CORE_ENTER_CRITICAL()
+#define CORE_EXIT_ATOMIC()            CORE_EXIT_CRITICAL()
+
+#endif /* HOST_EM_CORE_H_ */
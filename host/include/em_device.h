@@ -0,0 +1,345 @@
+/**
+ * @file em_device.h
+ *
+ * @brief
+ *  Host stand-in for the EFM32PG12 device header. Peripherals are plain
+ *  memory so firmware register accesses can be observed and driven by the
+ *  host harness.
+ *
+ */
+
+#ifndef HOST_EM_DEVICE_H_
+#define HOST_EM_DEVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define __IM  volatile
+#define __OM  volatile
+#define __IOM volatile
+#define __STATIC_INLINE static inline
+
+//***********************************************************************************
+// Interrupt numbers
+//***********************************************************************************
+typedef enum {
+  GPIO_EVEN_IRQn = 10,
+  I2C0_IRQn      = 16,
+  GPIO_ODD_IRQn  = 18,
+  LDMA_IRQn      = 8,
+  LEUART0_IRQn   = 24,
+  LETIMER0_IRQn  = 26,
+  I2C1_IRQn      = 42,
+  HOST_IRQn_COUNT = 64
+} IRQn_Type;
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+
+//***********************************************************************************
+// Core intrinsics
+//***********************************************************************************
+__STATIC_INLINE uint32_t __RBIT(uint32_t v){
+  uint32_t r = 0;
+  for(int i = 0; i < 32; i++){
+      r = (r << 1) | (v & 1u);
+      v >>= 1;
+  }
+  return r;
+}
+__STATIC_INLINE uint32_t __CLZ(uint32_t v){
+  return v ? (uint32_t)__builtin_clz(v) : 32u;
+}
+
+// exclusive monitor, cleared when the harness takes an interrupt like
+// exception entry does on the core
+extern volatile uint32_t *host_exclusive;
+
+__STATIC_INLINE uint32_t __LDREXW(volatile uint32_t *addr){
+  host_exclusive = addr;
+  return *addr;
+}
+__STATIC_INLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr){
+  if(host_exclusive != addr){
+      return 1u;
+  }
+  host_exclusive = NULL;
+  *addr = value;
+  return 0u;
+}
+__STATIC_INLINE void __CLREX(void){
+  host_exclusive = NULL;
+}
+
+//***********************************************************************************
+// GPIO
+//***********************************************************************************
+typedef struct {
+  __IOM uint32_t CTRL;
+  __IOM uint32_t MODEL;
+  __IOM uint32_t MODEH;
+  __IOM uint32_t DOUT;
+  __OM  uint32_t DOUTTGL;
+  __IM  uint32_t DIN;
+  __IOM uint32_t PINLOCKN;
+  __IOM uint32_t OVTDIS;
+} GPIO_P_TypeDef;
+
+typedef struct {
+  GPIO_P_TypeDef P[12];
+  __IOM uint32_t EXTIPSELL;
+  __IOM uint32_t EXTIPSELH;
+  __IOM uint32_t EXTIPINSELL;
+  __IOM uint32_t EXTIPINSELH;
+  __IOM uint32_t EXTIRISE;
+  __IOM uint32_t EXTIFALL;
+  __IOM uint32_t EXTILEVEL;
+  __IM  uint32_t IF;
+  __OM  uint32_t IFS;
+  __OM  uint32_t IFC;
+  __IOM uint32_t IEN;
+  __IOM uint32_t EM4WUEN;
+  __IOM uint32_t ROUTEPEN;
+  __IOM uint32_t ROUTELOC0;
+} GPIO_TypeDef;
+
+#define _GPIO_IF_EXT_MASK           0x0000FFFFUL
+#define _GPIO_EXTINTNO_MAX          15u
+
+//***********************************************************************************
+// LETIMER
+//***********************************************************************************
+typedef struct {
+  __IOM uint32_t CTRL;
+  __IOM uint32_t CMD;
+  __IM  uint32_t STATUS;
+  __IM  uint32_t CNT;
+  __IOM uint32_t COMP0;
+  __IOM uint32_t COMP1;
+  __IOM uint32_t REP0;
+  __IOM uint32_t REP1;
+  __IM  uint32_t IF;
+  __OM  uint32_t IFS;
+  __OM  uint32_t IFC;
+  __IOM uint32_t IEN;
+  __IM  uint32_t SYNCBUSY;
+  __IOM uint32_t ROUTEPEN;
+  __IOM uint32_t ROUTELOC0;
+} LETIMER_TypeDef;
+
+#define LETIMER_STATUS_RUNNING            (0x1UL << 0)
+#define LETIMER_CMD_START                 (0x1UL << 0)
+#define LETIMER_CMD_STOP                  (0x1UL << 1)
+#define LETIMER_IF_COMP0                  (0x1UL << 0)
+#define _LETIMER_IF_COMP0_MASK            0x1UL
+#define LETIMER_IF_COMP1                  (0x1UL << 1)
+#define _LETIMER_IF_COMP1_MASK            0x2UL
+#define LETIMER_IF_UF                     (0x1UL << 2)
+#define _LETIMER_IF_UF_MASK               0x4UL
+#define LETIMER_IF_REP0                   (0x1UL << 3)
+#define LETIMER_IF_REP1                   (0x1UL << 4)
+#define LETIMER_IFC_COMP0                 LETIMER_IF_COMP0
+#define LETIMER_IFC_COMP1                 LETIMER_IF_COMP1
+#define LETIMER_IFC_UF                    LETIMER_IF_UF
+#define LETIMER_IEN_COMP0                 LETIMER_IF_COMP0
+#define LETIMER_IEN_COMP1                 LETIMER_IF_COMP1
+#define LETIMER_IEN_UF                    LETIMER_IF_UF
+#define LETIMER_ROUTEPEN_OUT0PEN          (0x1UL << 0)
+#define LETIMER_ROUTEPEN_OUT1PEN          (0x1UL << 1)
+#define _LETIMER_COMP0_MASK               0xFFFFUL
+#define _LETIMER_COMP1_MASK               0xFFFFUL
+#define _LETIMER_ROUTELOC0_OUT0LOC_LOC27  0x0000001BUL
+#define _LETIMER_ROUTELOC0_OUT0LOC_LOC28  0x0000001CUL
+#define _LETIMER_ROUTELOC0_OUT0LOC_LOC29  0x0000001DUL
+#define _LETIMER_ROUTELOC0_OUT1LOC_LOC27  0x0000001BUL
+#define _LETIMER_ROUTELOC0_OUT1LOC_LOC28  0x0000001CUL
+
+//***********************************************************************************
+// I2C
+//***********************************************************************************
+typedef struct {
+  __IOM uint32_t CTRL;
+  __IOM uint32_t CMD;
+  __IM  uint32_t STATE;
+  __IM  uint32_t STATUS;
+  __IOM uint32_t CLKDIV;
+  __IOM uint32_t SADDR;
+  __IOM uint32_t SADDRMASK;
+  __IM  uint32_t RXDATA;
+  __IM  uint32_t RXDOUBLE;
+  __IM  uint32_t RXDATAP;
+  __IM  uint32_t RXDOUBLEP;
+  __IOM uint32_t TXDATA;
+  __IOM uint32_t TXDOUBLE;
+  __IM  uint32_t IF;
+  __OM  uint32_t IFS;
+  __OM  uint32_t IFC;
+  __IOM uint32_t IEN;
+  __IOM uint32_t ROUTEPEN;
+  __IOM uint32_t ROUTELOC0;
+} I2C_TypeDef;
+
+#define I2C_CMD_START               (0x1UL << 0)
+#define I2C_CMD_STOP                (0x1UL << 1)
+#define I2C_CMD_ACK                 (0x1UL << 2)
+#define I2C_CMD_NACK                (0x1UL << 3)
+#define I2C_CMD_CONT                (0x1UL << 4)
+#define I2C_CMD_ABORT               (0x1UL << 5)
+#define I2C_CMD_CLEARTX             (0x1UL << 6)
+#define I2C_CMD_CLEARPC             (0x1UL << 7)
+
+#define I2C_IF_START                (0x1UL << 0)
+#define I2C_IF_RSTART               (0x1UL << 1)
+#define I2C_IF_ADDR                 (0x1UL << 2)
+#define I2C_IF_TXC                  (0x1UL << 3)
+#define I2C_IF_TXBL                 (0x1UL << 4)
+#define I2C_IF_RXDATAV              (0x1UL << 5)
+#define I2C_IF_ACK                  (0x1UL << 6)
+#define I2C_IF_NACK                 (0x1UL << 7)
+#define I2C_IF_MSTOP                (0x1UL << 8)
+#define I2C_IF_ARBLOST              (0x1UL << 9)
+#define I2C_IF_BUSERR               (0x1UL << 10)
+#define I2C_IF_BUSHOLD              (0x1UL << 11)
+#define I2C_IF_CLTO                 (0x1UL << 15)
+#define _I2C_IF_MASK                0x0007FFFFUL
+#define I2C_IFC_ACK                 I2C_IF_ACK
+#define I2C_IFC_NACK                I2C_IF_NACK
+#define I2C_IFC_MSTOP               I2C_IF_MSTOP
+#define I2C_IEN_RXDATAV             I2C_IF_RXDATAV
+#define I2C_IEN_ACK                 I2C_IF_ACK
+#define I2C_IEN_NACK                I2C_IF_NACK
+#define I2C_IEN_MSTOP               I2C_IF_MSTOP
+#define _I2C_IEN_RESETVALUE         0x00000000UL
+
+#define I2C_STATE_BUSY              (0x1UL << 0)
+#define _I2C_STATE_STATE_SHIFT      5
+#define _I2C_STATE_STATE_MASK       0xE0UL
+#define I2C_STATE_STATE_IDLE        (0x0UL << 5)
+
+#define I2C_ROUTEPEN_SDAPEN         (0x1UL << 0)
+#define I2C_ROUTEPEN_SCLPEN         (0x1UL << 1)
+#define _I2C_ROUTELOC0_SDALOC_SHIFT 0
+#define _I2C_ROUTELOC0_SCLLOC_SHIFT 8
+#define I2C_ROUTELOC0_SDALOC_LOC15  (0x0FUL << 0)
+#define I2C_ROUTELOC0_SCLLOC_LOC15  (0x0FUL << 8)
+
+//***********************************************************************************
+// TIMER
+//***********************************************************************************
+typedef struct {
+  __IOM uint32_t CTRL;
+  __IOM uint32_t CMD;
+  __IM  uint32_t STATUS;
+  __IOM uint32_t IF;
+  __IOM uint32_t IFS;
+  __IOM uint32_t IFC;
+  __IOM uint32_t IEN;
+  __IOM uint32_t TOP;
+  __IOM uint32_t TOPB;
+  __IOM uint32_t CNT;
+} TIMER_TypeDef;
+
+//***********************************************************************************
+// LEUART
+//***********************************************************************************
+typedef struct {
+  __IOM uint32_t CTRL;
+  __IOM uint32_t CMD;
+  __IM  uint32_t STATUS;
+  __IOM uint32_t CLKDIV;
+  __IOM uint32_t STARTFRAME;
+  __IOM uint32_t SIGFRAME;
+  __IM  uint32_t RXDATAX;
+  __IM  uint32_t RXDATA;
+  __IM  uint32_t RXDATAXP;
+  __IOM uint32_t TXDATAX;
+  __IOM uint32_t TXDATA;
+  __IM  uint32_t IF;
+  __OM  uint32_t IFS;
+  __OM  uint32_t IFC;
+  __IOM uint32_t IEN;
+  __IOM uint32_t PULSECTRL;
+  __IOM uint32_t FREEZE;
+  __IM  uint32_t SYNCBUSY;
+  __IOM uint32_t ROUTEPEN;
+  __IOM uint32_t ROUTELOC0;
+} LEUART_TypeDef;
+
+#define LEUART_CTRL_RXDMAWU           (0x1UL << 12)
+#define LEUART_CTRL_TXDMAWU           (0x1UL << 13)
+#define LEUART_CMD_RXEN               (0x1UL << 0)
+#define LEUART_CMD_RXDIS              (0x1UL << 1)
+#define LEUART_CMD_TXEN               (0x1UL << 2)
+#define LEUART_CMD_TXDIS              (0x1UL << 3)
+#define LEUART_CMD_CLEARTX            (0x1UL << 6)
+#define LEUART_CMD_CLEARRX            (0x1UL << 7)
+#define LEUART_STATUS_RXENS           (0x1UL << 0)
+#define LEUART_STATUS_TXENS           (0x1UL << 1)
+#define LEUART_STATUS_TXC             (0x1UL << 4)
+#define LEUART_STATUS_TXBL            (0x1UL << 5)
+#define LEUART_STATUS_RXDATAV         (0x1UL << 6)
+#define LEUART_IF_TXC                 (0x1UL << 0)
+#define LEUART_IF_TXBL                (0x1UL << 1)
+#define LEUART_IF_RXDATAV             (0x1UL << 2)
+#define LEUART_IF_RXOF                (0x1UL << 3)
+#define LEUART_IF_FERR                (0x1UL << 7)
+#define _LEUART_IF_MASK               0x000007FFUL
+#define LEUART_IFC_TXC                LEUART_IF_TXC
+#define LEUART_IFC_RXOF               LEUART_IF_RXOF
+#define LEUART_IEN_TXC                LEUART_IF_TXC
+#define LEUART_IEN_RXDATAV            LEUART_IF_RXDATAV
+#define LEUART_ROUTEPEN_RXPEN         (0x1UL << 0)
+#define LEUART_ROUTEPEN_TXPEN         (0x1UL << 1)
+#define _LEUART_ROUTELOC0_RXLOC_SHIFT 0
+#define _LEUART_ROUTELOC0_TXLOC_SHIFT 8
+#define LEUART_ROUTELOC0_RXLOC_LOC18  (0x12UL << 0)
+#define LEUART_ROUTELOC0_TXLOC_LOC18  (0x12UL << 8)
+
+//***********************************************************************************
+// Flash (memory backed)
+//***********************************************************************************
+#define FLASH_PAGE_SIZE   2048u
+#define FLASH_SIZE        (256u * 1024u)
+extern uint8_t host_flash[];
+#define FLASH_BASE        ((uintptr_t)host_flash)
+#define FLASH_LOG_IMAGE_END FLASH_BASE     // the host image is not in host_flash
+
+//***********************************************************************************
+// Stack (memory backed)
+//***********************************************************************************
+// stands in for the linker script's stack so mem.c has one to paint, the
+// firmware itself runs on the host stack
+#define HOST_STACK_SIZE   1024u
+extern uint32_t host_stack[];
+#define MEM_STACK_LIMIT   host_stack
+#define MEM_STACK_TOP     (host_stack + HOST_STACK_SIZE / 4u)
+#define MEM_STATIC_RAM    0u
+
+//***********************************************************************************
+// Peripheral instances (memory backed)
+//***********************************************************************************
+extern GPIO_TypeDef    host_gpio;
+extern LETIMER_TypeDef host_letimer0;
+extern I2C_TypeDef     host_i2c1;
+extern TIMER_TypeDef   host_timer0;
+extern LEUART_TypeDef  host_leuart0;
+
+// I2C0 has a page to itself so the bus model can trap accesses to it
+#define HOST_PAGE_SIZE    4096u
+
+typedef union {
+  I2C_TypeDef regs;
+  uint8_t page[HOST_PAGE_SIZE];
+} host_page_i2c_t;
+
+extern host_page_i2c_t host_i2c0;
+
+#define GPIO      (&host_gpio)
+#define LETIMER0  (&host_letimer0)
+#define I2C0      (&host_i2c0.regs)
+#define I2C1      (&host_i2c1)
+#define TIMER0    (&host_timer0)
+#define LEUART0   (&host_leuart0)
+
+#endif /* HOST_EM_DEVICE_H_ */
@@ -0,0 +1,37 @@
+/**
+ * @file em_emu.h
+ *
+ * @brief
+ *  Host stand-in for emlib EMU
+ *
+ */
+
+#ifndef HOST_EM_EMU_H_
+#define HOST_EM_EMU_H_
+
+#include "em_device.h"
+
+typedef enum {
+  emuVScaleEM23_FastWakeup,
+  emuVScaleEM23_LowPower
+} EMU_VScaleEM23_TypeDef;
+
+typedef struct {
+  bool em23VregFullEn;
+  EMU_VScaleEM23_TypeDef vScaleEM23Voltage;
+} EMU_EM23Init_TypeDef;
+
+typedef struct {
+  uint32_t dcdcMode;
+} EMU_DCDCInit_TypeDef;
+
+#define EMU_EM23INIT_DEFAULT  { false, emuVScaleEM23_FastWakeup }
+#define EMU_DCDCINIT_DEFAULT  { 0 }
+
+void EMU_EnterEM1(void);
+void EMU_EnterEM2(bool restore);
+void EMU_EnterEM3(bool restore);
+void EMU_EM23Init(const EMU_EM23Init_TypeDef *em23Init);
+bool EMU_DCDCInit(const EMU_DCDCInit_TypeDef *dcdcInit);
+
+#endif /* HOST_EM_EMU_H_ */
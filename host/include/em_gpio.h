@@ -0,0 +1,56 @@
+/**
+ * @file em_gpio.h
+ *
+ * @brief
+ *  Host stand-in for emlib GPIO
+ *
+ */
+
+#ifndef HOST_EM_GPIO_H_
+#define HOST_EM_GPIO_H_
+
+#include "em_device.h"
+
+typedef enum {
+  gpioPortA = 0,
+  gpioPortB = 1,
+  gpioPortC = 2,
+  gpioPortD = 3,
+  gpioPortE = 4,
+  gpioPortF = 5
+} GPIO_Port_TypeDef;
+
+typedef enum {
+  gpioModeDisabled,
+  gpioModeInput,
+  gpioModeInputPull,
+  gpioModePushPull,
+  gpioModeWiredAnd
+} GPIO_Mode_TypeDef;
+
+typedef enum {
+  gpioDriveStrengthWeakAlternateWeak,
+  gpioDriveStrengthWeakAlternateStrong,
+  gpioDriveStrengthStrongAlternateWeak,
+  gpioDriveStrengthStrongAlternateStrong
+} GPIO_DriveStrength_TypeDef;
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength);
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out);
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin, unsigned int intNo,
+                       bool risingEdge, bool fallingEdge, bool enable);
+
+__STATIC_INLINE void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin){
+  GPIO->P[port].DOUT |= 1u << pin;
+}
+__STATIC_INLINE void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin){
+  GPIO->P[port].DOUT &= ~(1u << pin);
+}
+__STATIC_INLINE void GPIO_PinOutToggle(GPIO_Port_TypeDef port, unsigned int pin){
+  GPIO->P[port].DOUT ^= 1u << pin;
+}
+__STATIC_INLINE unsigned int GPIO_PinInGet(GPIO_Port_TypeDef port, unsigned int pin){
+  return (GPIO->P[port].DIN >> pin) & 1u;
+}
+
+#endif /* HOST_EM_GPIO_H_ */
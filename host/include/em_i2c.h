@@ -0,0 +1,34 @@
+/**
+ * @file em_i2c.h
+ *
+ * @brief
+ *  Host stand-in for emlib I2C
+ *
+ */
+
+#ifndef HOST_EM_I2C_H_
+#define HOST_EM_I2C_H_
+
+#include "em_device.h"
+
+#define I2C_FREQ_STANDARD_MAX   92000
+#define I2C_FREQ_FAST_MAX       392000
+#define I2C_FREQ_FASTPLUS_MAX   987500
+
+typedef enum {
+  i2cClockHLRStandard,
+  i2cClockHLRAsymetric,
+  i2cClockHLRFast
+} I2C_ClockHLR_TypeDef;
+
+typedef struct {
+  bool enable;
+  bool master;
+  uint32_t refFreq;
+  uint32_t freq;
+  I2C_ClockHLR_TypeDef clhr;
+} I2C_Init_TypeDef;
+
+void I2C_Init(I2C_TypeDef *i2c, const I2C_Init_TypeDef *init);
+
+#endif /* HOST_EM_I2C_H_ */
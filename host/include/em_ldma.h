@@ -0,0 +1,47 @@
+/**
+ * @file em_ldma.h
+ *
+ * @brief
+ *  Host stand-in for emlib LDMA. Only the memory to peripheral byte transfer
+ *  used by the firmware is modelled.
+ *
+ */
+
+#ifndef HOST_EM_LDMA_H_
+#define HOST_EM_LDMA_H_
+
+#include "em_device.h"
+
+typedef enum {
+  ldmaPeripheralSignal_NONE = 0,
+  ldmaPeripheralSignal_LEUART0_TXBL,
+  ldmaPeripheralSignal_LEUART0_RXDATAV
+} LDMA_PeripheralSignal_t;
+
+typedef struct {
+  uint32_t ldmaReqSel;
+} LDMA_TransferCfg_t;
+
+typedef struct {
+  const void *srcAddr;
+  volatile void *dstAddr;
+  uint32_t xferCnt;
+} LDMA_Descriptor_t;
+
+typedef struct {
+  uint8_t ldmaInitCtrlNumFixed;
+  uint8_t ldmaInitCtrlSyncPrsClrEn;
+  uint8_t ldmaInitCtrlSyncPrsSetEn;
+  uint8_t ldmaInitIrqPriority;
+} LDMA_Init_t;
+
+#define LDMA_INIT_DEFAULT                                   { 0, 0, 0, 3 }
+#define LDMA_TRANSFER_CFG_PERIPHERAL(signal)                { (uint32_t)(signal) }
+#define LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(src, dest, count)   { (src), (dest), (count) }
+
+void LDMA_Init(const LDMA_Init_t *init);
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer, const LDMA_Descriptor_t *descriptor);
+bool LDMA_TransferDone(int ch);
+void LDMA_StopTransfer(int ch);
+
+#endif /* HOST_EM_LDMA_H_ */
@@ -0,0 +1,44 @@
+/**
+ * @file em_letimer.h
+ *
+ * @brief
+ *  Host stand-in for emlib LETIMER
+ *
+ */
+
+#ifndef HOST_EM_LETIMER_H_
+#define HOST_EM_LETIMER_H_
+
+#include "em_device.h"
+
+typedef enum {
+  letimerRepeatFree,
+  letimerRepeatOneshot,
+  letimerRepeatBuffered,
+  letimerRepeatDouble
+} LETIMER_RepeatMode_TypeDef;
+
+typedef enum {
+  letimerUFOANone,
+  letimerUFOAToggle,
+  letimerUFOAPulse,
+  letimerUFOAPwm
+} LETIMER_UFOA_TypeDef;
+
+typedef struct {
+  bool enable;
+  bool debugRun;
+  bool comp0Top;
+  bool bufTop;
+  uint8_t out0Pol;
+  uint8_t out1Pol;
+  LETIMER_UFOA_TypeDef ufoa0;
+  LETIMER_UFOA_TypeDef ufoa1;
+  LETIMER_RepeatMode_TypeDef repMode;
+  uint32_t topValue;
+} LETIMER_Init_TypeDef;
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init);
+void LETIMER_Enable(LETIMER_TypeDef *letimer, bool enable);
+
+#endif /* HOST_EM_LETIMER_H_ */
@@ -0,0 +1,48 @@
+/**
+ * @file em_leuart.h
+ *
+ * @brief
+ *  Host stand-in for emlib LEUART
+ *
+ */
+
+#ifndef HOST_EM_LEUART_H_
+#define HOST_EM_LEUART_H_
+
+#include "em_device.h"
+
+typedef enum {
+  leuartDisable  = 0x0,
+  leuartEnableRx = LEUART_CMD_RXEN,
+  leuartEnableTx = LEUART_CMD_TXEN,
+  leuartEnable   = LEUART_CMD_RXEN | LEUART_CMD_TXEN
+} LEUART_Enable_TypeDef;
+
+typedef enum {
+  leuartDatabits8 = 0
+} LEUART_Databits_TypeDef;
+
+typedef enum {
+  leuartNoParity   = 0,
+  leuartEvenParity = 2,
+  leuartOddParity  = 3
+} LEUART_Parity_TypeDef;
+
+typedef enum {
+  leuartStopbits1 = 0,
+  leuartStopbits2 = 1
+} LEUART_Stopbits_TypeDef;
+
+typedef struct {
+  LEUART_Enable_TypeDef enable;
+  uint32_t refFreq;
+  uint32_t baudrate;
+  LEUART_Databits_TypeDef databits;
+  LEUART_Parity_TypeDef parity;
+  LEUART_Stopbits_TypeDef stopbits;
+} LEUART_Init_TypeDef;
+
+void LEUART_Init(LEUART_TypeDef *leuart, LEUART_Init_TypeDef const *init);
+void LEUART_Enable(LEUART_TypeDef *leuart, LEUART_Enable_TypeDef enable);
+
+#endif /* HOST_EM_LEUART_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @file em_msc.h
+ *
+ * @brief
+ *  Host stand-in for emlib MSC, programming the memory backed flash
+ *
+ */
+
+#ifndef HOST_EM_MSC_H_
+#define HOST_EM_MSC_H_
+
+#include "em_device.h"
+
+typedef enum {
+  mscReturnOk          = 0,
+  mscReturnInvalidAddr = -1,
+  mscReturnLocked      = -2,
+  mscReturnTimeOut     = -3,
+  mscReturnUnaligned   = -4
+} MSC_Status_TypeDef;
+
+void MSC_Init(void);
+void MSC_Deinit(void);
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress);
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes);
+
+#endif /* HOST_EM_MSC_H_ */
@@ -0,0 +1,17 @@
+/**
+ * @file em_ramfunc.h
+ *
+ * @brief
+ *  Host stand-in for emlib RAM function placement. Host code always runs
+ *  from the same memory, so the declarator is empty.
+ *
+ */
+
+#ifndef HOST_EM_RAMFUNC_H_
+#define HOST_EM_RAMFUNC_H_
+
+#define SL_RAMFUNC_DECLARATOR
+#define SL_RAMFUNC_DEFINITION_BEGIN
+#define SL_RAMFUNC_DEFINITION_END
+
+#endif /* HOST_EM_RAMFUNC_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @file em_timer.h
+ *
+ * @brief
+ *  Host stand-in for emlib TIMER
+ *
+ */
+
+#ifndef HOST_EM_TIMER_H_
+#define HOST_EM_TIMER_H_
+
+#include "em_device.h"
+
+typedef enum {
+  timerModeUp,
+  timerModeDown,
+  timerModeUpDown,
+  timerModeQDec
+} TIMER_Mode_TypeDef;
+
+typedef enum {
+  timerPrescale1    = 0,
+  timerPrescale1024 = 10
+} TIMER_Prescale_TypeDef;
+
+typedef struct {
+  bool enable;
+  bool debugRun;
+  TIMER_Prescale_TypeDef prescale;
+  TIMER_Mode_TypeDef mode;
+  bool oneShot;
+} TIMER_Init_TypeDef;
+
+#define TIMER_INIT_DEFAULT  { true, true, timerPrescale1, timerModeUp, false }
+
+void TIMER_Init(TIMER_TypeDef *timer, const TIMER_Init_TypeDef *init);
+void TIMER_Enable(TIMER_TypeDef *timer, bool enable);
+
+#endif /* HOST_EM_TIMER_H_ */
@@ -0,0 +1,68 @@
+/**
+ * @file host.h
+ *
+ * @brief
+ *  Host harness for running firmware modules on Linux
+ *
+ * @details
+ *  Peripheral registers are plain memory. Writes to IFS/IFC only land in
+ *  memory, so host_sync() folds them into IF the way the hardware would;
+ *  it runs around every interrupt the harness delivers, when a critical
+ *  section ends and when the firmware goes to sleep. Interrupts are
+ *  delivered with host_irq_invoke(), which honours the NVIC enables and
+ *  CORE critical sections like the core would.
+ *
+ *  Register side effects that can't be seen from memory (write to TXDATA,
+ *  read of RXDATA) are modelled by the helpers below or by the peripheral
+ *  models built on top of this harness. A model that keeps IF itself
+ *  registers with host_if_model() so host_sync() leaves that IF alone.
+ *
+ */
+
+#ifndef HOST_HOST_H_
+#define HOST_HOST_H_
+
+#include "em_device.h"
+
+#define HOST_LEUART_TX_CAPTURE    4096u
+
+// number of EMU_EnterEMx() calls per energy mode, index 0 unused
+extern uint32_t host_em_entries[5];
+
+// called on every EMU_EnterEMx() with the energy mode, lets the harness
+// deliver the interrupt that wakes the core. NULL returns immediately.
+extern void (*host_sleep_hook)(uint32_t em);
+
+// simulated time, advanced by the peripheral models that keep time
+extern uint64_t host_time_ns;
+
+// called at the end of every host_sync(), lets a peripheral model pick up
+// register writes and refresh what the firmware reads. NULL does nothing.
+extern void (*host_sync_hook)(void);
+
+// interrupts delivered to each handler since host_reset()
+extern uint32_t host_irq_count[HOST_IRQn_COUNT];
+
+// CORE critical sections entered with none already open, and the host time
+// spent inside them, since host_reset()
+extern uint64_t host_masked_sections;
+extern uint64_t host_masked_ns;
+extern uint64_t host_masked_max_ns;
+
+// bytes the LDMA has moved into LEUART0->TXDATA
+extern uint8_t host_leuart0_tx[HOST_LEUART_TX_CAPTURE];
+extern uint32_t host_leuart0_tx_len;
+
+void host_reset(void);
+void host_sync(void);
+void host_irq_invoke(IRQn_Type irq);
+bool host_irq_enabled(IRQn_Type irq);
+bool host_irq_masked(void);
+bool host_irq_wake_pending(void);
+void host_if_model(IRQn_Type irq, bool owned);
+
+void host_ldma_run(void);
+uint32_t host_ldma_outstanding(void);
+void host_leuart0_rx(uint8_t byte);
+
+#endif /* HOST_HOST_H_ */
@@ -0,0 +1,89 @@
+/**
+ * @file host_i2c.h
+ *
+ * @brief
+ *  Register level model of I2C0 and the bus behind it
+ *
+ * @details
+ *  Plain memory can't show the model a write to CMD or TXDATA, or a read of
+ *  RXDATA, so once attached the I2C0 page is kept inaccessible. Every
+ *  firmware access faults, the model puts its registers into the page,
+ *  single steps the instruction and picks up whatever was written. The
+ *  firmware runs unchanged, including its busy waits. This needs Linux on
+ *  x86-64.
+ *
+ *  Trapping costs microseconds per access. With host_i2c_set_trapping(false)
+ *  the page stays accessible and the model exchanges registers with it from
+ *  host_sync() instead, which is enough for interrupt driven transfers but
+ *  sees only the last of several writes to one register in between, and
+ *  leaves busy waits on I2C0 hanging. A STOP while a received byte waits
+ *  for its ACK implies the NACK the driver writes just before it.
+ *
+ *  With fast polling, once a device has NACKed the same read address twice
+ *  because it is busy, the identical retries up to the time it will answer
+ *  are skipped in one step: time moves on, and the NACKs, STARTs and I2C0
+ *  interrupts they would have produced are counted.
+ *
+ *  The bus advances one SCL period per host_i2c_tick(). A bit takes one
+ *  period, START and STOP one each, a byte nine with its ACK. Polling
+ *  IF, STATE or STATUS from thread mode also advances the bus one period, so
+ *  loops like the one in i2c_bus_reset() terminate. Interrupts are only
+ *  delivered from host_i2c_tick().
+ *
+ *  Devices are attached with host_i2c_add_device(). Faults can be injected
+ *  for the next transfers: NACKs the devices didn't send, and SDA held low
+ *  by something on the bus.
+ *
+ *  Call host_reset() before host_i2c_attach(), never while attached.
+ *
+ */
+
+#ifndef HOST_HOST_I2C_H_
+#define HOST_HOST_I2C_H_
+
+#include "em_device.h"
+
+#define HOST_I2C_MAX_DEVICES    4u
+
+typedef struct host_i2c_device host_i2c_device_t;
+
+struct host_i2c_device {
+  uint8_t address;                                            // 7 bit address
+  bool (*start)(host_i2c_device_t *dev, bool read);           // addressed, return true to ACK
+  bool (*write)(host_i2c_device_t *dev, uint8_t byte);        // return true to ACK
+  bool (*read)(host_i2c_device_t *dev, uint8_t *byte);        // return false to stretch SCL
+  void (*stop)(host_i2c_device_t *dev);                       // STOP, or the bus was abandoned
+  uint64_t (*busy_until)(host_i2c_device_t *dev);             // time it ACKs a read again, optional
+};
+
+typedef struct {
+  uint64_t ticks;             // SCL periods simulated
+  uint32_t accesses;          // firmware register accesses trapped
+  uint32_t starts;            // START and repeated START conditions
+  uint32_t acks;
+  uint32_t nacks;             // including injected ones
+  uint32_t injected_nacks;
+  uint32_t stretch_ticks;     // periods a device held SCL low
+  uint32_t arb_lost;          // transfers lost to a stuck SDA line
+  uint32_t held_starts;       // periods a START waited for SDA
+  uint32_t skipped_polls;     // busy NACK retries skipped by fast polling
+} host_i2c_stats_t;
+
+void host_i2c_attach(void);
+void host_i2c_detach(void);
+void host_i2c_add_device(host_i2c_device_t *dev);
+void host_i2c_set_trapping(bool trap);
+void host_i2c_set_fast_poll(bool enable, uint64_t limit_ns);
+
+void host_i2c_tick(void);
+uint32_t host_i2c_tick_ns(void);
+bool host_i2c_idle(void);
+bool host_i2c_pending(void);
+
+void host_i2c_fault_nack(uint32_t after, uint32_t count);
+void host_i2c_fault_stuck_sda(uint64_t duration_ns);
+
+void host_i2c_get_stats(host_i2c_stats_t *stats);
+void host_i2c_clear_stats(void);
+
+#endif /* HOST_HOST_I2C_H_ */
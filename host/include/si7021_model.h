@@ -0,0 +1,60 @@
+/**
+ * @file si7021_model.h
+ *
+ * @brief
+ *  Behavioural Si7021 for the host I2C bus model
+ *
+ * @details
+ *  Covers the temperature path the firmware uses and the registers around
+ *  it:
+ *   - 0xF3 starts a conversion and the read address is NACKed until it is
+ *     done, 0xE3 does the same but stretches SCL instead
+ *   - conversion time and result resolution follow User Register 1, using
+ *     the datasheet maximums
+ *   - results are MSB, LSB and a CRC-8 (x^8 + x^5 + x^4 + 1) the master
+ *     only sees if it ACKs the LSB
+ *   - 0xE6 / 0xE7 write and read User Register 1, 0xFE resets it
+ *   - optional gaussian noise and spikes on each conversion, drawn from a
+ *     private xorshift so runs with the same seed repeat
+ *  Unknown commands are NACKed.
+ *
+ */
+
+#ifndef HOST_SI7021_MODEL_H_
+#define HOST_SI7021_MODEL_H_
+
+#include "host_i2c.h"
+
+#define SI7021_MODEL_ADDRESS      0x40u
+#define SI7021_MODEL_USER_RESET   0x3Au
+
+typedef struct {
+  host_i2c_device_t dev;          // first, the bus hands this back
+  double temperature;             // degrees C the next conversion measures
+  uint8_t user_reg;
+  double noise;                   // rms degrees C added to each conversion
+  double spike_rate;              // share of conversions off by spike
+  double spike;                   // degrees C, either sign
+  uint32_t seed;
+
+  uint32_t conversions;
+  uint32_t busy_nacks;            // read addresses NACKed during a conversion
+  uint64_t converting_ns;         // total time spent converting
+
+  // private
+  uint8_t expect;
+  bool converting;
+  bool hold;
+  uint64_t ready_ns;
+  uint8_t out[3];
+  uint8_t out_len;
+  uint8_t out_pos;
+  uint32_t rng;
+} si7021_model_t;
+
+void si7021_model_init(si7021_model_t *model, double temperature);
+uint32_t si7021_model_conversion_ns(uint8_t user_reg);
+uint16_t si7021_model_code(double temperature, uint8_t user_reg);
+uint8_t si7021_model_crc(const uint8_t *data, uint32_t len);
+
+#endif /* HOST_SI7021_MODEL_H_ */
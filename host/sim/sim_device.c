@@ -0,0 +1,647 @@
+/**
+ * @file sim_device.c
+ *
+ * @brief
+ *  Discrete-event simulation of the whole device, for energy and latency
+ *  projections
+ *
+ * @details
+ *  Runs the real firmware from main(): boot, the main loop, the scheduler
+ *  and enter_sleep(). Interrupt sources are simulated around it: LETIMER0
+ *  COMP1/UF from COMP0 and COMP1, button presses on GPIO, the Si7021 on the
+ *  I2C0 bus model, LDMA transfers into LEUART0 at the line rate and shell
+ *  commands arriving on LEUART0 RX.
+ *
+ *  The virtual clock only moves while the firmware sleeps, jumping straight
+ *  to the next event, plus fixed costs for waking up and for each scheduled
+ *  callback. Firmware code itself takes no simulated time. Once the firmware
+ *  is running, the I2C model leaves register trapping and skips busy read
+ *  polls, so a month takes seconds. Nothing advances the bus while thread
+ *  mode spins, so an I2C transfer started while another is still in flight
+ *  hangs the simulation in i2c_start().
+ *
+ *  Currents and timings in sim_power are approximate datasheet typicals for
+ *  the EFM32PG12 and the Si7021 and leave out board loads such as the LEDs.
+ *
+ *  The Si7021 model can add gaussian noise (--noise, rms degrees C) and
+ *  spikes (--spikes, share of conversions off by SPIKE_C) to each
+ *  conversion. The filtered sample reaching alarm_update() is compared with
+ *  the noise free temperature, which prices the noise filter settings
+ *  against the current they cost, e.g. --shell "burst 4".
+ *
+ *  --capture writes every byte sent on LEUART0 TX to a file, the same stream
+ *  tools/telemetry_decode reads from the board.
+ *
+ *  sim_device [--days D] [--presses-per-hour N] [--battery-mah C]
+ *             [--seed S] [--noise C] [--spikes P] [--shell "command"]...
+ *             [--capture FILE]
+ *
+ */
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+#include "host_i2c.h"
+#include "si7021_model.h"
+#include "main.h"
+#include "prof.h"
+
+#define NS_PER_US           1000ull
+#define NS_PER_S            1000000000ull
+#define NS_PER_HOUR         (3600ull * NS_PER_S)
+#define NS_PER_DAY          (24ull * NS_PER_HOUR)
+#define NEVER               UINT64_MAX
+
+#define UART_FRAME_BITS     10u             // start, 8 data, stop
+#define SHELL_MAX_BYTES     256u
+#define EVENT_BITS          32u
+#define HIST_BUCKETS        32u
+
+#define TEMP_MEAN           22.0            // degrees C
+#define TEMP_SWING          4.0             // daily amplitude
+#define SPIKE_C             2.0             // size of a --spikes outlier
+
+int firmware_main(void);
+
+void __real_add_scheduled_event(uint32_t event);
+void __real_remove_scheduled_event(uint32_t event);
+void __real_enter_sleep(void);
+void __real_alarm_update(uint32_t raw);
+
+//***********************************************************************************
+// Parameters
+//***********************************************************************************
+
+static const struct {
+  double em_ua[MAX_ENERGY_MODES];   // supply current in each mode
+  double wake_us[MAX_ENERGY_MODES]; // wakeup time from each mode to EM0
+  double active_us;                 // EM0 per wakeup: interrupt, main loop pass, back to sleep
+  double dispatch_us;               // EM0 per scheduled callback
+  double sensor_ua;                 // Si7021 while converting
+} sim_power = {
+  .em_ua   = { 1330.0, 670.0, 2.5, 2.1, 0.9 },
+  .wake_us = { 0.0, 1.4, 10.7, 10.7, 0.0 },
+  .active_us = 20.0,
+  .dispatch_us = 50.0,
+  .sensor_ua = 90.0,
+};
+
+static struct {
+  double days;
+  double presses_per_hour;
+  double battery_mah;
+  uint32_t seed;
+  double noise;
+  double spikes;
+  char shell[SHELL_MAX_BYTES];
+  uint32_t shell_len;
+  const char *capture;
+} opt = { 30.0, 0.0, 225.0, 1, 0.0, 0.0, { 0 }, 0, NULL };
+
+//***********************************************************************************
+// State
+//***********************************************************************************
+
+typedef struct {
+  uint64_t count;
+  uint64_t sum_ns;
+  uint64_t max_ns;
+  uint64_t bucket[HIST_BUCKETS];    // [2^b, 2^(b+1)) us, bucket 0 also holds < 1 us
+} sim_hist_t;
+
+static si7021_model_t sensor;
+static jmp_buf sim_end;
+static uint64_t horizon_ns;
+static bool booted;
+
+// event sources, NEVER when idle
+static uint64_t letimer_reload_ns = NEVER;
+static uint64_t letimer_comp1_ns = NEVER;
+static uint64_t letimer_uf_ns = NEVER;
+static uint64_t ldma_done_ns = NEVER;
+static uint64_t press_ns = NEVER;
+static uint64_t shell_ns = NEVER;
+static uint32_t shell_pos;
+static uint32_t shell_lost;
+static FILE *capture;                       // LEUART0 TX bytes, NULL for none
+
+// accounting
+static uint64_t residency_ns[MAX_ENERGY_MODES];
+static uint64_t wakeups;
+static uint64_t uart_bytes;
+static uint64_t presses;
+static uint64_t irq_raised_ns;
+static uint64_t post_ns[EVENT_BITS];
+static sim_hist_t event_hist[EVENT_BITS];
+static sim_hist_t sample_hist;
+static uint64_t sample_start_ns = NEVER;
+static uint64_t filter_samples;
+static double filter_sq_err;                // degrees C squared
+static double filter_max_err;
+static uint32_t rng;
+
+//***********************************************************************************
+// Helpers
+//***********************************************************************************
+
+static double uniform(void){
+  rng ^= rng << 13;                         // xorshift32
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return (rng + 1.0) / 4294967297.0;
+}
+
+static void hist_add(sim_hist_t *h, uint64_t ns){
+  uint64_t us = ns / NS_PER_US;
+  uint32_t b = 0;
+
+  while(us > 1 && b < HIST_BUCKETS - 1){
+      us >>= 1;
+      b++;
+  }
+  h->count++;
+  h->sum_ns += ns;
+  h->bucket[b]++;
+  if(ns > h->max_ns){
+      h->max_ns = ns;
+  }
+}
+
+// upper edge of the bucket holding the given fraction, in us
+static uint64_t hist_percentile(const sim_hist_t *h, double fraction){
+  uint64_t target = (uint64_t)ceil(h->count * fraction);
+  uint64_t seen = 0;
+
+  for(uint32_t b = 0; b < HIST_BUCKETS; b++){
+      seen += h->bucket[b];
+      if(seen >= target){
+          return 2ull << b;
+      }
+  }
+  return 2ull << (HIST_BUCKETS - 1);
+}
+
+static const char *event_name(uint32_t bit){
+  switch(1u << bit){
+    case APP_BTN0_CB:           return "btn0";
+    case APP_BTN1_CB:           return "btn1";
+    case LETIMER_COMP0_IRQ_CB:  return "letimer comp0";
+    case LETIMER_COMP1_IRQ_CB:  return "letimer comp1";
+    case LETIMER_UF_IRQ_CB:     return "letimer uf";
+    case SENSOR_SAMPLE_CB:      return "sample";
+    case ALARM_CB:              return "alarm";
+    case STATS_CB:              return "stats";
+    case FLASH_LOG_CB:          return "flash log";
+    case TELEMETRY_TX_CB:       return "telemetry tx";
+    case SHELL_RX_CB:           return "shell rx";
+    case SENSOR_STEP_CB:        return "sensor step";
+    case SENSOR_ERROR_CB:       return "sensor error";
+    default:                    return "?";
+  }
+}
+
+static void raise_irq(IRQn_Type irq){
+  irq_raised_ns = host_time_ns;
+  host_irq_invoke(irq);
+}
+
+//***********************************************************************************
+// Wrapped firmware calls, linked with --wrap
+//***********************************************************************************
+
+// time every event from the interrupt that posted it, or from now in thread mode
+void __wrap_add_scheduled_event(uint32_t event){
+  uint32_t fresh = event & ~get_scheduled_events();
+
+  while(fresh){
+      uint32_t bit = SL_CTZ(fresh);
+      post_ns[bit] = host_irq_masked() ? irq_raised_ns : host_time_ns;
+      fresh &= fresh - 1;
+  }
+  __real_add_scheduled_event(event);
+}
+
+// the main loop removes an event right before its callback
+void __wrap_remove_scheduled_event(uint32_t event){
+  uint32_t due = event & get_scheduled_events();
+
+  while(due){
+      uint32_t bit = SL_CTZ(due);
+      hist_add(&event_hist[bit], host_time_ns - post_ns[bit]);
+      due &= due - 1;
+  }
+  if((event & SENSOR_SAMPLE_CB) && sample_start_ns != NEVER){
+      hist_add(&sample_hist, host_time_ns - sample_start_ns);
+      sample_start_ns = NEVER;
+  }
+  __real_remove_scheduled_event(event);
+  host_time_ns += (uint64_t)(sim_power.dispatch_us * NS_PER_US);
+}
+
+// with EM0 or EM1 blocked enter_sleep() returns at once, idle in EM0 until
+// the next event instead of spinning the main loop, syncing registers first
+// as a real EM entry would
+void __wrap_enter_sleep(void){
+  if(current_block_energy_mode() <= EM1){
+      CORE_DECLARE_IRQ_STATE;
+      CORE_ENTER_CRITICAL();
+      host_sync();
+      host_sleep_hook(EM0);
+      CORE_EXIT_CRITICAL();
+      return;
+  }
+  __real_enter_sleep();
+}
+
+// every filtered sample goes through the alarms, score it against the
+// temperature the conversion measured before noise
+void __wrap_alarm_update(uint32_t raw){
+  double err = fabs(raw * 175.72 / 65536.0 - 46.85 - sensor.temperature);
+
+  filter_samples++;
+  filter_sq_err += err * err;
+  if(err > filter_max_err){
+      filter_max_err = err;
+  }
+  __real_alarm_update(raw);
+}
+
+//***********************************************************************************
+// Event sources
+//***********************************************************************************
+
+static void letimer_arm(uint64_t reload_ns){
+  uint64_t comp0 = LETIMER0->COMP0;
+  uint64_t comp1 = LETIMER0->COMP1;
+
+  letimer_reload_ns = reload_ns;
+  letimer_uf_ns = reload_ns + comp0 * NS_PER_S / LETIMER_HZ;
+  letimer_comp1_ns = comp1 < comp0 ? reload_ns + (comp0 - comp1) * NS_PER_S / LETIMER_HZ : NEVER;
+}
+
+// counts down from COMP0 to the underflow, COMP1 on the way
+static void letimer_fire(void){
+  uint32_t flags = 0;
+
+  if(host_time_ns == letimer_comp1_ns){
+      flags |= LETIMER_IF_COMP1;
+      letimer_comp1_ns = NEVER;
+  }
+  if(host_time_ns == letimer_uf_ns){
+      flags |= LETIMER_IF_UF | LETIMER_IF_COMP0;
+      sample_start_ns = host_time_ns;
+      sensor.temperature = TEMP_MEAN + TEMP_SWING * sin(2.0 * M_PI * host_time_ns / NS_PER_DAY);
+      letimer_arm(host_time_ns);
+  }
+  LETIMER0->IF |= flags;
+  if(LETIMER0->IF & LETIMER0->IEN){
+      raise_irq(LETIMER0_IRQn);
+  }
+}
+
+static void press_schedule(void){
+  if(opt.presses_per_hour > 0){
+      press_ns = host_time_ns + (uint64_t)(-log(uniform()) * NS_PER_HOUR / opt.presses_per_hour);
+  }
+}
+
+static void press_fire(void){
+  uint32_t pin = uniform() < 0.5 ? BUT0_PIN : BUT1_PIN;
+
+  presses++;
+  GPIO->IF |= 1u << pin;
+  raise_irq((pin & 1u) ? GPIO_ODD_IRQn : GPIO_EVEN_IRQn);
+  press_schedule();
+}
+
+static uint64_t byte_ns(uint32_t bytes){
+  return (uint64_t)bytes * UART_FRAME_BITS * NS_PER_S / LEUART0_BAUD;
+}
+
+static void ldma_fire(void){
+  uart_bytes += host_ldma_outstanding();
+  ldma_done_ns = NEVER;
+  irq_raised_ns = host_time_ns;
+  host_leuart0_tx_len = 0;
+  host_ldma_run();
+  if(capture){
+      fwrite(host_leuart0_tx, 1, host_leuart0_tx_len, capture);
+  }
+}
+
+// one byte per wakeup, the handler's read of RXDATA clears RXDATAV. LFB
+// stops in EM3 and EM4, a byte arriving then is lost.
+static void shell_fire(uint32_t em){
+  char byte = opt.shell[shell_pos++];
+
+  if(em >= EM3){
+      shell_lost++;
+  }
+  else{
+      LEUART0->RXDATA = (uint8_t)byte;
+      LEUART0->IF |= LEUART_IF_RXDATAV;
+      raise_irq(LEUART0_IRQn);
+  }
+  shell_ns = shell_pos < opt.shell_len ? host_time_ns + byte_ns(1) : NEVER;
+}
+
+static uint64_t min_ns(uint64_t a, uint64_t b){
+  return a < b ? a : b;
+}
+
+//***********************************************************************************
+// Sleep
+//***********************************************************************************
+
+static void sim_boot(void){
+  booted = true;
+  host_i2c_set_trapping(false);
+  host_i2c_clear_stats();
+  press_schedule();
+  if(opt.shell_len){
+      shell_ns = host_time_ns;
+  }
+}
+
+// advance from event to event until an enabled interrupt is pending
+static void sim_sleep(uint32_t em){
+  uint64_t start_ns;
+
+  if(!booted){
+      sim_boot();
+  }
+  LEUART0->IF &= ~LEUART_IF_RXDATAV;
+
+  if(!(LETIMER0->STATUS & LETIMER_STATUS_RUNNING)){
+      letimer_reload_ns = NEVER;
+      letimer_uf_ns = NEVER;
+      letimer_comp1_ns = NEVER;
+  }
+  else if(letimer_reload_ns == NEVER){
+      letimer_arm(host_time_ns);
+  }
+  if(ldma_done_ns == NEVER && host_ldma_outstanding()){
+      ldma_done_ns = host_time_ns + byte_ns(host_ldma_outstanding());
+  }
+
+  start_ns = host_time_ns;
+  while(!host_irq_wake_pending()){
+      uint64_t next = min_ns(min_ns(letimer_comp1_ns, letimer_uf_ns), min_ns(ldma_done_ns, min_ns(press_ns, shell_ns)));
+      uint64_t stop = min_ns(next, horizon_ns);
+
+      // the bus runs in SCL periods until the next other event
+      if(host_i2c_pending() && host_time_ns + host_i2c_tick_ns() <= stop){
+          host_i2c_set_fast_poll(true, stop);
+          host_i2c_tick();
+          continue;
+      }
+      if(next >= horizon_ns){
+          residency_ns[em] += horizon_ns - start_ns;
+          host_time_ns = horizon_ns;
+          longjmp(sim_end, 1);
+      }
+
+      host_time_ns = next;
+      if(next == letimer_comp1_ns || next == letimer_uf_ns){
+          letimer_fire();
+      }
+      if(next == ldma_done_ns){
+          ldma_fire();
+      }
+      if(next == press_ns){
+          press_fire();
+      }
+      if(next == shell_ns){
+          shell_fire(em);
+      }
+  }
+  residency_ns[em] += host_time_ns - start_ns;
+
+  wakeups++;
+  host_time_ns += (uint64_t)((sim_power.wake_us[em] + sim_power.active_us) * NS_PER_US);
+}
+
+//***********************************************************************************
+// Report
+//***********************************************************************************
+
+static void print_hist(const char *name, const sim_hist_t *h){
+  printf("  %-14s %9llu %10.1f %9llu %9llu %10.1f\n", name, (unsigned long long)h->count,
+         h->sum_ns / 1e3 / h->count, (unsigned long long)hist_percentile(h, 0.5),
+         (unsigned long long)hist_percentile(h, 0.99), h->max_ns / 1e3);
+}
+
+#ifdef PROF_ENABLE
+// host run time of the telemetry probes per frame sent, the LEUART0 irq
+// includes shell bytes received
+static void print_telemetry_profile(uint32_t frames){
+  static const PROF_ID ids[] = {
+    PROF_TELEMETRY_BUILD, PROF_TELEMETRY_SEND, PROF_LEUART0_IRQ, PROF_TELEMETRY_TX_DONE
+  };
+  uint64_t total = 0;
+
+  if(!frames){
+      return;
+  }
+  printf("\ntelemetry, host time per frame (ns)\n");
+  for(uint32_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++){
+      PROF_Stats_TypeDef p;
+
+      prof_get(ids[i], &p);
+      total += p.total;
+      printf("  %-18s %9.1f\n", prof_name(ids[i]), (double)p.total / frames);
+  }
+  printf("  %-18s %9.1f\n", "active", (double)total / frames);
+}
+
+// host run time of the probed handlers and callbacks, harness included
+static void print_profile(void){
+  printf("\nprofile, host time (ns)\n");
+  printf("  %-18s %9s %8s %8s %9s %9s %7s\n", "probe", "count", "min", "mean", "p99 <", "max", "hit %");
+  for(PROF_ID id = 0; id < PROF_NUM_IDS; id++){
+      PROF_Stats_TypeDef p;
+      uint64_t seen = 0;
+      uint32_t b = 0;
+
+      prof_get(id, &p);
+      if(!p.count){
+          continue;
+      }
+      while(b < PROF_HIST_BUCKETS - 1 && (seen += p.hist[b]) < p.count * 0.99){
+          b++;
+      }
+      printf("  %-18s %9u %8u %8u %9llu %9u", prof_name(id), p.count, p.min, p.mean,
+             2ull << b, p.max);
+      if(p.hits + p.misses){
+          printf(" %7.2f\n", 100.0 * p.hits / (p.hits + p.misses));
+      }else{
+          printf(" %7s\n", "-");
+      }
+  }
+}
+#endif
+
+static void report(double wall_s){
+  host_i2c_stats_t i2c;
+  REPORT_Stats_TypeDef filter;
+  TELEMETRY_Stats_TypeDef telemetry;
+  double total_ns = (double)host_time_ns;
+  double hours = total_ns / NS_PER_HOUR;
+  double poll_ns, charge_uas = 0, sensor_uas, avg_ua;
+  uint64_t sleep_ns = 0;
+
+  host_i2c_get_stats(&i2c);
+
+  // skipped busy polls were EM1 wakeups that didn't run
+  poll_ns = i2c.skipped_polls * (sim_power.wake_us[EM1] + sim_power.active_us) * NS_PER_US;
+  residency_ns[EM1] -= (uint64_t)poll_ns;
+  for(uint32_t em = EM1; em < MAX_ENERGY_MODES; em++){
+      sleep_ns += residency_ns[em];
+  }
+  residency_ns[EM0] = host_time_ns - sleep_ns;
+  wakeups += i2c.skipped_polls;
+
+  printf("simulated %.1f days in %.1f s\n\n", total_ns / NS_PER_DAY, wall_s);
+
+  printf("mode residency\n");
+  for(uint32_t em = EM0; em < MAX_ENERGY_MODES; em++){
+      double share = residency_ns[em] / total_ns;
+      charge_uas += residency_ns[em] / 1e9 * sim_power.em_ua[em];
+      printf("  EM%u %9.4f %%  %12.1f s\n", em, share * 100.0, residency_ns[em] / 1e9);
+  }
+
+  sensor_uas = sensor.converting_ns / 1e9 * sim_power.sensor_ua;
+  avg_ua = (charge_uas + sensor_uas) / (total_ns / 1e9);
+
+  printf("\nwakeups per hour  %.0f (%.0f of them I2C busy polls)\n", wakeups / hours, i2c.skipped_polls / hours);
+  printf("button presses    %llu\n", (unsigned long long)presses);
+  printf("uart bytes        %llu\n", (unsigned long long)uart_bytes);
+  telemetry_get_stats(&telemetry);
+  printf("telemetry frames  %u, %.4f per s, %u dropped\n", telemetry.frames,
+         telemetry.frames / (total_ns / 1e9), telemetry.dropped);
+  printf("  core active     %.1f us per frame, transmit wakeup and tx done dispatch\n",
+         sim_power.wake_us[EM2] + sim_power.active_us + sim_power.dispatch_us);
+  if(opt.shell_len){
+      printf("shell bytes lost  %u of %u\n", shell_lost, opt.shell_len);
+  }
+  printf("conversions       %u\n", sensor.conversions);
+  printf("critical sections %.0f per hour\n", host_masked_sections / hours);
+  report_get_stats(&filter);
+  printf("samples reported  %u of %u (%.1f %% suppressed, %u heartbeats)\n",
+         filter.forwarded, filter.samples,
+         filter.samples ? 100.0 * (filter.samples - filter.forwarded) / filter.samples : 0.0,
+         filter.heartbeats);
+  if(filter_samples){
+      printf("filter error      %.4f C rms, %.4f C max over %llu samples\n",
+             sqrt(filter_sq_err / filter_samples), filter_max_err, (unsigned long long)filter_samples);
+  }
+  printf("\naverage current   %.2f uA (MCU %.2f uA, Si7021 %.2f uA)\n", avg_ua,
+         charge_uas / (total_ns / 1e9), sensor_uas / (total_ns / 1e9));
+  printf("battery life      %.0f days on %.0f mAh\n", opt.battery_mah * 1000.0 / avg_ua / 24.0, opt.battery_mah);
+
+  printf("\nevent latency, interrupt to dispatch (us)\n");
+  printf("  %-14s %9s %10s %9s %9s %10s\n", "event", "count", "mean", "p50 <", "p99 <", "max");
+  for(uint32_t bit = 0; bit < EVENT_BITS; bit++){
+      if(event_hist[bit].count){
+          print_hist(event_name(bit), &event_hist[bit]);
+      }
+  }
+  if(sample_hist.count){
+      printf("\nsample latency, LETIMER underflow to read callback (us)\n");
+      print_hist("sample", &sample_hist);
+  }
+#ifdef PROF_ENABLE
+  print_telemetry_profile(telemetry.frames);
+  print_profile();
+#endif
+}
+
+//***********************************************************************************
+// Main
+//***********************************************************************************
+
+static void parse(int argc, char **argv){
+  for(int i = 1; i < argc; i++){
+      const char *arg = argv[i];
+      const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+
+      if(!val){
+          fprintf(stderr, "%s needs a value\n", arg);
+          exit(1);
+      }
+      if(!strcmp(arg, "--days")){
+          opt.days = atof(val);
+      }
+      else if(!strcmp(arg, "--presses-per-hour")){
+          opt.presses_per_hour = atof(val);
+      }
+      else if(!strcmp(arg, "--battery-mah")){
+          opt.battery_mah = atof(val);
+      }
+      else if(!strcmp(arg, "--seed")){
+          opt.seed = (uint32_t)strtoul(val, NULL, 0);
+      }
+      else if(!strcmp(arg, "--noise")){
+          opt.noise = atof(val);
+      }
+      else if(!strcmp(arg, "--spikes")){
+          opt.spikes = atof(val);
+      }
+      else if(!strcmp(arg, "--shell")){
+          int n = snprintf(opt.shell + opt.shell_len, SHELL_MAX_BYTES - opt.shell_len, "%s\n", val);
+          if(n < 0 || opt.shell_len + (uint32_t)n >= SHELL_MAX_BYTES){
+              fprintf(stderr, "too many shell commands\n");
+              exit(1);
+          }
+          opt.shell_len += (uint32_t)n;
+      }
+      else if(!strcmp(arg, "--capture")){
+          opt.capture = val;
+      }
+      else{
+          fprintf(stderr, "unknown option %s\n", arg);
+          exit(1);
+      }
+      i++;
+  }
+}
+
+int main(int argc, char **argv){
+  struct timespec t0, t1;
+
+  parse(argc, argv);
+  rng = opt.seed ? opt.seed : 1;
+  horizon_ns = (uint64_t)(opt.days * NS_PER_DAY);
+  if(opt.capture && !(capture = fopen(opt.capture, "wb"))){
+      perror(opt.capture);
+      return 1;
+  }
+
+  host_reset();
+  host_i2c_attach();
+  si7021_model_init(&sensor, TEMP_MEAN);
+  sensor.noise = opt.noise;
+  sensor.spike_rate = opt.spikes;
+  sensor.spike = SPIKE_C;
+  sensor.seed = rng;
+  host_i2c_add_device(&sensor.dev);
+  host_sleep_hook = sim_sleep;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  if(!setjmp(sim_end)){
+      firmware_main();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  host_sleep_hook = NULL;
+  host_i2c_detach();
+  if(capture){
+      fclose(capture);
+  }
+  report((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+  return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file sim_i2c.c
+ *
+ * @brief
+ *  Runs the firmware I2C driver against the Si7021 model and reports
+ *  transaction latency, interrupt counts and recovery from bus faults
+ *
+ * @details
+ *  Times are simulated bus time at the SCL rate si7021_open() sets up.
+ *  Interrupt handlers run in zero simulated time, so latencies are what the
+ *  bus and the sensor impose.
+ *
+ */
+
+#include <stdio.h>
+#include "host.h"
+#include "host_i2c.h"
+#include "si7021_model.h"
+#include "brd_config.h"
+#include "scheduler.h"
+#include "sleep_routines.h"
+#include "si7021.h"
+
+#define TIMEOUT_NS          50000000ull     // well past the slowest conversion
+#define STUCK_NS            1000000ull
+#define MID_CONVERSION_NACKS    5u
+
+typedef struct {
+  bool done;
+  uint64_t ns;
+  uint32_t irqs;
+  host_i2c_stats_t bus;
+} sim_result_t;
+
+static si7021_model_t sensor;
+
+static void setup(double temperature){
+  host_i2c_detach();
+  host_reset();
+  scheduler_open();
+  sleep_open();
+  host_i2c_attach();
+  si7021_model_init(&sensor, temperature);
+  host_i2c_add_device(&sensor.dev);
+  NVIC_EnableIRQ(I2C0_IRQn);
+  si7021_open();
+}
+
+static bool read_done(void){
+  return get_scheduled_events() & SENSOR_SAMPLE_CB;
+}
+
+static bool write_done(void){
+  return (get_scheduled_events() & (SENSOR_STEP_CB | SENSOR_ERROR_CB)) &&
+         current_block_energy_mode() != I2C_EM_BLOCK && host_i2c_idle();
+}
+
+static void begin_measure(sim_result_t *r){
+  host_i2c_clear_stats();
+  r->ns = host_time_ns;
+  r->irqs = host_irq_count[I2C0_IRQn];
+}
+
+static void end_measure(sim_result_t *r, bool done){
+  r->done = done;
+  r->ns = host_time_ns - r->ns;
+  r->irqs = host_irq_count[I2C0_IRQn] - r->irqs;
+  host_i2c_get_stats(&r->bus);
+}
+
+static bool run_until(bool (*done)(void), uint64_t timeout_ns){
+  uint64_t t0 = host_time_ns;
+
+  while(!done()){
+      if(host_time_ns - t0 > timeout_ns){
+          return false;
+      }
+      host_i2c_tick();
+  }
+  return true;
+}
+
+static bool sim_read(sim_result_t *r){
+  remove_scheduled_event(SENSOR_SAMPLE_CB);
+  begin_measure(r);
+  si7021_read(SENSOR_SAMPLE_CB);
+  end_measure(r, run_until(read_done, TIMEOUT_NS));
+  return r->done && si7021_get_raw_data() == (uint32_t)(si7021_model_code(sensor.temperature, sensor.user_reg));
+}
+
+static bool sim_set_resolution(sim_result_t *r, tSI7021_RESOLUTION res){
+  remove_scheduled_event(SENSOR_STEP_CB | SENSOR_ERROR_CB);
+  begin_measure(r);
+  si7021_set_resolution(res);
+  si7021_configure(SENSOR_STEP_CB, SENSOR_ERROR_CB);
+  end_measure(r, run_until(write_done, TIMEOUT_NS));
+  return r->done && (get_scheduled_events() & SENSOR_STEP_CB) && (sensor.user_reg & Si7021_USER_REG_RES) == res;
+}
+
+//***********************************************************************************
+// Scenarios
+//***********************************************************************************
+
+static uint64_t baseline_ns;
+
+static void resolutions(void){
+  static const struct { tSI7021_RESOLUTION res; const char *name; } table[] = {
+    { SI7021_RES_RH12_T14, "14 bit" },
+    { SI7021_RES_RH10_T13, "13 bit" },
+    { SI7021_RES_RH8_T12,  "12 bit" },
+    { SI7021_RES_RH11_T11, "11 bit" },
+  };
+  static const double temps[] = { 21.5, -10.25, 85.0 };
+
+  setup(temps[0]);
+  printf("temperature read per resolution (SCL period %u ns)\n", host_i2c_tick_ns());
+  printf("  %-8s %10s %12s %6s %11s %9s %6s\n", "res", "conv us", "latency us", "irqs", "busy NACKs", "accesses", "ok");
+
+  for(size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++){
+      sim_result_t w, r = { 0 };
+      bool ok;
+
+      setup(temps[0]);
+      ok = sim_set_resolution(&w, table[i].res);
+      for(size_t t = 0; t < sizeof(temps) / sizeof(temps[0]); t++){
+          sensor.temperature = temps[t];
+          sensor.busy_nacks = 0;
+          ok &= sim_read(&r);
+      }
+      if(i == 0){
+          baseline_ns = r.ns;
+      }
+      printf("  %-8s %10.1f %12.1f %6u %11u %9u %6s\n", table[i].name,
+             si7021_model_conversion_ns(sensor.user_reg) / 1e3, r.ns / 1e3, r.irqs,
+             sensor.busy_nacks, r.bus.accesses, ok ? "yes" : "NO");
+  }
+  printf("\n");
+}
+
+static void print_fault(const char *name, const sim_result_t *r, bool ok, int64_t recovery_ns){
+  printf("  %-30s %-7s %12.1f %6u %9.1f\n", name, r->done ? (ok ? "ok" : "bad") : "hung",
+         r->ns / 1e3, r->irqs, recovery_ns / 1e3);
+}
+
+// the driver has no path out of a stuck bus, time a re-open and a read
+static int64_t reopen_and_read(void){
+  sim_result_t r;
+  uint64_t t0 = host_time_ns;
+
+  si7021_open();
+  if(!sim_read(&r)){
+      return -1;
+  }
+  return (int64_t)(host_time_ns - t0);
+}
+
+static void faults(void){
+  sim_result_t r, w = { 0 };
+  bool ok;
+
+  printf("faults (14 bit, recovery = extra time over a clean read, or re-open + read)\n");
+  printf("  %-30s %-7s %12s %6s %9s\n", "fault", "result", "latency us", "irqs", "recov us");
+
+  setup(21.5);
+  host_i2c_fault_nack(0, 1);
+  ok = sim_read(&r);
+  print_fault("1 NACK on address", &r, ok, (int64_t)(r.ns - baseline_ns));
+
+  setup(21.5);
+  host_i2c_fault_nack(0, 3);
+  ok = sim_read(&r);
+  print_fault("3 NACKs on address", &r, ok, (int64_t)(r.ns - baseline_ns));
+
+  setup(21.5);
+  host_i2c_fault_nack(1, 1);
+  ok = sim_read(&r);
+  print_fault("NACK on command byte", &r, ok, (int64_t)(r.ns - baseline_ns));
+
+  // the write is aborted with the error event, the register keeps its value
+  // and the next read works without a re-open
+  setup(21.5);
+  host_i2c_fault_nack(2, 1);
+  sim_set_resolution(&r, SI7021_RES_RH11_T11);
+  ok = r.done && (get_scheduled_events() & SENSOR_ERROR_CB) &&
+       (sensor.user_reg & Si7021_USER_REG_RES) == SI7021_RES_RH12_T14;
+  ok = ok && sim_read(&w);
+  print_fault("NACK on user register data", &r, ok, r.done ? (int64_t)(w.ns - baseline_ns) : reopen_and_read());
+
+  setup(21.5);
+  host_i2c_fault_stuck_sda(STUCK_NS);
+  ok = sim_read(&r);
+  print_fault("SDA stuck 1 ms, bus idle", &r, ok, (int64_t)(r.ns - baseline_ns));
+
+  setup(21.5);
+  remove_scheduled_event(SENSOR_SAMPLE_CB);
+  begin_measure(&r);
+  si7021_read(SENSOR_SAMPLE_CB);
+  while(sensor.busy_nacks < MID_CONVERSION_NACKS){
+      host_i2c_tick();
+  }
+  host_i2c_fault_stuck_sda(STUCK_NS);
+  end_measure(&r, run_until(read_done, TIMEOUT_NS));
+  print_fault("SDA stuck 1 ms, mid poll", &r, r.done, r.done ? 0 : reopen_and_read());
+  if(!r.done){
+      printf("  %-30s arbitration lost %u, EM2 still blocked after re-open: %s\n", "",
+             r.bus.arb_lost, current_block_energy_mode() == I2C_EM_BLOCK ? "yes" : "no");
+  }
+}
+
+int main(void){
+  resolutions();
+  faults();
+  host_i2c_detach();
+  return 0;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file em_cmu.c
+ *
+ * @brief
+ *  Host model of the CMU. Only clock frequencies are modelled.
+ *
+ */
+
+#include "em_cmu.h"
+
+static uint32_t hfrco_freq = cmuHFRCOFreq_19M0Hz;
+static bool clock_on[cmuClock_COUNT];
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable){
+  clock_on[clock] = enable;
+}
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock){
+  switch(clock){
+    case cmuClock_LFA:
+    case cmuClock_LETIMER0:
+      return 1000u;                       // ULFRCO
+    case cmuClock_LFB:
+    case cmuClock_LEUART0:
+      return 32768u;                      // LFXO
+    default:
+      return hfrco_freq;
+  }
+}
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref){
+  (void)clock;
+  (void)ref;
+}
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait){
+  (void)osc;
+  (void)enable;
+  (void)wait;
+}
+
+void CMU_HFRCOBandSet(CMU_HFRCOFreq_TypeDef setFreq){
+  hfrco_freq = setFreq;
+}
+
+void CMU_HFXOInit(const CMU_HFXOInit_TypeDef *hfxoInit){
+  (void)hfxoInit;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file em_emu.c
+ *
+ * @brief
+ *  Host model of the EMU. Entering a sleep mode counts the entry and hands
+ *  control to host_sleep_hook so the harness can raise the wakeup interrupt.
+ *
+ */
+
+#include "em_emu.h"
+#include "host.h"
+
+static void host_enter_em(uint32_t em){
+  host_em_entries[em]++;
+  host_sync();
+  if(host_sleep_hook){
+      host_sleep_hook(em);
+  }
+}
+
+void EMU_EnterEM1(void){
+  host_enter_em(1);
+}
+
+void EMU_EnterEM2(bool restore){
+  (void)restore;
+  host_enter_em(2);
+}
+
+void EMU_EnterEM3(bool restore){
+  (void)restore;
+  host_enter_em(3);
+}
+
+void EMU_EM23Init(const EMU_EM23Init_TypeDef *em23Init){
+  (void)em23Init;
+}
+
+bool EMU_DCDCInit(const EMU_DCDCInit_TypeDef *dcdcInit){
+  (void)dcdcInit;
+  return true;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file em_gpio.c
+ *
+ * @brief
+ *  Host model of the GPIO configuration functions
+ *
+ */
+
+#include "em_gpio.h"
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength){
+  GPIO->P[port].CTRL = strength;
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out){
+  volatile uint32_t *model = (pin < 8) ? &GPIO->P[port].MODEL : &GPIO->P[port].MODEH;
+  unsigned int shift = (pin % 8) * 4;
+
+  *model = (*model & ~(0xFu << shift)) | ((uint32_t)mode << shift);
+  if(out){
+      GPIO->P[port].DOUT |= 1u << pin;
+  }
+  else{
+      GPIO->P[port].DOUT &= ~(1u << pin);
+  }
+}
+
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin, unsigned int intNo,
+                       bool risingEdge, bool fallingEdge, bool enable){
+  volatile uint32_t *sel = (intNo < 8) ? &GPIO->EXTIPSELL : &GPIO->EXTIPSELH;
+  volatile uint32_t *pinsel = (intNo < 8) ? &GPIO->EXTIPINSELL : &GPIO->EXTIPINSELH;
+  unsigned int shift = (intNo % 8) * 4;
+  uint32_t bit = 1u << intNo;
+
+  *sel = (*sel & ~(0xFu << shift)) | ((uint32_t)port << shift);
+  *pinsel = (*pinsel & ~(0x3u << shift)) | ((uint32_t)(pin % 4) << shift);
+  GPIO->EXTIRISE = risingEdge ? (GPIO->EXTIRISE | bit) : (GPIO->EXTIRISE & ~bit);
+  GPIO->EXTIFALL = fallingEdge ? (GPIO->EXTIFALL | bit) : (GPIO->EXTIFALL & ~bit);
+  GPIO->IF &= ~bit;
+  GPIO->IEN = enable ? (GPIO->IEN | bit) : (GPIO->IEN & ~bit);
+}
@@ -0,0 +1,16 @@
+/**
+ * @file em_i2c.c
+ *
+ * @brief
+ *  Host model of I2C_Init. Bus behaviour belongs to the I2C bus model.
+ *
+ */
+
+#include "em_i2c.h"
+
+#define HOST_I2C_CTRL_EN    (0x1UL << 0)
+
+void I2C_Init(I2C_TypeDef *i2c, const I2C_Init_TypeDef *init){
+  i2c->CLKDIV = init->freq ? (init->refFreq ? init->refFreq : 19000000u) / (8u * init->freq) : 0;
+  i2c->CTRL = (i2c->CTRL & ~HOST_I2C_CTRL_EN) | (init->enable ? HOST_I2C_CTRL_EN : 0);
+}
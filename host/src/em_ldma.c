@@ -0,0 +1,78 @@
+/**
+ * @file em_ldma.c
+ *
+ * @brief
+ *  Host model of the LDMA. A started transfer stays outstanding until the
+ *  harness calls host_ldma_run(), which moves the bytes and, for LEUART0,
+ *  captures them and raises TXC as the last stop bit would.
+ *
+ */
+
+#include <string.h>
+#include "em_ldma.h"
+#include "host.h"
+
+#define HOST_LDMA_CHANNELS  8
+
+typedef struct {
+  bool busy;
+  LDMA_Descriptor_t desc;
+} host_ldma_channel_t;
+
+static host_ldma_channel_t channel[HOST_LDMA_CHANNELS];
+
+uint8_t host_leuart0_tx[HOST_LEUART_TX_CAPTURE];
+uint32_t host_leuart0_tx_len;
+
+void LDMA_Init(const LDMA_Init_t *init){
+  (void)init;
+  memset(channel, 0, sizeof(channel));
+  NVIC_EnableIRQ(LDMA_IRQn);
+}
+
+void LDMA_StartTransfer(int ch, const LDMA_TransferCfg_t *transfer, const LDMA_Descriptor_t *descriptor){
+  (void)transfer;
+  channel[ch].busy = true;
+  channel[ch].desc = *descriptor;
+}
+
+bool LDMA_TransferDone(int ch){
+  return !channel[ch].busy;
+}
+
+void LDMA_StopTransfer(int ch){
+  channel[ch].busy = false;
+}
+
+// bytes still to be moved by started transfers
+uint32_t host_ldma_outstanding(void){
+  uint32_t bytes = 0;
+
+  for(int ch = 0; ch < HOST_LDMA_CHANNELS; ch++){
+      if(channel[ch].busy){
+          bytes += channel[ch].desc.xferCnt;
+      }
+  }
+  return bytes;
+}
+
+void host_ldma_run(void){
+  for(int ch = 0; ch < HOST_LDMA_CHANNELS; ch++){
+      if(!channel[ch].busy){
+          continue;
+      }
+      const uint8_t *src = channel[ch].desc.srcAddr;
+      volatile uint32_t *dst = channel[ch].desc.dstAddr;
+      for(uint32_t i = 0; i < channel[ch].desc.xferCnt; i++){
+          *dst = src[i];
+          if(dst == &LEUART0->TXDATA && host_leuart0_tx_len < HOST_LEUART_TX_CAPTURE){
+              host_leuart0_tx[host_leuart0_tx_len++] = src[i];
+          }
+      }
+      channel[ch].busy = false;
+      if(dst == &LEUART0->TXDATA){
+          LEUART0->IF |= LEUART_IF_TXC;
+          host_irq_invoke(LEUART0_IRQn);
+      }
+  }
+}
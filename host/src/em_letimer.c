@@ -0,0 +1,27 @@
+/**
+ * @file em_letimer.c
+ *
+ * @brief
+ *  Host model of the LETIMER functions. The counter does not run on its
+ *  own; the harness raises the COMP0/COMP1/UF flags and interrupts.
+ *
+ */
+
+#include "em_letimer.h"
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init){
+  letimer->CTRL = (init->debugRun ? 1u << 12 : 0) | (init->comp0Top ? 1u << 9 : 0) |
+                  (init->bufTop ? 1u << 8 : 0) | ((uint32_t)init->out0Pol << 6) |
+                  ((uint32_t)init->out1Pol << 7) | ((uint32_t)init->ufoa0 << 2) |
+                  ((uint32_t)init->ufoa1 << 4) | (uint32_t)init->repMode;
+  LETIMER_Enable(letimer, init->enable);
+}
+
+void LETIMER_Enable(LETIMER_TypeDef *letimer, bool enable){
+  if(enable){
+      letimer->STATUS |= LETIMER_STATUS_RUNNING;
+  }
+  else{
+      letimer->STATUS &= ~LETIMER_STATUS_RUNNING;
+  }
+}
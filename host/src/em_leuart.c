@@ -0,0 +1,33 @@
+/**
+ * @file em_leuart.c
+ *
+ * @brief
+ *  Host model of the LEUART functions, plus receive injection
+ *
+ */
+
+#include "em_leuart.h"
+#include "host.h"
+
+void LEUART_Init(LEUART_TypeDef *leuart, LEUART_Init_TypeDef const *init){
+  leuart->CLKDIV = init->baudrate ? (256u * 32768u) / init->baudrate - 256u : 0;
+  leuart->CTRL = ((uint32_t)init->parity << 2) | ((uint32_t)init->stopbits << 4);
+  LEUART_Enable(leuart, init->enable);
+}
+
+void LEUART_Enable(LEUART_TypeDef *leuart, LEUART_Enable_TypeDef enable){
+  leuart->STATUS = (leuart->STATUS & ~(LEUART_STATUS_RXENS | LEUART_STATUS_TXENS)) |
+                   ((enable & LEUART_CMD_RXEN) ? LEUART_STATUS_RXENS : 0) |
+                   ((enable & LEUART_CMD_TXEN) ? LEUART_STATUS_TXENS : 0);
+}
+
+// One received byte: RXDATAV is raised, the interrupt runs and the read of
+// RXDATA in the handler is assumed to clear it again
+void host_leuart0_rx(uint8_t byte){
+  LEUART0->RXDATA = byte;
+  LEUART0->STATUS |= LEUART_STATUS_RXDATAV;
+  LEUART0->IF |= LEUART_IF_RXDATAV;
+  host_irq_invoke(LEUART0_IRQn);
+  LEUART0->STATUS &= ~LEUART_STATUS_RXDATAV;
+  LEUART0->IF &= ~LEUART_IF_RXDATAV;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file em_msc.c
+ *
+ * @brief
+ *  Host model of the MSC. Flash is memory with NOR semantics: erase sets a
+ *  page to 0xFF and programming can only clear bits.
+ *
+ */
+
+#include <string.h>
+#include "em_msc.h"
+
+uint8_t host_flash[FLASH_SIZE];
+
+uint32_t host_msc_erases;
+uint32_t host_msc_words;
+
+void MSC_Init(void){}
+void MSC_Deinit(void){}
+
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress){
+  uintptr_t off = (uintptr_t)startAddress - FLASH_BASE;
+  if(off >= FLASH_SIZE || off % FLASH_PAGE_SIZE){
+      return mscReturnInvalidAddr;
+  }
+  memset(&host_flash[off], 0xFF, FLASH_PAGE_SIZE);
+  host_msc_erases++;
+  return mscReturnOk;
+}
+
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes){
+  uintptr_t off = (uintptr_t)address - FLASH_BASE;
+  const uint8_t *src = data;
+  if(off + numBytes > FLASH_SIZE){
+      return mscReturnInvalidAddr;
+  }
+  if(off % 4 || numBytes % 4){
+      return mscReturnUnaligned;
+  }
+  for(uint32_t i = 0; i < numBytes; i++){
+      host_flash[off + i] &= src[i];
+  }
+  host_msc_words += numBytes / 4;
+  return mscReturnOk;
+}
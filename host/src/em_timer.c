@@ -0,0 +1,24 @@
+/**
+ * @file em_timer.c
+ *
+ * @brief
+ *  Host model of the TIMER functions. A one shot down count runs to zero
+ *  as soon as it is enabled, so busy waits on CNT end immediately.
+ *
+ */
+
+#include "em_timer.h"
+
+static bool one_shot_down;
+
+void TIMER_Init(TIMER_TypeDef *timer, const TIMER_Init_TypeDef *init){
+  one_shot_down = init->oneShot && init->mode == timerModeDown;
+  timer->CTRL = (uint32_t)init->mode | ((uint32_t)init->prescale << 24);
+  TIMER_Enable(timer, init->enable);
+}
+
+void TIMER_Enable(TIMER_TypeDef *timer, bool enable){
+  if(enable && one_shot_down){
+      timer->CNT = 0;
+  }
+}
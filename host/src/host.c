@@ -0,0 +1,190 @@
+/**
+ * @file host.c
+ *
+ * @brief
+ *  Peripheral instances, NVIC and interrupt delivery for the host build
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+#include "em_core.h"
+
+GPIO_TypeDef    host_gpio;
+LETIMER_TypeDef host_letimer0;
+host_page_i2c_t host_i2c0 __attribute__((aligned(HOST_PAGE_SIZE)));
+I2C_TypeDef     host_i2c1;
+TIMER_TypeDef   host_timer0;
+LEUART_TypeDef  host_leuart0;
+
+uint32_t host_em_entries[5];
+uint64_t host_masked_sections;
+uint64_t host_masked_ns;
+uint64_t host_masked_max_ns;
+volatile uint32_t *host_exclusive;
+void (*host_sleep_hook)(uint32_t em);
+uint64_t host_time_ns;
+void (*host_sync_hook)(void);
+uint32_t host_irq_count[HOST_IRQn_COUNT];
+uint32_t host_stack[HOST_STACK_SIZE / 4u];
+
+// Handlers are weak so a program can link only some of the firmware modules
+void GPIO_EVEN_IRQHandler(void) __attribute__((weak));
+void GPIO_ODD_IRQHandler(void) __attribute__((weak));
+void LETIMER0_IRQHandler(void) __attribute__((weak));
+void I2C0_IRQHandler(void) __attribute__((weak));
+void I2C1_IRQHandler(void) __attribute__((weak));
+void LEUART0_IRQHandler(void) __attribute__((weak));
+void LDMA_IRQHandler(void) __attribute__((weak));
+
+// Interrupt flag registers of each peripheral, IF/IFS/IFC are consecutive
+typedef struct {
+  IRQn_Type irq;
+  void (*handler)(void);
+  volatile uint32_t *if_reg;
+} host_vector_t;
+
+#define HOST_VECTOR(irq, handler, periph)   { irq, handler, &(periph)->IF }
+
+static const host_vector_t vectors[] = {
+  HOST_VECTOR(GPIO_EVEN_IRQn, GPIO_EVEN_IRQHandler, GPIO),
+  HOST_VECTOR(GPIO_ODD_IRQn,  GPIO_ODD_IRQHandler,  GPIO),
+  HOST_VECTOR(LETIMER0_IRQn,  LETIMER0_IRQHandler,  LETIMER0),
+  HOST_VECTOR(I2C0_IRQn,      I2C0_IRQHandler,      I2C0),
+  HOST_VECTOR(I2C1_IRQn,      I2C1_IRQHandler,      I2C1),
+  HOST_VECTOR(LEUART0_IRQn,   LEUART0_IRQHandler,   LEUART0),
+  { LDMA_IRQn, LDMA_IRQHandler, NULL },
+};
+
+static bool irq_enabled[HOST_IRQn_COUNT];
+static bool irq_pending[HOST_IRQn_COUNT];
+static bool if_modelled[HOST_IRQn_COUNT];
+static uint32_t irq_mask_depth;         // > 0 inside a critical section or a handler
+static uint32_t critical_depth;         // CORE critical sections open
+static uint64_t critical_start_ns;
+
+void assertEFM(const char *file, int line){
+  fprintf(stderr, "EFM_ASSERT failed: %s:%d\n", file, line);
+  abort();
+}
+
+void host_reset(void){
+  memset(&host_gpio, 0, sizeof(host_gpio));
+  memset(&host_letimer0, 0, sizeof(host_letimer0));
+  memset(&host_i2c0, 0, sizeof(host_i2c0));
+  memset(&host_i2c1, 0, sizeof(host_i2c1));
+  memset(&host_timer0, 0, sizeof(host_timer0));
+  memset(&host_leuart0, 0, sizeof(host_leuart0));
+  memset(irq_enabled, 0, sizeof(irq_enabled));
+  memset(irq_pending, 0, sizeof(irq_pending));
+  memset(if_modelled, 0, sizeof(if_modelled));
+  memset(host_irq_count, 0, sizeof(host_irq_count));
+  memset(host_em_entries, 0, sizeof(host_em_entries));
+  host_leuart0_tx_len = 0;
+  host_time_ns = 0;
+  irq_mask_depth = 0;
+  host_exclusive = NULL;
+  critical_depth = 0;
+  host_masked_sections = 0;
+  host_masked_ns = 0;
+  host_masked_max_ns = 0;
+}
+
+void host_sync(void){
+  for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++){
+      volatile uint32_t *r = vectors[i].if_reg;
+      if(r && !if_modelled[vectors[i].irq]){
+          r[0] = (r[0] | r[1]) & ~r[2];     // IF |= IFS, IF &= ~IFC
+          r[1] = 0;
+          r[2] = 0;
+      }
+  }
+  if(host_sync_hook){
+      host_sync_hook();
+  }
+}
+
+static void host_irq_deliver(void){
+  for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]) && irq_mask_depth == 0; i++){
+      IRQn_Type irq = vectors[i].irq;
+      if(irq_pending[irq] && irq_enabled[irq]){
+          irq_pending[irq] = false;
+          host_sync();
+          if(vectors[i].handler){
+              irq_mask_depth++;
+              host_irq_count[irq]++;
+              host_exclusive = NULL;
+              vectors[i].handler();
+              irq_mask_depth--;
+          }
+          host_sync();
+          i = (size_t)-1;                   // rescan, the handler may have pended more
+      }
+  }
+}
+
+void host_irq_invoke(IRQn_Type irq){
+  irq_pending[irq] = true;
+  host_irq_deliver();
+}
+
+bool host_irq_enabled(IRQn_Type irq){
+  return irq_enabled[irq];
+}
+
+bool host_irq_masked(void){
+  return irq_mask_depth != 0;
+}
+
+// an enabled interrupt is pending, the core would leave WFI
+bool host_irq_wake_pending(void){
+  for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++){
+      if(irq_pending[vectors[i].irq] && irq_enabled[vectors[i].irq]){
+          return true;
+      }
+  }
+  return false;
+}
+
+void host_if_model(IRQn_Type irq, bool owned){
+  if_modelled[irq] = owned;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq){
+  irq_enabled[irq] = true;
+  host_irq_deliver();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq){
+  irq_enabled[irq] = false;
+}
+
+static uint64_t host_now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+CORE_irqState_t CORE_EnterCritical(void){
+  if(critical_depth++ == 0){
+      host_masked_sections++;
+      critical_start_ns = host_now_ns();
+  }
+  return irq_mask_depth++;
+}
+
+void CORE_ExitCritical(CORE_irqState_t irqState){
+  if(--critical_depth == 0){
+      uint64_t ns = host_now_ns() - critical_start_ns;
+      host_masked_ns += ns;
+      if(ns > host_masked_max_ns){
+          host_masked_max_ns = ns;
+      }
+  }
+  irq_mask_depth = irqState;
+  host_sync();
+  host_irq_deliver();
+}
@@ -0,0 +1,691 @@
+/**
+ * @file host_i2c.c
+ *
+ * @brief
+ *  I2C0 master and bus model, with register access trapping
+ *
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "host.h"
+#include "host_i2c.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "the I2C bus model traps register accesses and needs Linux on x86-64"
+#endif
+
+#define HFPER_HZ            19000000u       // same reference the host I2C_Init assumes
+#define DEFAULT_TICK_NS     10000u          // 100 kHz while CLKDIV is still 0
+#define EFLAGS_TF           0x100u
+#define WRITE_SENTINEL      0xDEADBEEFu     // write-only registers read this while stepping
+#define BYTE_BITS           9u              // data bits and the ACK bit
+#define NUM_REGS            (sizeof(I2C_TypeDef) / sizeof(uint32_t))
+
+#define REG(name)           (offsetof(I2C_TypeDef, name) / sizeof(uint32_t))
+
+// EFM32 I2C STATE field values
+#define STATE_WAIT          1u
+#define STATE_START         2u
+#define STATE_ADDR          3u
+#define STATE_DATA          5u
+#define STATE_DATAACK       6u
+
+typedef enum {
+  PHASE_IDLE,       // bus free
+  PHASE_START,      // START or repeated START
+  PHASE_TX,         // byte and ACK bit from the device
+  PHASE_RX,         // byte from the device
+  PHASE_ACK,        // ACK or NACK bit after a received byte
+  PHASE_STOP,
+  PHASE_HOLD        // SCL held low until software acts
+} phase_t;
+
+static struct {
+  bool attached;
+  bool trapping;
+  phase_t phase;
+  uint32_t bits_left;
+  bool need_addr;               // the next byte out is an address
+  bool rx_wait;                 // holding after a received byte for ACK or NACK
+  bool reading;
+  bool ack_bit;
+  host_i2c_device_t *dev;       // addressed device
+  host_i2c_device_t *devices[HOST_I2C_MAX_DEVICES];
+  uint32_t num_devices;
+
+  // pending software requests
+  bool cmd_start;
+  bool cmd_stop;
+  bool cmd_ack;
+  bool cmd_nack;
+  bool tx_valid;
+  uint8_t tx_byte;
+  uint8_t shift;
+
+  // register file
+  uint32_t ctrl;
+  uint32_t clkdiv;
+  uint32_t saddr;
+  uint32_t saddrmask;
+  uint32_t rxdata;
+  uint32_t txdouble;
+  uint32_t if_;
+  uint32_t ien;
+  uint32_t routepen;
+  uint32_t routeloc0;
+
+  // faults
+  uint32_t nack_after;
+  uint32_t nack_count;
+  uint64_t sda_stuck_until;
+
+  // busy read address polling
+  bool fast_poll;
+  uint64_t poll_limit_ns;
+  bool poll_seen;
+  uint8_t poll_addr;
+  uint64_t poll_nack_ns;
+
+  // access currently being single stepped
+  bool stepping;
+  uint32_t view[NUM_REGS];
+
+  host_i2c_stats_t stats;
+} bus;
+
+static struct sigaction old_segv;
+static struct sigaction old_trap;
+
+//***********************************************************************************
+// Bus
+//***********************************************************************************
+
+static bool sda_stuck(void){
+  return host_time_ns < bus.sda_stuck_until;
+}
+
+static void release_device(void){
+  if(bus.dev && bus.dev->stop){
+      bus.dev->stop(bus.dev);
+  }
+  bus.dev = NULL;
+}
+
+static void go_idle(void){
+  release_device();
+  bus.phase = PHASE_IDLE;
+  bus.need_addr = false;
+  bus.rx_wait = false;
+  bus.cmd_start = false;
+  bus.cmd_stop = false;
+  bus.cmd_ack = false;
+  bus.cmd_nack = false;
+  bus.tx_valid = false;
+}
+
+// the master let SDA go high for a bit while something held it low
+static void arbitration_lost(void){
+  bus.stats.arb_lost++;
+  bus.if_ |= I2C_IF_ARBLOST;
+  go_idle();
+}
+
+static void begin(phase_t phase, uint32_t bits){
+  bus.phase = phase;
+  bus.bits_left = bits;
+}
+
+static void begin_tx(void){
+  if(sda_stuck()){
+      arbitration_lost();
+      return;
+  }
+  bus.shift = bus.tx_byte;
+  bus.tx_valid = false;
+  begin(PHASE_TX, BYTE_BITS);
+}
+
+static void begin_stop(void){
+  bus.cmd_stop = false;
+  if(sda_stuck()){
+      arbitration_lost();
+      return;
+  }
+  begin(PHASE_STOP, 1);
+}
+
+static host_i2c_device_t *find_device(uint8_t address){
+  for(uint32_t i = 0; i < bus.num_devices; i++){
+      if(bus.devices[i]->address == address){
+          return bus.devices[i];
+      }
+  }
+  return NULL;
+}
+
+static bool injected_nack(void){
+  if(bus.nack_after){
+      bus.nack_after--;
+      return false;
+  }
+  if(bus.nack_count){
+      bus.nack_count--;
+      bus.stats.injected_nacks++;
+      return true;
+  }
+  return false;
+}
+
+// skip the retries of a driver polling a busy device, up to the last one
+static void fast_poll(uint8_t address){
+  host_i2c_device_t *dev = find_device(address >> 1);
+  uint64_t until = (dev && dev->busy_until) ? dev->busy_until(dev) : 0;
+
+  if(!bus.fast_poll || until <= host_time_ns){
+      bus.poll_seen = false;
+      return;
+  }
+  if(!bus.poll_seen || bus.poll_addr != address){
+      bus.poll_seen = true;                 // need one full retry to time it
+      bus.poll_addr = address;
+      bus.poll_nack_ns = host_time_ns;
+      return;
+  }
+
+  uint64_t cycle = host_time_ns - bus.poll_nack_ns;
+  uint64_t end = until < bus.poll_limit_ns ? until : bus.poll_limit_ns;
+
+  bus.poll_nack_ns = host_time_ns;
+  if(!cycle || end <= host_time_ns + cycle){
+      return;
+  }
+
+  uint64_t skip = (end - host_time_ns) / cycle - 1;
+  host_time_ns += skip * cycle;
+  bus.poll_nack_ns = host_time_ns;
+  bus.stats.ticks += skip * cycle / host_i2c_tick_ns();
+  bus.stats.starts += (uint32_t)skip;
+  bus.stats.nacks += (uint32_t)skip;
+  bus.stats.skipped_polls += (uint32_t)skip;
+  host_irq_count[I2C0_IRQn] += (uint32_t)skip;
+}
+
+static void tx_done(void){
+  bool ack;
+  bool busy_nack = false;
+
+  if(injected_nack()){
+      ack = false;
+      if(bus.need_addr){
+          bus.dev = NULL;
+      }
+  }
+  else if(bus.need_addr){
+      bus.reading = bus.shift & 1u;
+      bus.dev = find_device(bus.shift >> 1);
+      ack = bus.dev && bus.dev->start(bus.dev, bus.reading);
+      if(!ack){
+          bus.dev = NULL;                   // a NACKed address deselects
+          busy_nack = bus.reading;
+      }
+  }
+  else{
+      ack = bus.dev && bus.dev->write(bus.dev, bus.shift);
+  }
+
+  if(ack){
+      bus.stats.acks++;
+      bus.if_ |= I2C_IF_ACK | I2C_IF_TXC;
+  }
+  else{
+      bus.stats.nacks++;
+      bus.if_ |= I2C_IF_NACK | I2C_IF_TXC;
+  }
+
+  if(busy_nack){
+      fast_poll(bus.shift);
+  }
+  else if(bus.need_addr){
+      bus.poll_seen = false;
+  }
+
+  if(bus.need_addr && ack && bus.reading){
+      bus.need_addr = false;
+      begin(PHASE_RX, BYTE_BITS - 1);       // the master clocks in the first byte by itself
+      return;
+  }
+  bus.need_addr = false;
+  bus.rx_wait = false;
+  bus.phase = PHASE_HOLD;
+}
+
+static void rx_done(void){
+  uint8_t byte = 0xFF;
+
+  if(bus.dev && bus.dev->read && !bus.dev->read(bus.dev, &byte)){
+      bus.stats.stretch_ticks++;
+      bus.bits_left = 1;                    // SCL stretched, try again next period
+      return;
+  }
+  if(sda_stuck()){
+      byte = 0x00;
+  }
+  bus.rxdata = byte;
+  bus.if_ |= I2C_IF_RXDATAV;
+  bus.rx_wait = true;
+  bus.phase = PHASE_HOLD;
+}
+
+// start whatever software asked for once the bus is waiting on it
+static void schedule(void){
+  if(bus.phase == PHASE_IDLE){
+      if(bus.cmd_start){
+          if(sda_stuck()){
+              bus.stats.held_starts++;
+              return;
+          }
+          bus.cmd_start = false;
+          bus.stats.starts++;
+          begin(PHASE_START, 1);
+      }
+      else{
+          bus.cmd_stop = false;             // nothing to stop
+      }
+      return;
+  }
+  if(bus.phase != PHASE_HOLD){
+      return;
+  }
+
+  if(bus.rx_wait){
+      if(bus.cmd_ack || bus.cmd_nack){
+          bus.ack_bit = bus.cmd_ack;
+          bus.cmd_ack = false;
+          bus.cmd_nack = false;
+          bus.rx_wait = false;
+          if(!bus.ack_bit && sda_stuck()){
+              arbitration_lost();
+              return;
+          }
+          begin(PHASE_ACK, 1);
+      }
+      return;
+  }
+
+  if(bus.need_addr){
+      if(bus.tx_valid){
+          begin_tx();
+      }
+      else if(bus.cmd_stop){
+          begin_stop();
+      }
+      return;
+  }
+
+  if(bus.cmd_start){
+      bus.cmd_start = false;
+      bus.stats.starts++;
+      release_device();
+      begin(PHASE_START, 1);
+  }
+  else if(bus.tx_valid){
+      begin_tx();
+  }
+  else if(bus.cmd_stop){
+      begin_stop();
+  }
+}
+
+static void step(void){
+  host_time_ns += host_i2c_tick_ns();
+  bus.stats.ticks++;
+
+  if(bus.phase != PHASE_IDLE && bus.phase != PHASE_HOLD && --bus.bits_left == 0){
+      switch(bus.phase){
+        case PHASE_START:
+          bus.if_ |= I2C_IF_START;
+          bus.need_addr = true;
+          bus.rx_wait = false;
+          bus.phase = PHASE_HOLD;
+          break;
+
+        case PHASE_TX:
+          tx_done();
+          break;
+
+        case PHASE_RX:
+          rx_done();
+          break;
+
+        case PHASE_ACK:
+          if(bus.ack_bit){
+              begin(PHASE_RX, BYTE_BITS - 1);
+          }
+          else{
+              bus.phase = PHASE_HOLD;
+          }
+          break;
+
+        case PHASE_STOP:
+          bus.if_ |= I2C_IF_MSTOP;
+          go_idle();
+          break;
+
+        default:
+          break;
+      }
+  }
+
+  schedule();
+}
+
+//***********************************************************************************
+// Registers
+//***********************************************************************************
+
+static uint32_t state_reg(void){
+  uint32_t state;
+
+  switch(bus.phase){
+    case PHASE_IDLE:
+      return sda_stuck() ? I2C_STATE_BUSY : I2C_STATE_STATE_IDLE;
+    case PHASE_START:
+      state = STATE_START;
+      break;
+    case PHASE_TX:
+      state = bus.need_addr ? STATE_ADDR : STATE_DATA;
+      break;
+    case PHASE_RX:
+      state = STATE_DATA;
+      break;
+    case PHASE_ACK:
+      state = STATE_DATAACK;
+      break;
+    default:
+      state = STATE_WAIT;
+      break;
+  }
+  return I2C_STATE_BUSY | (state << _I2C_STATE_STATE_SHIFT);
+}
+
+static void fill_view(void){
+  uint32_t *v = bus.view;
+
+  memset(v, 0, sizeof(bus.view));
+  v[REG(CTRL)] = bus.ctrl;
+  v[REG(CMD)] = WRITE_SENTINEL;
+  v[REG(STATE)] = state_reg();
+  v[REG(CLKDIV)] = bus.clkdiv;
+  v[REG(SADDR)] = bus.saddr;
+  v[REG(SADDRMASK)] = bus.saddrmask;
+  v[REG(RXDATA)] = bus.rxdata;
+  v[REG(RXDATAP)] = bus.rxdata;
+  v[REG(TXDATA)] = WRITE_SENTINEL;
+  v[REG(TXDOUBLE)] = bus.txdouble;
+  v[REG(IF)] = bus.if_;
+  v[REG(IFS)] = WRITE_SENTINEL;
+  v[REG(IFC)] = WRITE_SENTINEL;
+  v[REG(IEN)] = bus.ien;
+  v[REG(ROUTEPEN)] = bus.routepen;
+  v[REG(ROUTELOC0)] = bus.routeloc0;
+}
+
+static void write_cmd(uint32_t cmd){
+  if(cmd & I2C_CMD_ABORT){
+      go_idle();
+  }
+  if(cmd & I2C_CMD_CLEARTX){
+      bus.tx_valid = false;
+  }
+  if(cmd & I2C_CMD_START){
+      bus.cmd_start = true;
+  }
+  if(cmd & I2C_CMD_STOP){
+      bus.cmd_stop = true;
+      if(bus.rx_wait && !bus.cmd_ack){
+          bus.cmd_nack = true;              // a NACK written just before may have been missed
+      }
+  }
+  if((cmd & I2C_CMD_ACK) && bus.rx_wait){
+      bus.cmd_ack = true;
+  }
+  if((cmd & I2C_CMD_NACK) && bus.rx_wait){
+      bus.cmd_nack = true;
+  }
+}
+
+static void write_reg(uint32_t reg, uint32_t value){
+  switch(reg){
+    case REG(CTRL):       bus.ctrl = value; break;
+    case REG(CMD):        write_cmd(value); break;
+    case REG(CLKDIV):     bus.clkdiv = value; break;
+    case REG(SADDR):      bus.saddr = value; break;
+    case REG(SADDRMASK):  bus.saddrmask = value; break;
+    case REG(TXDATA):     bus.tx_byte = (uint8_t)value; bus.tx_valid = true; break;
+    case REG(TXDOUBLE):   bus.txdouble = value; break;
+    case REG(IFS):        bus.if_ |= value; break;
+    case REG(IFC):        bus.if_ &= ~value; break;
+    case REG(IEN):        bus.ien = value; break;
+    case REG(ROUTEPEN):   bus.routepen = value; break;
+    case REG(ROUTELOC0):  bus.routeloc0 = value; break;
+    default:              break;        // read only
+  }
+}
+
+static void read_reg(uint32_t reg){
+  if(reg == REG(RXDATA)){
+      bus.if_ &= ~I2C_IF_RXDATAV;
+  }
+}
+
+//***********************************************************************************
+// Access trapping
+//***********************************************************************************
+
+static volatile uint32_t *page(void){
+  return (volatile uint32_t *)&host_i2c0;
+}
+
+static void protect(bool trap){
+  mprotect(&host_i2c0, sizeof(host_i2c0), trap ? PROT_NONE : PROT_READ | PROT_WRITE);
+}
+
+// untrapped mode, runs from host_sync()
+static void sync_page(void){
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      uint32_t value = page()[i];
+      if(value != bus.view[i]){
+          write_reg(i, value);
+      }
+  }
+  fill_view();
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      page()[i] = bus.view[i];
+  }
+}
+
+static uint32_t access_reg;
+
+static void on_segv(int sig, siginfo_t *info, void *context){
+  ucontext_t *uc = context;
+  uintptr_t addr = (uintptr_t)info->si_addr;
+  uintptr_t base = (uintptr_t)&host_i2c0;
+
+  if(!bus.attached || bus.stepping || addr < base || addr >= base + sizeof(host_i2c0)){
+      sigaction(SIGSEGV, &old_segv, NULL);  // not ours, fault again without us
+      return;
+  }
+
+  access_reg = (uint32_t)((addr - base) / sizeof(uint32_t));
+  bus.stats.accesses++;
+
+  // polling from thread mode lets bus time pass
+  if(!host_irq_masked() && (access_reg == REG(IF) || access_reg == REG(STATE) || access_reg == REG(STATUS))){
+      step();
+  }
+
+  fill_view();
+  protect(false);
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      page()[i] = bus.view[i];
+  }
+  bus.stepping = true;
+  uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TF;
+  (void)sig;
+}
+
+static void on_trap(int sig, siginfo_t *info, void *context){
+  ucontext_t *uc = context;
+
+  if(!bus.stepping){
+      sigaction(SIGTRAP, &old_trap, NULL);
+      raise(SIGTRAP);
+      return;
+  }
+  uc->uc_mcontext.gregs[REG_EFL] &= ~(greg_t)EFLAGS_TF;
+  bus.stepping = false;
+
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      uint32_t value = page()[i];
+      if(value != bus.view[i]){
+          write_reg(i, value);
+      }
+  }
+  if(access_reg < NUM_REGS){
+      read_reg(access_reg);
+  }
+  protect(true);
+  (void)sig;
+  (void)info;
+}
+
+//***********************************************************************************
+// API
+//***********************************************************************************
+
+void host_i2c_attach(void){
+  struct sigaction sa;
+
+  memset(&bus, 0, sizeof(bus));
+  bus.ctrl = I2C0->CTRL;
+  bus.clkdiv = I2C0->CLKDIV;
+  bus.ien = I2C0->IEN;
+  bus.attached = true;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_sigaction = on_segv;
+  sigaction(SIGSEGV, &sa, &old_segv);
+  sa.sa_sigaction = on_trap;
+  sigaction(SIGTRAP, &sa, &old_trap);
+
+  host_if_model(I2C0_IRQn, true);
+  bus.trapping = true;
+  protect(true);
+}
+
+void host_i2c_detach(void){
+  if(!bus.attached){
+      return;
+  }
+  host_i2c_set_trapping(false);
+  host_sync_hook = NULL;
+  fill_view();
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      page()[i] = bus.view[i] == WRITE_SENTINEL ? 0 : bus.view[i];
+  }
+  bus.attached = false;
+  sigaction(SIGSEGV, &old_segv, NULL);
+  sigaction(SIGTRAP, &old_trap, NULL);
+  host_if_model(I2C0_IRQn, false);
+}
+
+void host_i2c_add_device(host_i2c_device_t *dev){
+  if(bus.num_devices < HOST_I2C_MAX_DEVICES){
+      bus.devices[bus.num_devices++] = dev;
+  }
+}
+
+void host_i2c_set_trapping(bool trap){
+  if(trap == bus.trapping){
+      return;
+  }
+  bus.trapping = trap;
+  if(trap){
+      host_sync_hook = NULL;
+      sync_page();                          // pick up writes made since the last sync
+      protect(true);
+      return;
+  }
+  protect(false);
+  fill_view();
+  for(uint32_t i = 0; i < NUM_REGS; i++){
+      page()[i] = bus.view[i];
+  }
+  host_sync_hook = sync_page;
+}
+
+// skipped retries never take the time past limit_ns
+void host_i2c_set_fast_poll(bool enable, uint64_t limit_ns){
+  bus.fast_poll = enable;
+  bus.poll_limit_ns = limit_ns;
+}
+
+// one SCL period, then the interrupt if one is due
+void host_i2c_tick(void){
+  step();
+  if(bus.if_ & bus.ien){
+      host_irq_invoke(I2C0_IRQn);
+  }
+}
+
+// SCL period from CLKDIV, following the host I2C_Init
+uint32_t host_i2c_tick_ns(void){
+  if(!bus.clkdiv){
+      return DEFAULT_TICK_NS;
+  }
+  return (uint32_t)((8ull * bus.clkdiv * 1000000000ull) / HFPER_HZ);
+}
+
+bool host_i2c_idle(void){
+  return bus.phase == PHASE_IDLE && !bus.cmd_start;
+}
+
+// the next tick can change the bus, it isn't just waiting on software
+bool host_i2c_pending(void){
+  switch(bus.phase){
+    case PHASE_IDLE:
+      return bus.cmd_start;
+    case PHASE_HOLD:
+      if(bus.rx_wait){
+          return bus.cmd_ack || bus.cmd_nack;
+      }
+      return bus.tx_valid || bus.cmd_stop || (bus.cmd_start && !bus.need_addr);
+    default:
+      return true;
+  }
+}
+
+// the next count ACKs from any device read as NACK, after letting some through
+void host_i2c_fault_nack(uint32_t after, uint32_t count){
+  bus.nack_after = after;
+  bus.nack_count = count;
+}
+
+void host_i2c_fault_stuck_sda(uint64_t duration_ns){
+  bus.sda_stuck_until = host_time_ns + duration_ns;
+}
+
+void host_i2c_get_stats(host_i2c_stats_t *stats){
+  *stats = bus.stats;
+}
+
+void host_i2c_clear_stats(void){
+  memset(&bus.stats, 0, sizeof(bus.stats));
+}
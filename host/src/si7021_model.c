@@ -0,0 +1,205 @@
+/**
+ * @file si7021_model.c
+ *
+ * @brief
+ *  Behavioural Si7021 on the host I2C bus
+ *
+ */
+
+#include <math.h>
+#include "host.h"
+#include "si7021_model.h"
+
+#define CMD_MEASURE_T_HOLD      0xE3u
+#define CMD_MEASURE_T_NO_HOLD   0xF3u
+#define CMD_WRITE_USER_REG1     0xE6u
+#define CMD_READ_USER_REG1      0xE7u
+#define CMD_RESET               0xFEu
+
+#define USER_RES_MASK           0x81u
+#define USER_WRITABLE           0x85u       // RES1, HTRE, RES0
+#define CRC_POLY                0x31u
+
+enum {
+  EXPECT_NOTHING,
+  EXPECT_CMD,
+  EXPECT_USER_REG
+};
+
+static si7021_model_t *model_of(host_i2c_device_t *dev){
+  return (si7021_model_t *)dev;
+}
+
+// datasheet maximum temperature conversion time
+uint32_t si7021_model_conversion_ns(uint8_t user_reg){
+  switch(user_reg & USER_RES_MASK){
+    case 0x00: return 10800000u;            // 14 bit
+    case 0x80: return 6200000u;             // 13 bit
+    case 0x01: return 3800000u;             // 12 bit
+    default:   return 2400000u;             // 11 bit
+  }
+}
+
+// temperature code with the bits below the resolution cleared
+uint16_t si7021_model_code(double temperature, uint8_t user_reg){
+  static const uint16_t mask[] = { 0xFFFC, 0xFFF0, 0xFFF8, 0xFFE0 };
+  double code = round((temperature + 46.85) * 65536.0 / 175.72);
+  uint32_t res = ((user_reg >> 6) & 0x2u) | (user_reg & 0x1u);
+
+  if(code < 0){
+      code = 0;
+  }
+  if(code > 0xFFFF){
+      code = 0xFFFF;
+  }
+  return (uint16_t)code & mask[res];
+}
+
+uint8_t si7021_model_crc(const uint8_t *data, uint32_t len){
+  uint8_t crc = 0;
+
+  for(uint32_t i = 0; i < len; i++){
+      crc ^= data[i];
+      for(int b = 0; b < 8; b++){
+          crc = (crc & 0x80u) ? (uint8_t)((crc << 1) ^ CRC_POLY) : (uint8_t)(crc << 1);
+      }
+  }
+  return crc;
+}
+
+static double model_uniform(si7021_model_t *m){
+  if(!m->rng){
+      m->rng = m->seed ? m->seed : 1u;
+  }
+  m->rng ^= m->rng << 13;                   // xorshift32
+  m->rng ^= m->rng >> 17;
+  m->rng ^= m->rng << 5;
+  return (m->rng + 1.0) / 4294967297.0;
+}
+
+// temperature the conversion ends up measuring
+static double model_measured(si7021_model_t *m){
+  double t = m->temperature;
+
+  if(m->noise > 0){
+      double u = model_uniform(m), v = model_uniform(m);
+      t += m->noise * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);     // Box-Muller
+  }
+  if(m->spike_rate > 0 && model_uniform(m) < m->spike_rate){
+      t += model_uniform(m) < 0.5 ? -m->spike : m->spike;
+  }
+  return t;
+}
+
+static bool conversion_busy(si7021_model_t *m){
+  if(!m->converting){
+      return false;
+  }
+  if(host_time_ns < m->ready_ns){
+      return true;
+  }
+
+  uint16_t code = si7021_model_code(model_measured(m), m->user_reg);
+  m->converting = false;
+  m->conversions++;
+  m->out[0] = (uint8_t)(code >> 8);
+  m->out[1] = (uint8_t)code;
+  m->out[2] = si7021_model_crc(m->out, 2);
+  m->out_len = 3;
+  m->out_pos = 0;
+  return false;
+}
+
+static bool model_start(host_i2c_device_t *dev, bool read){
+  si7021_model_t *m = model_of(dev);
+
+  if(!read){
+      m->expect = EXPECT_CMD;
+      return true;
+  }
+  m->expect = EXPECT_NOTHING;
+  if(conversion_busy(m) && !m->hold){
+      m->busy_nacks++;
+      return false;
+  }
+  m->out_pos = 0;
+  return true;
+}
+
+static bool model_write(host_i2c_device_t *dev, uint8_t byte){
+  si7021_model_t *m = model_of(dev);
+
+  switch(m->expect){
+    case EXPECT_CMD:
+      m->expect = EXPECT_NOTHING;
+      switch(byte){
+        case CMD_MEASURE_T_HOLD:
+        case CMD_MEASURE_T_NO_HOLD:
+          m->converting = true;
+          m->hold = byte == CMD_MEASURE_T_HOLD;
+          m->ready_ns = host_time_ns + si7021_model_conversion_ns(m->user_reg);
+          m->converting_ns += si7021_model_conversion_ns(m->user_reg);
+          m->out_len = 0;
+          return true;
+
+        case CMD_WRITE_USER_REG1:
+          m->expect = EXPECT_USER_REG;
+          return true;
+
+        case CMD_READ_USER_REG1:
+          m->out[0] = m->user_reg;
+          m->out_len = 1;
+          return true;
+
+        case CMD_RESET:
+          m->user_reg = SI7021_MODEL_USER_RESET;
+          m->converting = false;
+          m->out_len = 0;
+          return true;
+
+        default:
+          return false;
+      }
+
+    case EXPECT_USER_REG:
+      m->expect = EXPECT_NOTHING;
+      m->user_reg = (uint8_t)((m->user_reg & ~USER_WRITABLE) | (byte & USER_WRITABLE));
+      return true;
+
+    default:
+      return false;                         // nothing more is expected in this transfer
+  }
+}
+
+static bool model_read(host_i2c_device_t *dev, uint8_t *byte){
+  si7021_model_t *m = model_of(dev);
+
+  if(conversion_busy(m)){
+      return false;                         // hold master, stretch SCL
+  }
+  *byte = m->out_pos < m->out_len ? m->out[m->out_pos++] : 0xFF;
+  return true;
+}
+
+static void model_stop(host_i2c_device_t *dev){
+  model_of(dev)->expect = EXPECT_NOTHING;
+}
+
+// a no hold conversion NACKs its read address until it is done
+static uint64_t model_busy_until(host_i2c_device_t *dev){
+  si7021_model_t *m = model_of(dev);
+
+  return (m->converting && !m->hold) ? m->ready_ns : 0;
+}
+
+void si7021_model_init(si7021_model_t *model, double temperature){
+  *model = (si7021_model_t){ 0 };
+  model->dev.address = SI7021_MODEL_ADDRESS;
+  model->dev.start = model_start;
+  model->dev.write = model_write;
+  model->dev.read = model_read;
+  model->dev.stop = model_stop;
+  model->dev.busy_until = model_busy_until;
+  model->temperature = temperature;
+  model->user_reg = SI7021_MODEL_USER_RESET;
+}
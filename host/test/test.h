@@ -0,0 +1,47 @@
+/**
+ * @file test.h
+ *
+ * @brief
+ *  Minimal checks for the host unit tests
+ *
+ * @details
+ *  Each test_*.c is one ctest executable. CHECK() prints the failed
+ *  expression with its line and carries on, so one run lists every
+ *  failure, and test_done() turns the count into the exit status.
+ *
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+static int test_failures;
+
+#define CHECK(expr)                                                             \
+  do{                                                                           \
+    if(!(expr)){                                                                \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr);         \
+        test_failures++;                                                        \
+    }                                                                           \
+  }while(0)
+
+// integer compare that prints both values
+#define CHECK_EQ(a, b)                                                          \
+  do{                                                                           \
+    long long a_ = (long long)(a), b_ = (long long)(b);                         \
+    if(a_ != b_){                                                               \
+        printf("%s:%d: CHECK_EQ(%s, %s) failed, %lld != %lld\n", __FILE__,      \
+               __LINE__, #a, #b, a_, b_);                                       \
+        test_failures++;                                                        \
+    }                                                                           \
+  }while(0)
+
+static inline int test_done(const char *name){
+  printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+  return test_failures ? 1 : 0;
+}
+
+#endif /* HOST_TEST_H_ */
@@ -0,0 +1,99 @@
+/**
+ * @file test_alarm.c
+ *
+ * @brief
+ *  Threshold alarms: dwell, hysteresis, falling thresholds and the rate
+ *  source
+ *
+ */
+
+#include "test.h"
+#include "host.h"
+#include "alarm.h"
+#include "brd_config.h"
+
+#define LEVEL_BIT   0b01u
+#define RATE_BIT    0b10u
+
+static void open_alarms(bool rising){
+  ALARM_Open_TypeDef a;
+
+  a.num_thresholds = 2;
+  a.threshold[0].source = ALARM_LEVEL;
+  a.threshold[0].rising = rising;
+  a.threshold[0].set = rising ? 100 : 50;
+  a.threshold[0].clear = rising ? 90 : 60;
+  a.threshold[0].dwell = 2;
+  a.threshold[1].source = ALARM_RATE;
+  a.threshold[1].rising = true;
+  a.threshold[1].set = 10;
+  a.threshold[1].clear = 2;
+  a.threshold[1].dwell = 1;
+  a.cb = ALARM_CB;
+  alarm_open(&a);
+  remove_scheduled_event(ALARM_CB);
+}
+
+// feeds one reading, returns the changed bits and checks they were posted
+static uint32_t feed(uint32_t raw){
+  remove_scheduled_event(ALARM_CB);
+  alarm_update(raw);
+  CHECK_EQ(!!(get_scheduled_events() & ALARM_CB), !!alarm_get_changed());
+  return alarm_get_changed();
+}
+
+static void test_level(void){
+  open_alarms(true);
+
+  CHECK_EQ(feed(95), 0);
+  CHECK_EQ(feed(100), 0);                       // one sample of dwell
+  CHECK_EQ(feed(99), 0);                        // back under set, dwell restarts
+  CHECK_EQ(feed(100), 0);
+  CHECK_EQ(feed(101), LEVEL_BIT);
+  CHECK_EQ(alarm_get_state(), LEVEL_BIT);
+
+  // hysteresis, only at or below clear counts
+  CHECK_EQ(feed(95), 0);
+  CHECK_EQ(feed(91), 0);
+  CHECK_EQ(feed(90), 0);
+  CHECK_EQ(feed(89), LEVEL_BIT);
+  CHECK_EQ(alarm_get_state(), 0);
+}
+
+static void test_falling(void){
+  open_alarms(false);
+
+  CHECK_EQ(feed(55), 0);
+  CHECK_EQ(feed(50), 0);
+  CHECK_EQ(feed(50), LEVEL_BIT);
+  CHECK_EQ(feed(59), 0);
+  CHECK_EQ(feed(60), 0);
+  CHECK_EQ(feed(61), LEVEL_BIT);
+  CHECK_EQ(alarm_get_state(), 0);
+}
+
+static void test_rate(void){
+  open_alarms(true);
+
+  CHECK_EQ(feed(40), 0);                        // no rate on the first sample
+  CHECK_EQ(feed(49), 0);
+  CHECK_EQ(feed(59), RATE_BIT);                 // rise of 10, dwell 1
+  CHECK_EQ(feed(62), 0);                        // rise of 3, above clear
+  CHECK_EQ(feed(64), RATE_BIT);
+  CHECK_EQ(alarm_get_state(), 0);
+
+  // a new threshold applies from the next sample
+  alarm_set_threshold(1, 4, 1);
+  CHECK_EQ(feed(68), RATE_BIT);
+  CHECK_EQ(alarm_get_state(), RATE_BIT);
+}
+
+int main(void){
+  host_reset();
+  scheduler_open();
+
+  test_level();
+  test_falling();
+  test_rate();
+  return test_done("alarm");
+}
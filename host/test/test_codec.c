@@ -0,0 +1,134 @@
+/**
+ * @file test_codec.c
+ *
+ * @brief
+ *  Telemetry codec: round-trip, keyframe spacing, resuming a stream midway
+ *  and truncated input
+ *
+ */
+
+#include <string.h>
+#include "test.h"
+#include "codec.h"
+
+#define TEST_SAMPLES    1000u
+#define TEST_INTERVAL   CODEC_KEYFRAME_INTERVAL
+
+static uint16_t samples[TEST_SAMPLES];
+static uint8_t stream[TEST_SAMPLES * CODEC_MAX_BYTES];
+static uint32_t offset[TEST_SAMPLES + 1];   // stream offset of each sample
+
+// a slow walk with steps of every length, jumps and 16 bit wraparound
+static void make_samples(void){
+  uint32_t x = 0x6000u, lcg = 1;
+
+  for(uint32_t i = 0; i < TEST_SAMPLES; i++){
+      lcg = lcg * 1103515245u + 12345u;
+      if(i % 97 == 50){
+          x += 0x8000u;                         // longest delta
+      }else if(i % 41 == 20){
+          x = (i & 1) ? 0xFFFFu : 0u;           // around the wrap
+      }else{
+          x += (lcg >> 16) % 129u - 64u;
+      }
+      samples[i] = (uint16_t)x;
+  }
+}
+
+static bool is_keyframe(uint32_t i){
+  return stream[offset[i]] & CODEC_TAG_KEYFRAME;
+}
+
+static void encode_all(void){
+  CODEC_State_TypeDef enc;
+
+  codec_init(&enc, TEST_INTERVAL);
+  offset[0] = 0;
+  for(uint32_t i = 0; i < TEST_SAMPLES; i++){
+      uint32_t len = codec_encode(&enc, samples[i], &stream[offset[i]]);
+      CHECK(len >= 1 && len <= CODEC_MAX_BYTES);
+      offset[i + 1] = offset[i] + len;
+  }
+}
+
+static void test_round_trip(void){
+  CODEC_State_TypeDef dec;
+  uint16_t raw;
+
+  codec_init(&dec, TEST_INTERVAL);
+  for(uint32_t i = 0; i < TEST_SAMPLES; i++){
+      CHECK_EQ(codec_decode(&dec, &stream[offset[i]], offset[i + 1] - offset[i], &raw),
+               offset[i + 1] - offset[i]);
+      CHECK(dec.synced);
+      CHECK_EQ(raw, samples[i]);
+      CHECK_EQ(is_keyframe(i), i % TEST_INTERVAL == 0);
+  }
+}
+
+static void test_resume(void){
+  CODEC_State_TypeDef dec;
+  uint32_t start = TEST_INTERVAL + 5, i, used;
+  uint16_t raw;
+
+  // joining midway, deltas are skipped until the next keyframe
+  codec_init(&dec, TEST_INTERVAL);
+  for(i = start; i < TEST_SAMPLES; i++){
+      used = codec_decode(&dec, &stream[offset[i]], TEST_SAMPLES * CODEC_MAX_BYTES - offset[i], &raw);
+      CHECK_EQ(used, offset[i + 1] - offset[i]);
+      CHECK_EQ(dec.synced, i >= 2 * TEST_INTERVAL);
+      if(dec.synced){
+          CHECK_EQ(raw, samples[i]);
+      }
+  }
+}
+
+static void test_forced_keyframe(void){
+  CODEC_State_TypeDef enc, dec;
+  uint8_t buf[CODEC_MAX_BYTES];
+  uint16_t raw;
+  uint32_t len;
+
+  codec_init(&enc, TEST_INTERVAL);
+  codec_encode(&enc, 100, buf);
+  CHECK(buf[0] & CODEC_TAG_KEYFRAME);             // the first sample always is
+  codec_encode(&enc, 101, buf);
+  CHECK(!(buf[0] & CODEC_TAG_KEYFRAME));
+
+  // the sample after codec_keyframe() decodes on its own
+  codec_keyframe(&enc);
+  len = codec_encode(&enc, 40000, buf);
+  CHECK(buf[0] & CODEC_TAG_KEYFRAME);
+  codec_init(&dec, TEST_INTERVAL);
+  CHECK_EQ(codec_decode(&dec, buf, len, &raw), len);
+  CHECK(dec.synced);
+  CHECK_EQ(raw, 40000);
+}
+
+static void test_truncated(void){
+  CODEC_State_TypeDef enc, dec;
+  uint8_t buf[CODEC_MAX_BYTES];
+  uint16_t raw;
+  uint32_t len;
+
+  codec_init(&enc, TEST_INTERVAL);
+  len = codec_encode(&enc, 0xFFFFu, buf);
+  CHECK_EQ(len, CODEC_MAX_BYTES);
+
+  codec_init(&dec, TEST_INTERVAL);
+  CHECK_EQ(codec_decode(&dec, buf, len - 1, &raw), 0);
+  CHECK_EQ(codec_decode(&dec, buf, 0, &raw), 0);
+  CHECK(!dec.synced);
+  CHECK_EQ(codec_decode(&dec, buf, len, &raw), len);
+  CHECK_EQ(raw, 0xFFFFu);
+}
+
+int main(void){
+  make_samples();
+  encode_all();
+
+  test_round_trip();
+  test_resume();
+  test_forced_keyframe();
+  test_truncated();
+  return test_done("codec");
+}
@@ -0,0 +1,77 @@
+/**
+ * @file test_filter.c
+ *
+ * @brief
+ *  Sample filter: burst averaging, median spike rejection and the EMA
+ *
+ */
+
+#include "test.h"
+#include "filter.h"
+
+static void open_filter(uint32_t burst, bool median, uint32_t ema_shift){
+  FILTER_Open_TypeDef f;
+
+  f.burst = burst;
+  f.median = median;
+  f.ema_shift = ema_shift;
+  filter_open(&f);
+}
+
+static void test_burst(void){
+  open_filter(4, false, 0);
+
+  CHECK(!filter_add(10));
+  CHECK(!filter_add(11));
+  CHECK(!filter_add(11));
+  CHECK(filter_add(11));
+  CHECK_EQ(filter_get(), 11);                   // 10.75 rounds up
+
+  CHECK(!filter_add(20));
+  CHECK(!filter_add(20));
+  CHECK(!filter_add(20));
+  CHECK(filter_add(21));
+  CHECK_EQ(filter_get(), 20);                   // 20.25 rounds down
+}
+
+static void test_median(void){
+  open_filter(1, true, 0);
+
+  // passed through until three samples are in
+  CHECK(filter_add(100));
+  CHECK_EQ(filter_get(), 100);
+  CHECK(filter_add(500));
+  CHECK_EQ(filter_get(), 500);
+
+  CHECK(filter_add(102));
+  CHECK_EQ(filter_get(), 102);
+  CHECK(filter_add(104));
+  CHECK_EQ(filter_get(), 104);
+  CHECK(filter_add(900));                       // a lone spike is dropped
+  CHECK_EQ(filter_get(), 104);
+  CHECK(filter_add(106));
+  CHECK_EQ(filter_get(), 106);
+}
+
+static void test_ema(void){
+  open_filter(1, false, 1);
+
+  CHECK(filter_add(100));                       // seeded with the first sample
+  CHECK_EQ(filter_get(), 100);
+  filter_add(200);
+  CHECK_EQ(filter_get(), 150);
+  filter_add(200);
+  CHECK_EQ(filter_get(), 175);
+
+  // reopening forgets the state
+  open_filter(1, false, 1);
+  filter_add(300);
+  CHECK_EQ(filter_get(), 300);
+}
+
+int main(void){
+  test_burst();
+  test_median();
+  test_ema();
+  return test_done("filter");
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_flash_log.c
+ *
+ * @brief
+ *  Flash log on the NOR flash model: read back, resume after reopening and
+ *  pages torn by a reset
+ *
+ * @details
+ *  Records are two bytes, the record number, so every page's contents
+ *  follow from its header's first_record. Page commits run to completion
+ *  between writes.
+ *
+ */
+
+#include <string.h>
+#include "test.h"
+#include "host.h"
+#include "em_msc.h"
+#include "flash_log.h"
+#include "brd_config.h"
+
+#define RECORDS_PER_PAGE    (FLASH_LOG_PAYLOAD_SIZE / 2u)
+
+static uint32_t records_written;
+
+static void drain(void){
+  while(get_scheduled_events() & FLASH_LOG_CB){
+      remove_scheduled_event(FLASH_LOG_CB);
+      flash_log_commit();
+  }
+}
+
+static void fresh_log(void){
+  memset(host_flash, 0xFF, FLASH_SIZE);
+  flash_log_open(FLASH_LOG_CB);
+  records_written = 0;
+}
+
+static void fill(uint32_t records){
+  for(uint32_t i = 0; i < records; i++){
+      uint8_t record[2] = { (uint8_t)records_written, (uint8_t)(records_written >> 8) };
+
+      CHECK(flash_log_write(record, sizeof(record)));
+      records_written++;
+      drain();
+  }
+}
+
+// checks a page's payload against the records it should hold
+static void check_page(const FLASH_LOG_Header_TypeDef *header, const uint8_t *payload){
+  CHECK_EQ(header->length, header->records * 2u);
+  for(uint32_t i = 0; i < header->records; i++){
+      uint32_t n = header->first_record + i;
+
+      CHECK_EQ(payload[2 * i] | payload[2 * i + 1] << 8, n & 0xFFFFu);
+  }
+}
+
+static void test_read_back(void){
+  const FLASH_LOG_Header_TypeDef *header;
+  const uint8_t *payload;
+  FLASH_LOG_Stats_TypeDef s;
+
+  fresh_log();
+  CHECK(!flash_log_read(0, &header, &payload));
+
+  fill(3 * RECORDS_PER_PAGE + 10);
+  flash_log_flush();                            // the partial page too
+  drain();
+  flash_log_get_stats(&s);
+  CHECK_EQ(s.records, 3 * RECORDS_PER_PAGE + 10);
+  CHECK_EQ(s.dropped, 0);
+  CHECK_EQ(s.pages, 4);
+
+  CHECK(flash_log_read(0, &header, &payload));
+  CHECK_EQ(header->records, 10);
+  CHECK_EQ(header->first_record, 3 * RECORDS_PER_PAGE);
+  check_page(header, payload);
+  for(uint32_t age = 1; age < 4; age++){
+      CHECK(flash_log_read(age, &header, &payload));
+      CHECK_EQ(header->records, RECORDS_PER_PAGE);
+      CHECK_EQ(header->first_record, (3 - age) * RECORDS_PER_PAGE);
+      check_page(header, payload);
+  }
+  CHECK(!flash_log_read(4, &header, &payload));
+}
+
+static void test_wrap(void){
+  const FLASH_LOG_Header_TypeDef *header;
+  const uint8_t *payload;
+  uint32_t age;
+
+  // twice round the region, only the last FLASH_LOG_PAGES pages are left
+  fresh_log();
+  fill(2 * FLASH_LOG_PAGES * RECORDS_PER_PAGE);
+  flash_log_flush();                            // a full page waits for the next record
+  drain();
+  for(age = 0; flash_log_read(age, &header, &payload); age++){
+      CHECK_EQ(header->first_record, (2 * FLASH_LOG_PAGES - 1 - age) * RECORDS_PER_PAGE);
+      check_page(header, payload);
+  }
+  CHECK(age >= FLASH_LOG_PAGES - 1 && age <= FLASH_LOG_PAGES);
+}
+
+static void test_resume(void){
+  const FLASH_LOG_Header_TypeDef *header;
+  const uint8_t *payload;
+  uint32_t seq, next;
+
+  fresh_log();
+  fill(3000);
+  CHECK(flash_log_read(0, &header, &payload));
+  seq = header->seq;
+  next = header->first_record + header->records;
+
+  // records still in RAM are lost, the next page follows the newest one
+  flash_log_open(FLASH_LOG_CB);
+  records_written = next;
+  fill(RECORDS_PER_PAGE + 1);
+  CHECK(flash_log_read(0, &header, &payload));
+  CHECK_EQ(header->seq, seq + 1);
+  CHECK_EQ(header->first_record, next);
+  check_page(header, payload);
+}
+
+static void test_torn(void){
+  const FLASH_LOG_Header_TypeDef *header;
+  const uint8_t *payload;
+  uint32_t seq, next;
+
+  fresh_log();
+  fill(3 * RECORDS_PER_PAGE);
+  CHECK(flash_log_read(1, &header, &payload));
+  seq = header->seq;
+  next = header->first_record + header->records;
+
+  // reset mid program, the payload no longer matches the crc
+  CHECK(flash_log_read(0, &header, &payload));
+  memset(&host_flash[(uintptr_t)payload - FLASH_BASE], 0, 4);
+  flash_log_open(FLASH_LOG_CB);
+  CHECK(flash_log_read(0, &header, &payload));
+  CHECK_EQ(header->seq, seq);
+
+  // the torn page is reused, numbering carries on from the last good one
+  records_written = next;
+  fill(RECORDS_PER_PAGE);
+  flash_log_flush();
+  drain();
+  CHECK(flash_log_read(0, &header, &payload));
+  CHECK_EQ(header->seq, seq + 1);
+  CHECK_EQ(header->first_record, next);
+  check_page(header, payload);
+
+  // reset before the magic word, programmed last, made it to flash
+  memset(&host_flash[(uintptr_t)header - FLASH_BASE], 0xFF, sizeof(header->magic));
+  flash_log_open(FLASH_LOG_CB);
+  CHECK(flash_log_read(0, &header, &payload));
+  CHECK_EQ(header->seq, seq);
+}
+
+int main(void){
+  host_reset();
+  scheduler_open();
+
+  test_read_back();
+  test_wrap();
+  test_resume();
+  test_torn();
+  return test_done("flash_log");
+}
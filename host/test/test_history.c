@@ -0,0 +1,112 @@
+/**
+ * @file test_history.c
+ *
+ * @brief
+ *  Trend history: minute, quarter and hour roll-ups and ring rollover
+ *
+ * @details
+ *  Minute m gets the samples 1000 + m and 1002 + m, so every entry's min,
+ *  mean and max follow from its index and a week and an hour is enough to
+ *  wrap all three rings.
+ *
+ */
+
+#include "test.h"
+#include "history.h"
+
+#define SAMPLES_PER_MINUTE  2u
+#define MINUTES_PER_HOUR    (HISTORY_MINUTES_PER_QUARTER * HISTORY_QUARTERS_PER_HOUR)
+#define TEST_HOURS          (HISTORY_HOUR_LEN + 1u)
+#define TEST_MINUTES        (TEST_HOURS * MINUTES_PER_HOUR)
+
+static void check_entry(tHISTORY_TIER tier, uint32_t age, uint32_t min, uint32_t mean, uint32_t max){
+  HISTORY_Entry_TypeDef e;
+
+  CHECK(history_read(tier, age, &e));
+  CHECK_EQ(e.min, min);
+  CHECK_EQ(e.mean, mean);
+  CHECK_EQ(e.max, max);
+}
+
+static void insert_minute(uint32_t m){
+  history_insert(1000u + m);
+  history_insert(1002u + m);
+}
+
+static void test_rollup(void){
+  uint32_t m;
+
+  history_open(SAMPLES_PER_MINUTE);
+  CHECK_EQ(history_count(HISTORY_MINUTE), 0);
+
+  history_insert(1000u);                        // half a minute is not an entry
+  CHECK_EQ(history_count(HISTORY_MINUTE), 0);
+  history_insert(1002u);
+  CHECK_EQ(history_count(HISTORY_MINUTE), 1);
+  check_entry(HISTORY_MINUTE, 0, 1000, 1001, 1002);
+
+  for(m = 1; m < HISTORY_MINUTES_PER_QUARTER; m++){
+      insert_minute(m);
+  }
+  CHECK_EQ(history_count(HISTORY_QUARTER), 1);
+  check_entry(HISTORY_QUARTER, 0, 1000, 1008, 1016);
+  CHECK_EQ(history_count(HISTORY_HOUR), 0);
+
+  for(; m < MINUTES_PER_HOUR; m++){
+      insert_minute(m);
+  }
+  CHECK_EQ(history_count(HISTORY_QUARTER), 4);
+  CHECK_EQ(history_count(HISTORY_HOUR), 1);
+  check_entry(HISTORY_HOUR, 0, 1000, 1031, 1061);  // 1030.5 rounds up
+}
+
+static void test_rollover(void){
+  HISTORY_Entry_TypeDef e;
+  uint32_t q, h;
+
+  history_open(SAMPLES_PER_MINUTE);
+  for(uint32_t m = 0; m < TEST_MINUTES; m++){
+      insert_minute(m);
+  }
+
+  CHECK_EQ(history_count(HISTORY_MINUTE), HISTORY_MINUTE_LEN);
+  CHECK_EQ(history_count(HISTORY_QUARTER), HISTORY_QUARTER_LEN);
+  CHECK_EQ(history_count(HISTORY_HOUR), HISTORY_HOUR_LEN);
+
+  // newest first, the oldest left is one ring length back
+  check_entry(HISTORY_MINUTE, 0, 1000 + TEST_MINUTES - 1, 1001 + TEST_MINUTES - 1,
+              1002 + TEST_MINUTES - 1);
+  check_entry(HISTORY_MINUTE, HISTORY_MINUTE_LEN - 1, 1000 + TEST_MINUTES - HISTORY_MINUTE_LEN,
+              1001 + TEST_MINUTES - HISTORY_MINUTE_LEN, 1002 + TEST_MINUTES - HISTORY_MINUTE_LEN);
+  CHECK(!history_read(HISTORY_MINUTE, HISTORY_MINUTE_LEN, &e));
+
+  q = TEST_MINUTES / HISTORY_MINUTES_PER_QUARTER - HISTORY_QUARTER_LEN;
+  check_entry(HISTORY_QUARTER, HISTORY_QUARTER_LEN - 1, 1000 + 15 * q, 1008 + 15 * q, 1016 + 15 * q);
+  CHECK(!history_read(HISTORY_QUARTER, HISTORY_QUARTER_LEN, &e));
+
+  h = TEST_HOURS - 1;
+  check_entry(HISTORY_HOUR, 0, 1000 + 60 * h, 1031 + 60 * h, 1061 + 60 * h);
+  h = TEST_HOURS - HISTORY_HOUR_LEN;
+  check_entry(HISTORY_HOUR, HISTORY_HOUR_LEN - 1, 1000 + 60 * h, 1031 + 60 * h, 1061 + 60 * h);
+  CHECK(!history_read(HISTORY_HOUR, HISTORY_HOUR_LEN, &e));
+}
+
+static void test_set_rate(void){
+  history_open(SAMPLES_PER_MINUTE);
+  history_set_rate(1);
+  history_insert(500u);
+  CHECK_EQ(history_count(HISTORY_MINUTE), 1);
+  check_entry(HISTORY_MINUTE, 0, 500, 500, 500);
+
+  // reopening empties every tier
+  history_open(SAMPLES_PER_MINUTE);
+  CHECK_EQ(history_count(HISTORY_MINUTE), 0);
+  CHECK_EQ(history_count(HISTORY_HOUR), 0);
+}
+
+int main(void){
+  test_rollup();
+  test_rollover();
+  test_set_rate();
+  return test_done("history");
+}
@@ -0,0 +1,83 @@
+/**
+ * @file test_report.c
+ *
+ * @brief
+ *  Report filter: delta suppression, heartbeat and counters
+ *
+ */
+
+#include "test.h"
+#include "report.h"
+
+static void open_report(uint32_t delta, uint32_t heartbeat){
+  REPORT_Open_TypeDef r;
+
+  r.delta = delta;
+  r.heartbeat = heartbeat;
+  report_open(&r);
+}
+
+static void check_stats(uint32_t samples, uint32_t forwarded, uint32_t heartbeats){
+  REPORT_Stats_TypeDef s;
+
+  report_get_stats(&s);
+  CHECK_EQ(s.samples, samples);
+  CHECK_EQ(s.forwarded, forwarded);
+  CHECK_EQ(s.heartbeats, heartbeats);
+}
+
+static void test_delta(void){
+  open_report(5, 0);
+
+  CHECK(report_filter(100));                    // the first is always forwarded
+  CHECK(!report_filter(105));                   // not further than delta
+  CHECK(!report_filter(95));
+  CHECK(report_filter(94));
+  CHECK(!report_filter(97));
+
+  // measured from the last forwarded sample, so a slow drift still gets out
+  CHECK(!report_filter(99));
+  CHECK(report_filter(100));
+  check_stats(7, 3, 0);
+
+  report_set_delta(0);
+  CHECK(report_filter(101));
+  CHECK(!report_filter(101));
+}
+
+static void test_heartbeat(void){
+  open_report(5, 4);
+
+  CHECK(report_filter(100));
+  CHECK(!report_filter(100));
+  CHECK(!report_filter(100));
+  CHECK(!report_filter(100));
+  CHECK(report_filter(100));                    // fourth sample since the last one
+  check_stats(5, 2, 1);
+
+  // a change restarts the count
+  CHECK(!report_filter(100));
+  CHECK(report_filter(110));
+  CHECK(!report_filter(110));
+  CHECK(!report_filter(110));
+  CHECK(!report_filter(110));
+  CHECK(report_filter(110));
+  check_stats(11, 4, 2);
+
+  // samples already counted carry over to a new heartbeat
+  CHECK(!report_filter(110));
+  CHECK(!report_filter(110));
+  report_set_heartbeat(2);
+  CHECK(report_filter(110));
+  report_set_heartbeat(0);
+  for(uint32_t i = 0; i < 100; i++){
+      CHECK(!report_filter(110));
+  }
+  check_stats(114, 5, 3);
+}
+
+int main(void){
+  test_delta();
+  test_heartbeat();
+  return test_done("report");
+}
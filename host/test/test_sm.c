@@ -0,0 +1,125 @@
+/**
+ * @file test_sm.c
+ *
+ * @brief
+ *  Table driven state machine: the app.c counter and the exit / entry order
+ *  of nested states
+ *
+ */
+
+#include <string.h>
+#include "test.h"
+#include "app.h"
+
+//***********************************************************************************
+// app_count_table
+//***********************************************************************************
+
+enum { ONE = 1, TWO, THREE, THREE_WAIT, THREE_PRESSED };
+
+static void test_counter(void){
+  SM_Machine_TypeDef sm;
+
+  sm_open(&sm, &app_count_table);
+  CHECK_EQ(sm_state(&sm), ONE);
+  CHECK(!sm_dispatch(&sm, APP_EV_BTN1));        // ONE only answers BTN0
+  CHECK_EQ(sm_state(&sm), ONE);
+
+  CHECK(sm_dispatch(&sm, APP_EV_BTN0));
+  CHECK_EQ(sm_state(&sm), TWO);
+  CHECK(sm_dispatch(&sm, APP_EV_BTN0));
+  CHECK_EQ(sm_state(&sm), ONE);
+
+  sm_dispatch(&sm, APP_EV_BTN0);
+  sm_dispatch(&sm, APP_EV_BTN1);
+  CHECK_EQ(sm_state(&sm), THREE_WAIT);
+  CHECK(sm_in(&sm, THREE));
+
+  // two presses of either button leave THREE
+  sm_dispatch(&sm, APP_EV_BTN1);
+  CHECK_EQ(sm_state(&sm), THREE_PRESSED);
+  CHECK(sm_in(&sm, THREE));
+  sm_dispatch(&sm, APP_EV_BTN0);
+  CHECK_EQ(sm_state(&sm), ONE);
+  CHECK(!sm_in(&sm, THREE));
+}
+
+//***********************************************************************************
+// nesting, A holds A1 and A2, B is a top level state
+//***********************************************************************************
+
+enum { A = 1, A1, A2, B };
+enum { EV_NEXT, EV_OUT, EV_SELF, EV_INT, EV_COUNT };
+
+static char trail[64];
+
+static void log_action(char kind, uint32_t state){
+  size_t n = strlen(trail);
+
+  trail[n] = kind;
+  trail[n + 1] = (char)('0' + state);
+  trail[n + 2] = ' ';
+  trail[n + 3] = '\0';
+}
+
+static void log_entry(uint32_t state){ log_action('e', state); }
+static void log_exit(uint32_t state){ log_action('x', state); }
+static void log_transition(uint32_t state){ log_action('t', state); }
+
+static const SM_Transition_TypeDef a_on[EV_COUNT] = {
+  [EV_OUT] = { B, log_transition },
+  [EV_INT] = { SM_NONE, log_transition },
+};
+static const SM_Transition_TypeDef a1_on[EV_COUNT] = {
+  [EV_NEXT] = { A2, NULL },
+  [EV_SELF] = { A1, NULL },
+};
+static const SM_Transition_TypeDef b_on[EV_COUNT] = {
+  [EV_OUT] = { A1, NULL },
+};
+
+static const SM_State_TypeDef nested_states[] = {
+  [A - 1]  = { SM_NONE, log_entry, log_exit, a_on },
+  [A1 - 1] = { A,       log_entry, log_exit, a1_on },
+  [A2 - 1] = { A,       log_entry, log_exit, NULL },
+  [B - 1]  = { SM_NONE, log_entry, log_exit, b_on },
+};
+
+static const SM_Table_TypeDef nested_table = { nested_states, 4, EV_COUNT, A1 };
+
+static void dispatch(SM_Machine_TypeDef *sm, uint32_t event){
+  trail[0] = '\0';
+  sm_dispatch(sm, event);
+}
+
+static void test_nesting(void){
+  SM_Machine_TypeDef sm;
+
+  trail[0] = '\0';
+  sm_open(&sm, &nested_table);
+  CHECK(!strcmp(trail, "e1 e2 "));              // outermost first
+
+  dispatch(&sm, EV_NEXT);                       // sibling, A stays entered
+  CHECK(!strcmp(trail, "x2 e3 "));
+
+  dispatch(&sm, EV_INT);                        // handled by A, no exits or entries
+  CHECK(!strcmp(trail, "t3 "));
+  CHECK_EQ(sm_state(&sm), A2);
+
+  dispatch(&sm, EV_OUT);                        // handled by the parent, action between
+  CHECK(!strcmp(trail, "x3 x1 t1 e4 "));
+  CHECK_EQ(sm_state(&sm), B);
+
+  dispatch(&sm, EV_OUT);
+  CHECK(!strcmp(trail, "x4 e1 e2 "));
+
+  dispatch(&sm, EV_SELF);                       // to itself exits and re-enters
+  CHECK(!strcmp(trail, "x2 e2 "));
+  CHECK_EQ(sm_state(&sm), A1);
+}
+
+int main(void){
+  test_counter();
+  test_nesting();
+  return test_done("sm");
+}
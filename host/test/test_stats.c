@@ -0,0 +1,102 @@
+/**
+ * @file test_stats.c
+ *
+ * @brief
+ *  Windowed statistics: tumbling and sliding windows, and a window change
+ *
+ */
+
+#include "test.h"
+#include "host.h"
+#include "stats.h"
+#include "brd_config.h"
+
+static void open_stats(uint32_t window, uint32_t hop){
+  STATS_Open_TypeDef s;
+
+  s.window = window;
+  s.hop = hop;
+  s.cb = STATS_CB;
+  stats_open(&s);
+  remove_scheduled_event(STATS_CB);
+}
+
+// feeds one sample, returns whether a summary was posted
+static bool feed(uint32_t raw){
+  remove_scheduled_event(STATS_CB);
+  stats_update(raw);
+  return get_scheduled_events() & STATS_CB;
+}
+
+static void check_summary(uint32_t seq, uint32_t count, uint32_t min, uint32_t max, uint32_t mean,
+                          uint32_t variance){
+  STATS_Summary_TypeDef s;
+
+  stats_get_summary(&s);
+  CHECK_EQ(s.seq, seq);
+  CHECK_EQ(s.count, count);
+  CHECK_EQ(s.min, min);
+  CHECK_EQ(s.max, max);
+  CHECK_EQ(s.mean, mean);
+  CHECK_EQ(s.variance, variance);
+}
+
+static void test_tumbling(void){
+  open_stats(4, 4);
+
+  CHECK(!feed(10));
+  CHECK(!feed(20));
+  CHECK(!feed(30));
+  CHECK(feed(40));
+  check_summary(1, 4, 10, 40, 25, 125);
+
+  // the next window starts empty
+  CHECK(!feed(1000));
+  CHECK(!feed(1000));
+  CHECK(!feed(1000));
+  CHECK(feed(1000));
+  check_summary(2, 4, 1000, 1000, 1000, 0);
+}
+
+static void test_sliding(void){
+  open_stats(4, 2);
+
+  CHECK(!feed(10));
+  CHECK(!feed(20));                             // one hop is not a whole window
+  CHECK(!feed(30));
+  CHECK(feed(40));
+  check_summary(1, 4, 10, 40, 25, 125);
+
+  // every hop from now on, over the last four samples
+  CHECK(!feed(50));
+  CHECK(feed(60));
+  check_summary(2, 4, 30, 60, 45, 125);
+  CHECK(!feed(60));
+  CHECK(feed(60));
+  check_summary(3, 4, 50, 60, 58, 18);        // 57.5 rounds, 18.75 truncates
+}
+
+static void test_set_window(void){
+  open_stats(4, 4);
+  for(uint32_t i = 0; i < 8; i++){
+      feed(100);
+  }
+  check_summary(2, 4, 100, 100, 100, 0);
+
+  // the window being built restarts at the new length, seq carries on
+  feed(7);
+  stats_set_window(2, 2);
+  CHECK(!feed(200));
+  CHECK(feed(300));
+  check_summary(3, 2, 200, 300, 250, 2500);
+}
+
+int main(void){
+  host_reset();
+  scheduler_open();
+
+  test_tumbling();
+  test_sliding();
+  test_set_window();
+  return test_done("stats");
+}
@@ -0,0 +1,71 @@
+/**
+ * @file alarm.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for alarm
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_ALARM_H_
+#define SRC_HEADER_FILES_ALARM_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+#include "scheduler.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define ALARM_MAX_THRESHOLDS    8u      // one state bit per threshold
+#define ALARM_NONE              0u
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef enum{
+  ALARM_LEVEL,              // compare the raw reading
+  ALARM_RATE                // compare the change in raw reading since the last sample
+} tALARM_SOURCE;
+
+typedef struct{
+  tALARM_SOURCE source;     // what the threshold is compared against
+  bool rising;              // true: active at or above set, false: at or below set
+  int32_t set;              // raw units at which the alarm becomes active
+  int32_t clear;            // raw units at which it becomes inactive (hysteresis)
+  uint8_t dwell;            // consecutive samples past set/clear before changing state
+} ALARM_Threshold_TypeDef;
+
+typedef struct{
+  uint32_t num_thresholds;                                // thresholds in use
+  ALARM_Threshold_TypeDef threshold[ALARM_MAX_THRESHOLDS];
+  uint32_t cb;                                            // event posted on a state change (unique for scheduler)
+} ALARM_Open_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void alarm_open(ALARM_Open_TypeDef *alarm_open);
+
+void alarm_set_threshold(uint32_t index, int32_t set, int32_t clear);
+
+void alarm_update(uint32_t raw);
+
+uint32_t alarm_get_state(void);
+
+uint32_t alarm_get_changed(void);
+
+#endif /* SRC_HEADER_FILES_ALARM_H_ */
@@ -23,18 +23,85 @@
 #include "gpio.h"
 #include "letimer.h"
 #include "si7021.h"
+#include "sensor.h"
+#include "alarm.h"
+#include "stats.h"
+#include "history.h"
+#include "flash_log.h"
+#include "codec.h"
+#include "leuart.h"
+#include "telemetry.h"
+#include "shell.h"
+#include "sm.h"
+#include "prof.h"
+#include "mem.h"
+#include "trace.h"
+#include "report.h"
+#include "filter.h"
 //***********************************************************************************
 // global variables
 //***********************************************************************************
 
 //#define APP_BTN0_CB 0b0001
 //#define APP_BTN1_CB 0b0010
-#define PRESS       1
-#define NONE        0
-#define TWICE       2
 
 #define AMBIENT_TEMP  26u       // temperature in degrees C
 
+#define CENTI(degrees)      ((int32_t)((degrees) * 100))    // degrees C to the centi-degrees the sensor registry takes
+
+// Alarm thresholds
+#define TEMP_ALARM_HYST     0.5     // alarm clears this far below AMBIENT_TEMP (degrees C)
+#define TEMP_ALARM_DWELL    2u      // samples past a threshold before the alarm changes
+#define TEMP_RATE_SET       5.0     // rise per minute that trips the rate alarm (degrees C)
+#define TEMP_RATE_CLEAR     1.0     // rise per minute that clears the rate alarm (degrees C)
+#define TEMP_RATE_DWELL     3u      // samples past the rate threshold before it changes
+
+#define TEMP_ALARM_BIT      0b01    // alarm_get_state() bit for the AMBIENT_TEMP threshold
+#define TEMP_RATE_BIT       0b10    // alarm_get_state() bit for the rate threshold
+
+// Summary statistics windows. Whole minutes, so they are a whole number of
+// samples at every period the shell accepts.
+#define STATS_WINDOW_S      60u     // seconds per summary
+#define STATS_HOP_S         60u     // seconds between summaries, < STATS_WINDOW_S for a sliding window
+
+#define MS_PER_MIN          60000u
+
+#define LATENCY_WINDOW      1024u   // dispatches per worst case latency window
+
+// Noise filter between the Si7021 and every consumer
+#define FILTER_BURST        1u      // readings taken back to back per sample
+#define FILTER_MEDIAN       true    // median of the last three samples
+#define FILTER_EMA_SHIFT    1u      // EMA weight 1 / 2^shift, 0 for none
+
+// Send-on-delta filter in front of the flash log and the telemetry samples
+#define REPORT_DELTA        0.1     // change that is reported (degrees C)
+#define REPORT_HEARTBEAT_S  60u     // seconds between reports of a steady reading, whole minutes
+
+#define TELEMETRY_SAMPLES_PER_FRAME   4u    // samples batched per telemetry frame
+
+// Shell commands, the binary id is also the id in every reply
+#define SHELL_CMD_PERIOD      1u      // "period <ms>", sample period, must divide a minute
+#define SHELL_CMD_ALARM       2u      // "alarm <centi-degrees C>", level alarm threshold
+#define SHELL_CMD_RES         3u      // "res <bits>", Si7021 temperature resolution
+#define SHELL_CMD_SLEEP       4u      // "sleep <EM>", deepest energy mode allowed
+#define SHELL_CMD_DELTA       5u      // "delta <centi-degrees C>", send-on-delta threshold
+#define SHELL_CMD_BURST       6u      // "burst <readings>", readings averaged per sample
+#define SHELL_CMD_MEDIAN      7u      // "median <0|1>", median of 3 spike rejection
+#define SHELL_CMD_EMA         8u      // "ema <shift>", EMA weight 1 / 2^shift, 0 for none
+
+#define SHELL_PERIOD_MIN      2000    // ms, must exceed PWM_ALARM_ACT_PER
+#define SHELL_PERIOD_MAX      60000   // ms, COMP0 is 16 bits at LETIMER_HZ
+#define SHELL_ALARM_MIN       -4000   // centi-degrees C, Si7021 operating range
+#define SHELL_ALARM_MAX       12500
+#define SHELL_RES_MIN         11      // temperature bits
+#define SHELL_RES_MAX         14
+#define SHELL_DELTA_MIN       0       // centi-degrees C, 0 reports every change
+#define SHELL_DELTA_MAX       1000
+#define SHELL_BURST_MIN       1
+#define SHELL_BURST_MAX       FILTER_MAX_BURST
+#define SHELL_EMA_MIN         0
+#define SHELL_EMA_MAX         FILTER_MAX_EMA_SHIFT
+
 /*
 // Application scheduled events (Bits 0-4 are covered in the brd_config for the state machine)
 #define LETIMER0_COMP0_CB 0b00100000
@@ -44,11 +111,43 @@
 
 #define PWM_PER 3.0          // PWM period (s)
 #define PWM_ACT_PER 0.025    // PWM active period (s)
-
-
-// TODO
-#define OUT0_ROUTE _LETIMER_ROUTELOC0_OUT0LOC_LOC29
-#define OUT1_ROUTE _LETIMER_ROUTELOC0_OUT1LOC_LOC27
+#define PWM_ALARM_ACT_PER 1.5   // PWM active period while in alarm (s)
+
+
+#define OUT0_ROUTE _LETIMER_ROUTELOC0_OUT0LOC_LOC29   // PF5, LED1
+#define OUT1_ROUTE _LETIMER_ROUTELOC0_OUT1LOC_LOC27   // PF4, LED0
+
+// LETIMER set up checked at compile time, GCC folds the floating point periods
+_Static_assert(PWM_PER * LETIMER_HZ <= LETIMER_COMP_MAX, "PWM_PER overflows COMP0");
+_Static_assert(SHELL_PERIOD_MAX / 1000u * LETIMER_HZ <= LETIMER_COMP_MAX, "SHELL_PERIOD_MAX overflows COMP0");
+_Static_assert(PWM_ACT_PER < PWM_PER && PWM_ALARM_ACT_PER < PWM_PER, "active period must fit in PWM_PER");
+_Static_assert(SHELL_PERIOD_MIN / 1000.0 > PWM_ALARM_ACT_PER, "SHELL_PERIOD_MIN must exceed PWM_ALARM_ACT_PER");
+_Static_assert(MS_PER_MIN % (uint32_t)(PWM_PER * 1000) == 0, "PWM_PER must divide a minute");
+_Static_assert(STATS_WINDOW_S % 60u == 0 && STATS_HOP_S % 60u == 0 && REPORT_HEARTBEAT_S % 60u == 0,
+               "sample counted settings must be whole minutes");
+_Static_assert(BRD_LOC_PIN(OUT0_ROUTE) == BRD_PIN(LED1_PORT, LED1_PIN), "OUT0_ROUTE does not route to LED1");
+_Static_assert(BRD_LOC2_PIN(OUT1_ROUTE) == BRD_PIN(LED0_PORT, LED0_PIN), "OUT1_ROUTE does not route to LED0");
+
+// LED status patterns, generated by the LETIMER outputs without CPU wakeups.
+// The LED pins are only ever driven through the LETIMER routes, the routed
+// outputs override the pin writes of the counter machine's entry action.
+typedef enum {
+  LED_STATUS_OFF,
+  LED_STATUS_NORMAL,
+  LED_STATUS_ALARM,
+  LED_STATUS_LOW_BATTERY,
+  LED_STATUS_COUNT
+} tLED_STATUS;
+
+// Events delivered to the application state machines
+typedef enum {
+  APP_EV_BTN0,
+  APP_EV_BTN1,
+  APP_EVENTS
+} tAPP_EVENT;
+
+// ONE/TWO/THREE counter machine, bench_sm times its dispatch
+extern const SM_Table_TypeDef app_count_table;
 
 
 //***********************************************************************************
@@ -56,11 +155,7 @@
 //***********************************************************************************
 void app_peripheral_setup(void);
 
-void scheduled_gpio_even_irq_cb(void);
-
-void scheduled_gpio_odd_irq_cb(void);
-
-void app_state_machine(void);
+void app_set_led_status(tLED_STATUS status);
 
 void scheduled_record_button_press_cb(uint32_t button);
 
@@ -70,6 +165,20 @@ void scheduled_letimer_comp1_cb(void);
 
 void scheduled_letimer_uf_cb(void);
 
-void scheduled_read_i2c_cb(void);
+void scheduled_sensor_sample_cb(void);
+
+void scheduled_alarm_cb(void);
+
+void scheduled_stats_cb(void);
+
+void scheduled_flash_log_cb(void);
+
+void scheduled_telemetry_tx_cb(void);
+
+void scheduled_shell_rx_cb(void);
+
+void scheduled_sensor_step_cb(void);
+
+void scheduled_sensor_error_cb(void);
 
 #endif
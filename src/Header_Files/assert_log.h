@@ -0,0 +1,110 @@
+/**
+ * @file assert_log.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for assert_log, assertion tiers and the retained failure log
+ *
+ * @details
+ *  Checks on the interrupt paths go through a per module macro whose tier is
+ *  fixed at compile time:
+ *   - ASSERT_TIER_DEBUG, EFM_ASSERT(), halts with DEBUG_EFM
+ *   - ASSERT_TIER_CHEAP, the expression is evaluated and a failure is logged
+ *     to retained RAM with assert_log(), execution carries on
+ *   - ASSERT_TIER_OFF, the expression is not evaluated at all
+ *
+ *  With DEBUG_EFM every module defaults to the debug tier. Otherwise checks
+ *  that only read back an interrupt flag the handler just cleared (all of
+ *  LETIMER and GPIO, I2C_IF_ASSERT in the I2C handlers) default to off, and
+ *  the I2C state machine and the sleep counters to cheap. Any of them can be
+ *  overridden from the build, e.g. -DI2C_ASSERT_TIER=ASSERT_TIER_OFF.
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_ASSERT_LOG_H_
+#define SRC_HEADER_FILES_ASSERT_LOG_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+#include "brd_config.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define ASSERT_TIER_OFF         0u
+#define ASSERT_TIER_CHEAP       1u
+#define ASSERT_TIER_DEBUG       2u
+
+#if defined(DEBUG_EFM) || defined(DEBUG_EFM_USER)
+#define ASSERT_TIER_LOGIC       ASSERT_TIER_DEBUG
+#define ASSERT_TIER_READBACK    ASSERT_TIER_DEBUG
+#else
+#define ASSERT_TIER_LOGIC       ASSERT_TIER_CHEAP     // default for state and count checks
+#define ASSERT_TIER_READBACK    ASSERT_TIER_OFF       // default for flag read backs only
+#endif
+
+#ifndef I2C_ASSERT_TIER
+#define I2C_ASSERT_TIER         ASSERT_TIER_LOGIC
+#endif
+#ifndef I2C_IF_ASSERT_TIER
+#define I2C_IF_ASSERT_TIER      ASSERT_TIER_READBACK
+#endif
+#ifndef LETIMER_ASSERT_TIER
+#define LETIMER_ASSERT_TIER     ASSERT_TIER_READBACK
+#endif
+#ifndef GPIO_ASSERT_TIER
+#define GPIO_ASSERT_TIER        ASSERT_TIER_READBACK
+#endif
+#ifndef SLEEP_ASSERT_TIER
+#define SLEEP_ASSERT_TIER       ASSERT_TIER_LOGIC
+#endif
+
+// tier is a constant, so only the selected branch is compiled in
+#define TIERED_ASSERT(tier, expr)                                               \
+  ((tier) >= ASSERT_TIER_DEBUG ? EFM_ASSERT(expr) :                             \
+   (tier) >= ASSERT_TIER_CHEAP ? ((expr) ? (void)0 : assert_log(__FILE__, __LINE__)) : \
+   (void)0)
+
+#define I2C_ASSERT(expr)        TIERED_ASSERT(I2C_ASSERT_TIER, expr)
+#define I2C_IF_ASSERT(expr)     TIERED_ASSERT(I2C_IF_ASSERT_TIER, expr)
+#define LETIMER_ASSERT(expr)    TIERED_ASSERT(LETIMER_ASSERT_TIER, expr)
+#define GPIO_ASSERT(expr)       TIERED_ASSERT(GPIO_ASSERT_TIER, expr)
+#define SLEEP_ASSERT(expr)      TIERED_ASSERT(SLEEP_ASSERT_TIER, expr)
+
+#define ASSERT_LOG_ENTRIES      8u          // most recent failures kept
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  const char *file;                         // in flash, valid while the image is unchanged
+  uint32_t line;
+} ASSERT_LOG_Entry_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void assert_log_open(void);
+
+void assert_log(const char *file, int line);
+
+uint32_t assert_log_count(void);
+
+bool assert_log_get(uint32_t age, ASSERT_LOG_Entry_TypeDef *entry);
+
+void assert_log_clear(void);
+
+#endif /* SRC_HEADER_FILES_ASSERT_LOG_H_ */
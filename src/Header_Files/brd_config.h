@@ -22,6 +22,7 @@
 //***********************************************************************************
 #include "em_gpio.h"
 #include "em_cmu.h"
+#include "em_ramfunc.h"
 
 //***********************************************************************************
 // defined files
@@ -75,18 +76,69 @@
 #define SI7021_SENSOR_EN_MODE   gpioModePushPull
 #define SI7021_SENSOR_EN_OUT    1u
 
-#define GPIO_EVEN_IRQ_CB      0b000000001
-#define GPIO_ODD_IRQ_CB       0b000000010
+#define SI7021_SDA_LOC          15u         // PC10
+#define SI7021_SCL_LOC          15u         // PC11
+#define SI7021_SDA_ROUTE        (SI7021_SDA_LOC << _I2C_ROUTELOC0_SDALOC_SHIFT)
+#define SI7021_SCL_ROUTE        (SI7021_SCL_LOC << _I2C_ROUTELOC0_SCLLOC_SHIFT)
+
+// LEUART0 telemetry, expansion header pins 12 (TX) and 14 (RX)
+#define LEUART0_TX_PORT         gpioPortD
+#define LEUART0_TX_PIN          10u
+#define LEUART0_TX_MODE         gpioModePushPull
+#define LEUART0_TX_DEFAULT      1u          // idle high
+#define LEUART0_RX_PORT         gpioPortD
+#define LEUART0_RX_PIN          11u
+#define LEUART0_RX_MODE         gpioModeInput
+#define LEUART0_RX_DEFAULT      1u
+#define LEUART0_TX_LOC          18u
+#define LEUART0_RX_LOC          18u
+#define LEUART0_TX_ROUTE        (LEUART0_TX_LOC << _LEUART_ROUTELOC0_TXLOC_SHIFT)
+#define LEUART0_RX_ROUTE        (LEUART0_RX_LOC << _LEUART_ROUTELOC0_RXLOC_SHIFT)
+#define LEUART0_BAUD            9600u
+
 #define APP_BTN0_CB           0b000000100
 #define APP_BTN1_CB           0b000001000
-#define APP_CHK_INPUT_CB      0b000010000
 #define LETIMER_COMP0_IRQ_CB  0b000100000
 #define LETIMER_COMP1_IRQ_CB  0b001000000
 #define LETIMER_UF_IRQ_CB     0b010000000
-#define SI7021_TEMP_READ_CB   0b100000000
+#define SENSOR_SAMPLE_CB      0b100000000
+#define ALARM_CB              0b1000000000
+#define STATS_CB              0b10000000000
+#define FLASH_LOG_CB          0b100000000000
+#define TELEMETRY_TX_CB       0b1000000000000
+#define SHELL_RX_CB           0b10000000000000
+#define SENSOR_STEP_CB        0b100000000000000
+#define SENSOR_ERROR_CB       0b1000000000000000
 
 #define MCU_HFXO_FREQ			cmuHFRCOFreq_26M0Hz
 
+// Hot paths, the interrupt handlers and the main loop dispatch, run from RAM
+// when RAM_HOT_PATHS is defined. The stock GCC linker script copies the .ram
+// section SL_RAMFUNC_DECLARATOR uses along with .data at startup.
+//#define RAM_HOT_PATHS
+
+#ifdef RAM_HOT_PATHS
+	#define HOT_PATH				SL_RAMFUNC_DECLARATOR
+#else
+	#define HOT_PATH
+#endif
+
+// Variables kept across resets. Startup must leave .noinit alone, the linker
+// script needs it as a NOLOAD output section placed in RAM:
+//   .noinit (NOLOAD) : { *(.noinit*) } > RAM
+#define RETAINED				__attribute__((section(".noinit")))
+
+// Route locations to pins. The first signal of a pair (LETIMER OUT0, I2C SDA,
+// LEUART TX) runs through PA0-5, PB11-15, PC6-11, PD9-15, PF0-7 as the
+// location goes from 0 to 31, the second (OUT1, SCL, RX) one location ahead.
+#define BRD_PIN(port, pin)      ((uint32_t)(port) * 16u + (pin))
+#define BRD_LOC_PIN(loc)        ((loc) < 6u  ? BRD_PIN(gpioPortA, (loc)) :       \
+                                 (loc) < 11u ? BRD_PIN(gpioPortB, (loc) + 5u) :  \
+                                 (loc) < 17u ? BRD_PIN(gpioPortC, (loc) - 5u) :  \
+                                 (loc) < 24u ? BRD_PIN(gpioPortD, (loc) - 8u) :  \
+                                               BRD_PIN(gpioPortF, (loc) - 24u))
+#define BRD_LOC2_PIN(loc)       BRD_LOC_PIN(((loc) + 1u) % 32u)
+
 // GPIO pin setup
 #define STRONG_DRIVE
 
@@ -103,6 +155,45 @@
 #endif
 
 
+//***********************************************************************************
+// compile time checks
+//***********************************************************************************
+
+#define BRD_EVENTS(op)          (APP_BTN0_CB op APP_BTN1_CB op LETIMER_COMP0_IRQ_CB op     \
+                                 LETIMER_COMP1_IRQ_CB op LETIMER_UF_IRQ_CB op            \
+                                 SENSOR_SAMPLE_CB op ALARM_CB op STATS_CB op             \
+                                 FLASH_LOG_CB op TELEMETRY_TX_CB op SHELL_RX_CB op       \
+                                 SENSOR_STEP_CB op SENSOR_ERROR_CB)
+
+_Static_assert(BRD_EVENTS(+) == BRD_EVENTS(|), "two scheduler events share a bit");
+
+// pins of port p owned by a function, each pin once, LED0/1 are shared with
+// the LETIMER outputs on purpose
+#define BRD_PIN_BIT(port, pin, p)   ((port) == (p) ? 1u << (pin) : 0u)
+#define BRD_PINS(op, p)         (BRD_PIN_BIT(LED0_PORT, LED0_PIN, p) op                 \
+                                 BRD_PIN_BIT(LED1_PORT, LED1_PIN, p) op                 \
+                                 BRD_PIN_BIT(BUT0_PORT, BUT0_PIN, p) op                 \
+                                 BRD_PIN_BIT(BUT1_PORT, BUT1_PIN, p) op                 \
+                                 BRD_PIN_BIT(SI7021_SCL_PORT, SI7021_SCL_PIN, p) op     \
+                                 BRD_PIN_BIT(SI7021_SDA_PORT, SI7021_SDA_PIN, p) op     \
+                                 BRD_PIN_BIT(SI7021_SENSOR_EN_PORT, SI7021_SENSOR_EN_PIN, p) op \
+                                 BRD_PIN_BIT(LEUART0_TX_PORT, LEUART0_TX_PIN, p) op     \
+                                 BRD_PIN_BIT(LEUART0_RX_PORT, LEUART0_RX_PIN, p))
+#define BRD_PINS_UNIQUE(p)      (BRD_PINS(+, p) == BRD_PINS(|, p))
+
+_Static_assert(BRD_PINS_UNIQUE(gpioPortA) && BRD_PINS_UNIQUE(gpioPortB) &&
+               BRD_PINS_UNIQUE(gpioPortC) && BRD_PINS_UNIQUE(gpioPortD) &&
+               BRD_PINS_UNIQUE(gpioPortF), "two functions share a pin");
+
+_Static_assert(BRD_LOC_PIN(SI7021_SDA_LOC) == BRD_PIN(SI7021_SDA_PORT, SI7021_SDA_PIN),
+               "SI7021_SDA_LOC does not route to the SDA pin");
+_Static_assert(BRD_LOC2_PIN(SI7021_SCL_LOC) == BRD_PIN(SI7021_SCL_PORT, SI7021_SCL_PIN),
+               "SI7021_SCL_LOC does not route to the SCL pin");
+_Static_assert(BRD_LOC_PIN(LEUART0_TX_LOC) == BRD_PIN(LEUART0_TX_PORT, LEUART0_TX_PIN),
+               "LEUART0_TX_LOC does not route to the TX pin");
+_Static_assert(BRD_LOC2_PIN(LEUART0_RX_LOC) == BRD_PIN(LEUART0_RX_PORT, LEUART0_RX_PIN),
+               "LEUART0_RX_LOC does not route to the RX pin");
+
 //***********************************************************************************
 // global variables
 //***********************************************************************************
@@ -0,0 +1,60 @@
+/**
+ * @file codec.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for codec
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_CODEC_H_
+#define SRC_HEADER_FILES_CODEC_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define CODEC_KEYFRAME_INTERVAL   64u     // samples between keyframes
+#define CODEC_MAX_BYTES           3u      // longest encoded sample (a 16 bit keyframe)
+
+#define CODEC_VARINT_MORE         0x80u   // continuation bit of each varint byte
+#define CODEC_VARINT_BITS         7u
+#define CODEC_TAG_KEYFRAME        1u      // bit 0 of the varint value: 1 keyframe, 0 delta
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// One per encoded stream, and one per stream being decoded
+typedef struct{
+  uint16_t prev;            // last sample, the reference for the next delta
+  uint16_t since_key;       // samples since the last keyframe
+  uint16_t interval;        // samples between keyframes
+  bool synced;              // a keyframe has been seen (decoder) / sent (encoder)
+} CODEC_State_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void codec_init(CODEC_State_TypeDef *codec, uint32_t keyframe_interval);
+
+void codec_keyframe(CODEC_State_TypeDef *codec);
+
+uint32_t codec_encode(CODEC_State_TypeDef *codec, uint32_t raw, uint8_t *out);
+
+uint32_t codec_decode(CODEC_State_TypeDef *codec, const uint8_t *in, uint32_t len, uint16_t *raw);
+
+#endif /* SRC_HEADER_FILES_CODEC_H_ */
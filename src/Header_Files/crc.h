@@ -0,0 +1,36 @@
+/**
+ * @file crc.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for crc
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_CRC_H_
+#define SRC_HEADER_FILES_CRC_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define CRC16_INIT      0xFFFFu     // CRC-16/CCITT-FALSE seed
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t len);
+
+#endif /* SRC_HEADER_FILES_CRC_H_ */
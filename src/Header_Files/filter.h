@@ -0,0 +1,55 @@
+/**
+ * @file filter.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for filter, burst averaging, median of 3 and EMA of the
+ *  sensor readings
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_FILTER_H_
+#define SRC_HEADER_FILES_FILTER_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define FILTER_MAX_BURST      16u         // keeps the burst sum of 16 bit readings in 20 bits
+#define FILTER_MAX_EMA_SHIFT  8u
+#define FILTER_EMA_FRAC       8u          // fractional bits of the EMA state
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t burst;           // readings averaged into each sample, 1 for none
+  bool median;              // output the median of the last three samples
+  uint32_t ema_shift;       // EMA weight of a new sample 1 / 2^ema_shift, 0 for none
+} FILTER_Open_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void filter_open(FILTER_Open_TypeDef *filter_open);
+
+bool filter_add(uint32_t raw);
+
+uint32_t filter_get(void);
+
+#endif /* SRC_HEADER_FILES_FILTER_H_ */
@@ -0,0 +1,105 @@
+/**
+ * @file flash_log.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for flash_log
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_FLASH_LOG_H_
+#define SRC_HEADER_FILES_FLASH_LOG_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_msc.h"
+#include "crc.h"
+#include "scheduler.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+// Log region: the last FLASH_LOG_PAGES pages of main flash, used round robin.
+// The linker script has to keep the image out of it, so a growing image
+// fails the link instead of being erased by the log:
+//   FLASH (rx) : ORIGIN = 0x00000000, LENGTH = 0x100000 - 16 * 2048
+#define FLASH_LOG_PAGES         16u
+#define FLASH_LOG_START         (FLASH_BASE + FLASH_SIZE - FLASH_LOG_PAGES * FLASH_PAGE_SIZE)
+
+// End of the image in flash from the GCC linker script, unless the build
+// supplies its own (the host build does, in em_device.h). The .data load
+// image, .ram functions included, follows .text.
+#ifndef FLASH_LOG_IMAGE_END
+extern uint32_t __etext[];
+extern uint32_t __data_start__[];
+extern uint32_t __data_end__[];
+#define FLASH_LOG_IMAGE_END     ((uintptr_t)__etext + ((uintptr_t)__data_end__ - (uintptr_t)__data_start__))
+#endif
+
+#define FLASH_LOG_MAGIC         0x31474F4Cu   // "LOG1", written last to commit a page
+#define FLASH_LOG_ERASED        0xFFFFFFFFu
+#define FLASH_LOG_CHUNK         256u          // bytes programmed per scheduler pass
+
+#define FLASH_LOG_HEADER_SIZE   sizeof(FLASH_LOG_Header_TypeDef)
+#define FLASH_LOG_PAYLOAD_SIZE  (FLASH_PAGE_SIZE - FLASH_LOG_HEADER_SIZE)
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// Start of every committed page. The payload is written before the header and
+// magic is the last word written, so a page torn by a reset is never valid.
+typedef struct{
+  uint32_t magic;           // FLASH_LOG_MAGIC once the page is complete
+  uint32_t seq;             // commit number, the highest valid one is the newest page
+  uint32_t first_record;    // records logged before this page
+  uint16_t records;         // records in this page
+  uint16_t length;          // payload bytes
+  uint16_t crc;             // crc16 of the payload
+  uint16_t reserved;
+} FLASH_LOG_Header_TypeDef;
+
+// Counters for write amplification and energy per stored record. Energy per
+// record is erases and programmed words times the datasheet page erase and
+// word write energy, divided by records.
+typedef struct{
+  uint32_t records;             // records accepted
+  uint32_t dropped;             // records lost because both page buffers were busy
+  uint32_t payload_bytes;       // record bytes accepted
+  uint32_t pages;               // pages committed
+  uint32_t erases;              // page erases
+  uint32_t programmed_bytes;    // bytes written to flash, headers included
+} FLASH_LOG_Stats_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void flash_log_open(uint32_t cb);
+
+bool flash_log_write(const void *record, uint32_t len);
+
+void flash_log_flush(void);
+
+uint32_t flash_log_space(void);
+
+void flash_log_commit(void);
+
+bool flash_log_read(uint32_t age, const FLASH_LOG_Header_TypeDef **header, const uint8_t **payload);
+
+void flash_log_get_stats(FLASH_LOG_Stats_TypeDef *stats);
+
+#endif /* SRC_HEADER_FILES_FLASH_LOG_H_ */
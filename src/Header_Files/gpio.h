@@ -21,7 +21,10 @@
 #include "em_gpio.h"
 #include "brd_config.h"
 #include "em_assert.h"
+#include "em_common.h"
 #include "scheduler.h"
+#include "prof.h"
+#include "assert_log.h"
 
 //***********************************************************************************
 // defined files
@@ -33,8 +36,9 @@
 //***********************************************************************************
 
 //#define GPIO_TEST_BIT_MASK        0x1000
-#define GPIO_ODD_INT_PIN_7_MASK   0b010000000
-#define GPIO_EVEN_INT_PIN_6_MASK  0b001000000
+#define GPIO_EXTI_LINES           16u
+#define GPIO_EXTI_EVEN_MASK       0x5555u     // EXTI lines 0, 2, ... 14
+#define GPIO_EXTI_ODD_MASK        0xAAAAu     // EXTI lines 1, 3, ... 15
 
 typedef struct {
   bool      enable;           // enable the GPIO upon completion of open
@@ -46,6 +50,8 @@ typedef struct {
   bool      btn1_en;          // enable btn1 port/pins
   bool      btn0_irq_enable;  // enable interrupt on btn0 interrupt
   bool      btn1_irq_enable;  // enable interrupt on btn0 interrupt
+  uint32_t  btn0_cb;          // btn0 callback (unique for scheduler)
+  uint32_t  btn1_cb;          // btn1 callback (unique for scheduler)
 } GAME_GPIO_TypeDef;
 
 //***********************************************************************************
@@ -53,4 +59,6 @@ typedef struct {
 //***********************************************************************************
 void gpio_open(GAME_GPIO_TypeDef* game_gpio);
 
+void gpio_exti_open(GPIO_Port_TypeDef port, uint32_t pin, bool rising, bool falling, uint32_t cb);
+
 #endif
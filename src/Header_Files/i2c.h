@@ -24,6 +24,9 @@
 #include "em_i2c.h"
 #include "scheduler.h"
 #include "sleep_routines.h"
+#include "prof.h"
+#include "assert_log.h"
+#include "trace.h"
 
 //***********************************************************************************
 // Defined files
@@ -35,10 +38,12 @@
 #define INTERRUPT_DISABLE 0
 #define I2C_ADDRESS_SHIFT 1u
 #define I2C_EM_BLOCK      EM2
+#define I2C_INSTANCES     2u            // I2C0 and I2C1
 
 #define BUFFER_OFFSET      8u
 
 #define Si7021_READ_TEMP_CMD    0x0F3U
+#define Si7021_WRITE_USER_REG1  0x0E6U
 
 
 //***********************************************************************************
@@ -50,6 +55,7 @@ typedef enum{
   I2C_RX_SEND_CMD,
   I2C_RX_SEND_ADDR,
   I2C_RX_RECEIVE_DATA,
+  I2C_TX_SEND_DATA,
   I2C_CLOSE
 } tI2C_STATES;
 
@@ -81,7 +87,9 @@ typedef struct{
   uint32_t i2c_register_address;
   uint32_t *i2c_data;
   tI2C_CMD i2c_cmd;
+  tI2C_CMD i2c_direction;           // READ data back, or WRITE i2c_data after device_cmd
   uint32_t i2c_cb;
+  uint32_t i2c_err_cb;              // posted instead of i2c_cb when the device refuses a data byte
   uint32_t device_cmd;
 } I2C_StateMachine_TypeDef;
 
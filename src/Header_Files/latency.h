@@ -0,0 +1,73 @@
+/**
+ * @file latency.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for latency, time from posting a scheduler event to its
+ *  dispatch
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_LATENCY_H_
+#define SRC_HEADER_FILES_LATENCY_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+#include "prof.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define LATENCY_MAX_EVENTS    16u         // event bits 0 .. 15 are traced
+#define LATENCY_HIST_BUCKETS  24u         // bucket b counts [2^b, 2^(b+1)) ticks, the last one everything above
+#define LATENCY_RING_SIZE     64u         // trace records kept, power of 2
+
+#define LATENCY_DISPATCH      0x80u       // set in LATENCY_Record_TypeDef.event for a dispatch
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t window;          // dispatches, of any event, per worst case window
+} LATENCY_Open_TypeDef;
+
+typedef struct{
+  uint32_t seq;             // 1 + position in the trace, 0 while being written
+  uint32_t tick;            // prof_now() when the record was made
+  uint8_t event;            // event bit number, | LATENCY_DISPATCH
+} LATENCY_Record_TypeDef;
+
+typedef struct{
+  uint32_t count;           // dispatches
+  uint32_t max;             // ticks, since latency_open()
+  uint32_t window_max;      // ticks, worst of the last complete window
+  uint32_t hist[LATENCY_HIST_BUCKETS];
+} LATENCY_Stats_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void latency_open(LATENCY_Open_TypeDef *latency_open);
+
+void latency_post(uint32_t events);
+
+void latency_dispatch(uint32_t events);
+
+void latency_get(uint32_t bit, LATENCY_Stats_TypeDef *latency_stats);
+
+uint32_t latency_trace(LATENCY_Record_TypeDef *records, uint32_t max);
+
+#endif /* SRC_HEADER_FILES_LATENCY_H_ */
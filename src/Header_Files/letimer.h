@@ -28,12 +28,15 @@
 /* The developer's include statements */
 #include "scheduler.h"
 #include "sleep_routines.h"
+#include "prof.h"
+#include "assert_log.h"
 
 //***********************************************************************************
 // global variables
 //***********************************************************************************
 
 #define LETIMER_HZ 1000u
+#define LETIMER_COMP_MAX 0xFFFFu      // COMP0 and COMP1 are 16 bits
 #define REPEAT_COUNT 1u
 #define LETIMER_EM EM4
 
@@ -57,6 +60,8 @@ typedef struct {
   uint32_t out_pin_route1;      // out 1 route to gpio port/pin
   bool out_pin_0_en;            // enable out 0 route
   bool out_pin_1_en;            // enable out 1 route
+  bool out_pin_0_pol;           // out 0 idle polarity (active is the inverse)
+  bool out_pin_1_pol;           // out 1 idle polarity (active is the inverse)
   float period;                 // total period in seconds
   float active_period;          // part of period that is LLH in seconds
   bool comp0_irq_enable;        // enable interrupt on comp0 interrupt
@@ -73,5 +78,7 @@ typedef struct {
 
 void letimer_pwm_open(LETIMER_TypeDef *letimer, APP_LETIMER_PWM_TypeDef *app_letimer_struct);
 void letimer_start(LETIMER_TypeDef *letimer, bool enable);
+void letimer_pwm_pattern(LETIMER_TypeDef *letimer, float active_period, bool out_pin_0_en, bool out_pin_1_en);
+void letimer_set_period(LETIMER_TypeDef *letimer, float period);
 
 #endif /* SRC_HEADER_FILES_LETIMER_H_ */
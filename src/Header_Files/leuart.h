@@ -0,0 +1,79 @@
+/**
+ * @file leuart.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for leuart
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_LEUART_H_
+#define SRC_HEADER_FILES_LEUART_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+/* Silicon Labs include statements */
+#include "em_assert.h"
+#include "em_cmu.h"
+#include "em_leuart.h"
+#include "em_ldma.h"
+/* The developer's include statements */
+#include "brd_config.h"
+#include "scheduler.h"
+#include "sleep_routines.h"
+#include "prof.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define LEUART_TX_EM          EM3       // LEUART and its DMA wakeup run down to EM2
+#define LEUART_RX_EM          EM3       // LFB and so the receiver stop in EM3
+#define LEUART_TX_DMA_CH      0
+#define LEUART_TEST_BITS      0x55u     // written to STARTFRAME to check the LF clock tree
+#define LEUART_RX_BUFFER      64u       // received bytes waiting for the scheduler, power of 2
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t baudrate;
+  LEUART_Databits_TypeDef databits;
+  LEUART_Enable_TypeDef enable;
+  LEUART_Parity_TypeDef parity;
+  LEUART_Stopbits_TypeDef stopbits;
+  uint32_t refFreq;
+  uint32_t tx_loc;              // tx route to gpio port/pin
+  uint32_t rx_loc;              // rx route to gpio port/pin
+  bool tx_pin_en;               // enable tx route
+  bool rx_pin_en;               // enable rx route
+  uint32_t tx_done_cb;          // posted when a transmit completes (unique for scheduler)
+  bool rx_irq_enable;           // buffer received bytes from the RXDATAV interrupt
+  uint32_t rx_cb;               // posted when bytes are received (unique for scheduler)
+} LEUART_OPEN_STRUCT;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void leuart_open(LEUART_TypeDef *leuart, LEUART_OPEN_STRUCT *leuart_settings);
+
+void leuart_close(LEUART_TypeDef *leuart);
+
+void leuart_tx_dma(LEUART_TypeDef *leuart, const uint8_t *data, uint32_t len);
+
+bool leuart_tx_busy(LEUART_TypeDef *leuart);
+
+bool leuart_rx_read(LEUART_TypeDef *leuart, uint8_t *byte);
+
+uint32_t leuart_rx_overflows(LEUART_TypeDef *leuart);
+
+#endif /* SRC_HEADER_FILES_LEUART_H_ */
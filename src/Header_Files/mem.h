@@ -0,0 +1,64 @@
+/**
+ * @file mem.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for mem, stack high water mark and static RAM footprint
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_MEM_H_
+#define SRC_HEADER_FILES_MEM_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include "em_device.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define MEM_PAINT             0xCDCDCDCDu   // unused stack words hold this
+#define MEM_PAINT_MARGIN      64u           // bytes below mem_paint_stack()'s frame left alone
+
+// Stack and RAM bounds from the GCC linker script, unless the build supplies
+// its own (the host build does, in em_device.h)
+#ifndef MEM_STACK_LIMIT
+extern uint32_t __StackLimit[];
+extern uint32_t __StackTop[];
+extern uint32_t __data_start__[];
+extern uint32_t __bss_end__[];
+#define MEM_STACK_LIMIT       __StackLimit
+#define MEM_STACK_TOP         __StackTop
+#define MEM_STATIC_RAM        ((uint32_t)((uintptr_t)__bss_end__ - (uintptr_t)__data_start__))
+#endif
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t stack_size;          // bytes reserved for the stack
+  uint32_t stack_peak;          // bytes, deepest the stack has been since mem_paint_stack()
+  uint32_t static_ram;          // bytes of .data and .bss
+} MEM_Usage_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void mem_paint_stack(void);
+
+uint32_t mem_stack_peak(void);
+
+void mem_get(MEM_Usage_TypeDef *mem_usage);
+
+#endif /* SRC_HEADER_FILES_MEM_H_ */
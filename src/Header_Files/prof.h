@@ -0,0 +1,170 @@
+/**
+ * @file prof.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for prof, cycle counts of interrupt handlers and callbacks
+ *
+ * @details
+ *  Build with PROF_ENABLE defined to turn the probes on. Without it
+ *  PROF_OPEN(), PROF_BEGIN() and PROF_END() compile to nothing.
+ *
+ *  On the target a tick is one core clock, read from the DWT cycle counter.
+ *  Where there is no DWT (the host build) a tick is one nanosecond of
+ *  CLOCK_MONOTONIC. The tick source is always built, prof_clock_open() starts
+ *  it for users that stay on without PROF_ENABLE. The cycle counter stops
+ *  with the core clock in EM2 and EM3.
+ *
+ *  Each probe also counts instruction cache hits and misses from the MSC
+ *  performance counters, where the device has them (not on the host).
+ *  PROF_SLEEP() and PROF_WAKE() around enter_sleep() in the main loop time
+ *  the wake windows, everything the core runs between two sleeps, under
+ *  PROF_WAKE_WINDOW.
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_PROF_H_
+#define SRC_HEADER_FILES_PROF_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "em_assert.h"
+#include "em_core.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define PROF_HIST_BUCKETS   32u         // bucket b counts durations in [2^b, 2^(b+1)), 0 goes in 0
+#define PROF_OVERHEAD_RUNS  64u         // empty probes timed by prof_open()
+
+#ifdef _MSC_CACHEHITS_MASK
+#define PROF_CACHE_MASK     _MSC_CACHEHITS_MASK     // width of the MSC hit and miss counters
+#endif
+
+#ifdef PROF_ENABLE
+#define PROF_OPEN()         prof_open()
+#define PROF_BEGIN(id)      PROF_Mark_TypeDef prof_start_##id; prof_mark(&prof_start_##id)
+#define PROF_END(id)        prof_record((id), &prof_start_##id)
+#define PROF_SLEEP()        prof_sleep()
+#define PROF_WAKE()         prof_wake()
+#else
+#define PROF_OPEN()         ((void)0)
+#define PROF_BEGIN(id)      ((void)0)
+#define PROF_END(id)        ((void)0)
+#define PROF_SLEEP()        ((void)0)
+#define PROF_WAKE()         ((void)0)
+#endif
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef enum{
+  PROF_I2C0_IRQ,
+  PROF_I2C1_IRQ,
+  PROF_LETIMER0_IRQ,
+  PROF_GPIO_EVEN_IRQ,
+  PROF_GPIO_ODD_IRQ,
+  PROF_APP_BTN0_CB,
+  PROF_APP_BTN1_CB,
+  PROF_LETIMER_COMP0_CB,
+  PROF_LETIMER_COMP1_CB,
+  PROF_LETIMER_UF_CB,
+  PROF_SENSOR_SAMPLE_CB,
+  PROF_ALARM_CB,
+  PROF_STATS_CB,
+  PROF_FLASH_LOG_CB,
+  PROF_TELEMETRY_TX_CB,
+  PROF_SHELL_RX_CB,
+  PROF_SENSOR_STEP_CB,
+  PROF_SENSOR_ERROR_CB,
+  PROF_HISTORY_INSERT,
+  PROF_CODEC_ENCODE,
+  PROF_LEUART0_IRQ,
+  PROF_TELEMETRY_BUILD,
+  PROF_TELEMETRY_SEND,
+  PROF_TELEMETRY_TX_DONE,
+  PROF_WAKE_WINDOW,
+  PROF_NUM_IDS
+} PROF_ID;
+
+typedef struct{
+  uint32_t tick;
+  uint32_t hits;                        // instruction cache counters
+  uint32_t misses;
+} PROF_Mark_TypeDef;
+
+typedef struct{
+  uint32_t count;
+  uint32_t min;                         // ticks
+  uint32_t max;                         // ticks
+  uint32_t mean;                        // ticks, rounded
+  uint64_t total;                       // ticks
+  uint64_t hits;                        // instruction cache hits, 0 without the counters
+  uint64_t misses;                      // instruction cache misses
+  uint32_t hist[PROF_HIST_BUCKETS];
+} PROF_Stats_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void prof_clock_open(void);
+
+void prof_open(void);
+
+void prof_record(PROF_ID id, const PROF_Mark_TypeDef *start);
+
+void prof_sleep(void);
+
+void prof_wake(void);
+
+void prof_get(PROF_ID id, PROF_Stats_TypeDef *stats);
+
+void prof_clear(void);
+
+uint32_t prof_tick_hz(void);
+
+const char *prof_name(PROF_ID id);
+
+#ifdef DWT
+/***************************************************************************//**
+* @brief
+*  Current core cycle count, wraps every 2^32 cycles
+*
+******************************************************************************/
+__STATIC_INLINE uint32_t prof_now(void){
+  return DWT->CYCCNT;
+}
+#else
+uint32_t prof_now(void);
+#endif
+
+/***************************************************************************//**
+* @brief
+*  Take the tick and cache counters at the start of a probe
+*
+******************************************************************************/
+__STATIC_INLINE void prof_mark(PROF_Mark_TypeDef *mark){
+  mark->tick = prof_now();
+#ifdef PROF_CACHE_MASK
+  mark->hits = MSC->CACHEHITS;
+  mark->misses = MSC->CACHEMISSES;
+#else
+  mark->hits = 0;
+  mark->misses = 0;
+#endif
+}
+
+#endif /* SRC_HEADER_FILES_PROF_H_ */
@@ -0,0 +1,55 @@
+/**
+ * @file report.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for report, send-on-delta filtering of the sample stream
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_REPORT_H_
+#define SRC_HEADER_FILES_REPORT_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t delta;           // raw units, forward a sample that moved further than this
+  uint32_t heartbeat;       // samples, forward one at least this often, 0 for never
+} REPORT_Open_TypeDef;
+
+typedef struct{
+  uint32_t samples;         // samples offered since report_open()
+  uint32_t forwarded;       // samples passed on, heartbeats included
+  uint32_t heartbeats;      // samples passed on only because the heartbeat was due
+} REPORT_Stats_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void report_open(REPORT_Open_TypeDef *report_open);
+
+void report_set_delta(uint32_t delta);
+
+void report_set_heartbeat(uint32_t heartbeat);
+
+bool report_filter(uint32_t raw);
+
+void report_get_stats(REPORT_Stats_TypeDef *stats);
+
+#endif /* SRC_HEADER_FILES_REPORT_H_ */
@@ -20,6 +20,8 @@
 #include "em_core.h"
 #include "em_emu.h"
 #include "brd_config.h"
+#include "latency.h"
+#include "trace.h"
 //***********************************************************************************
 // defined files
 //***********************************************************************************
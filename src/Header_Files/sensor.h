@@ -0,0 +1,105 @@
+/**
+ * @file sensor.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for sensor, the driver interface and the registry the
+ *  sampler runs over
+ *
+ * @details
+ *  A driver fills in a SENSOR_Driver_TypeDef and the application registers
+ *  it once with sensor_register(). Every sample then runs in two passes over
+ *  the registry: each sensor's conversion is started, and only then are the
+ *  results collected in the same order. The conversions overlap, so the
+ *  wake window is as long as the slowest conversion instead of the sum of
+ *  all of them.
+ *
+ *  start() and collect() are asynchronous. Each posts the call_back it is
+ *  given once its bus transfer is complete, which moves the sampler on from
+ *  sensor_step(). A collect() issued before the conversion is done has to
+ *  wait it out itself, the Si7021 NACKs its read address until then.
+ *
+ *  Thresholds are set in centi-units and turned into raw readings once with
+ *  sensor_to_raw() or sensor_delta_to_raw(), so the per sample checks stay
+ *  in raw integers whatever the sensor.
+ *
+ *  Settings changed between samples are kept by the driver and written by
+ *  configure(), which the sampler calls on every sensor before starting a
+ *  sample. Nothing else is on the bus then, so a settings write never
+ *  lands in the middle of a conversion.
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_SENSOR_H_
+#define SRC_HEADER_FILES_SENSOR_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+#include "scheduler.h"
+#include "trace.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define SENSOR_MAX            4u
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  void (*open)(void);                       // configure the bus and the device
+  bool (*configure)(uint32_t call_back, uint32_t error_cb);   // write pending settings, false when there are none
+  void (*start)(uint32_t call_back);        // start a conversion
+  void (*collect)(uint32_t call_back);      // read back the conversion result
+  uint32_t (*get_raw)(void);                // result, valid once collect() has posted
+  int32_t (*convert)(uint32_t raw);         // raw reading to centi-units (centi-degrees C)
+  int32_t (*to_raw)(int32_t centi);         // centi-units to a raw reading, the inverse of convert
+  void (*power)(bool on);                   // supply on or off, NULL when always on
+  void (*set_resolution)(uint32_t bits);    // bits per reading from the next sample on, NULL when fixed
+} SENSOR_Driver_TypeDef;
+
+typedef struct{
+  uint32_t step_cb;         // posted by the drivers, dispatched to sensor_step()
+  uint32_t error_cb;        // posted when a device refuses its settings, dispatched to sensor_error()
+  uint32_t sample_cb;       // posted once every result is in
+} SENSOR_Open_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void sensor_open(SENSOR_Open_TypeDef *sensor_open);
+
+uint32_t sensor_register(const SENSOR_Driver_TypeDef *driver);
+
+bool sensor_sample(void);
+
+void sensor_step(void);
+
+void sensor_error(void);
+
+uint32_t sensor_get_raw(uint32_t id);
+
+int32_t sensor_convert(uint32_t id, uint32_t raw_data);
+
+int32_t sensor_to_raw(uint32_t id, int32_t centi);
+
+int32_t sensor_delta_to_raw(uint32_t id, int32_t centi);
+
+void sensor_power(bool on);
+
+void sensor_set_resolution(uint32_t id, uint32_t bits);
+
+#endif /* SRC_HEADER_FILES_SENSOR_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file shell.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for shell
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_SHELL_H_
+#define SRC_HEADER_FILES_SHELL_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "em_assert.h"
+#include "leuart.h"
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "crc.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define SHELL_LINE_MAX          32u       // longest human mode line
+#define SHELL_BACKSPACE         0x08u
+#define SHELL_DELETE            0x7Fu
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// One entry per setting the shell can change
+typedef struct{
+  const char *name;             // human mode keyword
+  uint8_t id;                   // binary mode command id, also used in replies
+  int32_t min;                  // smallest accepted argument
+  int32_t max;                  // largest accepted argument
+} SHELL_Command_TypeDef;
+
+typedef struct{
+  LEUART_TypeDef *leuart;                   // receives the commands
+  const SHELL_Command_TypeDef *commands;    // command table, must stay valid
+  uint32_t num_commands;
+} SHELL_Open_TypeDef;
+
+// A parsed command, argument already range checked
+typedef struct{
+  uint8_t id;
+  int32_t arg;
+} SHELL_Request_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void shell_open(SHELL_Open_TypeDef *shell_open);
+
+bool shell_poll(SHELL_Request_TypeDef *request);
+
+void shell_reply(uint32_t id, uint32_t status, int32_t value);
+
+#endif /* SRC_HEADER_FILES_SHELL_H_ */
@@ -10,6 +10,12 @@
  * @brief
  *  Header file for si7021
  *
+ * @details
+ *  si7021_sensor is the driver the sensor registry samples through. The
+ *  measure command and the read back are separate transfers there, so other
+ *  sensors can start their conversions while this one converts.
+ *  si7021_read() still does both in one transfer.
+ *
  */
 
 #ifndef SRC_HEADER_FILES_SI7021_H_
@@ -22,6 +28,7 @@
 
 #include "HW_delay.h"
 #include "i2c.h"
+#include "sensor.h"
 
 //***********************************************************************************
 // Defined files
@@ -30,6 +37,35 @@
 #define Si7021_POWER_UP_DELAY   80u
 #define Si7021_NUM_BYTES        2u
 #define Si7021_CUR_BYTES        0u
+#define Si7021_USER_REG_BYTES   1u
+
+// User Register 1: resolution is RES1 (bit 7) and RES0 (bit 0), the other
+// writable bits are kept at their reset value (heater off)
+#define Si7021_USER_REG_DEFAULT 0x3Au
+#define Si7021_USER_REG_RES     0x81u
+
+// temperature = raw * 175.72 / 65536 - 46.85 degrees C, in centi-degrees
+#define Si7021_TEMP_SPAN        17572u
+#define Si7021_TEMP_OFFSET      4685
+#define Si7021_CODES            65536u
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// measurement resolution, encoded as the User Register 1 RES bits
+typedef enum{
+  SI7021_RES_RH12_T14 = 0x00,
+  SI7021_RES_RH8_T12  = 0x01,
+  SI7021_RES_RH10_T13 = 0x80,
+  SI7021_RES_RH11_T11 = 0x81
+} tSI7021_RESOLUTION;
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+
+extern const SENSOR_Driver_TypeDef si7021_sensor;
 
 //***********************************************************************************
 // function prototypes
@@ -39,8 +75,24 @@ void si7021_open(void);
 
 void si7021_read(uint32_t call_back);
 
+void si7021_start(uint32_t call_back);
+
+void si7021_collect(uint32_t call_back);
+
 uint32_t si7021_get_raw_data(void);
 
+void si7021_power(bool on);
+
+void si7021_set_resolution(tSI7021_RESOLUTION res);
+
+void si7021_set_bits(uint32_t bits);
+
+bool si7021_configure(uint32_t call_back, uint32_t error_cb);
+
+int32_t si7021_to_centi(uint32_t raw_data);
+
+int32_t si7021_to_raw(int32_t centi);
+
 float si7021_calc_temp(uint32_t raw_data);
 
 
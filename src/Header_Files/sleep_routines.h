@@ -21,6 +21,8 @@
 #include "em_emu.h"
 #include "em_core.h"
 #include "em_assert.h"
+#include "assert_log.h"
+#include "trace.h"
 //***********************************************************************************
 // global variables
 //***********************************************************************************
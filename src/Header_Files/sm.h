@@ -0,0 +1,80 @@
+/**
+ * @file sm.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for sm
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_SM_H_
+#define SRC_HEADER_FILES_SM_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define SM_NONE         0u      // no state: unhandled transition, or no parent
+#define SM_MAX_DEPTH    4u      // deepest state nesting, bounds every dispatch
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// Entry, exit and transition actions get the state they belong to
+typedef void (*SM_Action)(uint32_t state);
+
+// One per (state, event). A zeroed entry leaves the event to the parent state.
+// target SM_NONE with an action is an internal transition: the action runs
+// and the state does not change.
+typedef struct{
+  uint8_t target;               // leaf state to go to
+  SM_Action action;             // runs between the exits and the entries
+} SM_Transition_TypeDef;
+
+// State ids start at 1, the state with id n is states[n - 1]
+typedef struct{
+  uint8_t parent;               // enclosing state, SM_NONE at the top level
+  SM_Action entry;              // optional
+  SM_Action exit;               // optional
+  const SM_Transition_TypeDef *on;  // num_events entries indexed by event, NULL if none handled
+} SM_State_TypeDef;
+
+typedef struct{
+  const SM_State_TypeDef *states;
+  uint8_t num_states;
+  uint8_t num_events;
+  uint8_t initial;              // leaf state entered by sm_open()
+} SM_Table_TypeDef;
+
+typedef struct{
+  const SM_Table_TypeDef *table;
+  uint8_t current;              // always a leaf state
+} SM_Machine_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void sm_open(SM_Machine_TypeDef *sm, const SM_Table_TypeDef *table);
+
+bool sm_dispatch(SM_Machine_TypeDef *sm, uint32_t event);
+
+uint32_t sm_state(const SM_Machine_TypeDef *sm);
+
+bool sm_in(const SM_Machine_TypeDef *sm, uint32_t state);
+
+#endif /* SRC_HEADER_FILES_SM_H_ */
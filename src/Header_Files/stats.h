@@ -0,0 +1,66 @@
+/**
+ * @file stats.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for stats
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_STATS_H_
+#define SRC_HEADER_FILES_STATS_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_assert.h"
+#include "scheduler.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define STATS_MAX_PANES     8u          // sliding windows are built from up to this many hops
+#define STATS_MAX_WINDOW    16384u      // keeps the merged M2 inside 64 bits
+#define STATS_MEAN_SHIFT    8u          // fractional bits of the fixed point mean
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t window;          // samples covered by each summary
+  uint32_t hop;             // samples between summaries, == window for tumbling windows
+  uint32_t cb;              // event posted when a summary is ready (unique for scheduler)
+} STATS_Open_TypeDef;
+
+typedef struct{
+  uint32_t seq;             // summary number since stats_open()
+  uint16_t count;           // samples in the window
+  uint16_t min;             // raw units
+  uint16_t max;             // raw units
+  uint16_t mean;            // raw units, rounded
+  uint32_t variance;        // raw units squared (population variance)
+} STATS_Summary_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void stats_open(STATS_Open_TypeDef *stats_open);
+
+void stats_set_window(uint32_t window, uint32_t hop);
+
+void stats_update(uint32_t raw);
+
+void stats_get_summary(STATS_Summary_TypeDef *summary);
+
+#endif /* SRC_HEADER_FILES_STATS_H_ */
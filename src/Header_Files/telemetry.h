@@ -0,0 +1,68 @@
+/**
+ * @file telemetry.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for telemetry
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_TELEMETRY_H_
+#define SRC_HEADER_FILES_TELEMETRY_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "em_assert.h"
+#include "leuart.h"
+#include "telemetry_frame.h"
+#include "codec.h"
+#include "crc.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define TELEMETRY_BUFFERS       2u        // one frame on the wire, one waiting
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  LEUART_TypeDef *leuart;       // opened by the caller with tx_done_cb routed to telemetry_tx_done()
+  uint32_t samples_per_frame;   // samples batched into each TELEMETRY_SAMPLES frame
+} TELEMETRY_Open_TypeDef;
+
+typedef struct{
+  uint32_t frames;              // frames handed to the LEUART
+  uint32_t dropped;             // frames lost because both buffers were busy
+  uint32_t bytes;               // bytes handed to the LEUART, framing included
+} TELEMETRY_Stats_TypeDef;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void telemetry_open(TELEMETRY_Open_TypeDef *telemetry_open);
+
+bool telemetry_send(uint32_t type, const uint8_t *payload, uint32_t len);
+
+void telemetry_add_sample(uint32_t raw);
+
+void telemetry_flush_samples(void);
+
+void telemetry_tx_done(void);
+
+void telemetry_get_stats(TELEMETRY_Stats_TypeDef *stats);
+
+#endif /* SRC_HEADER_FILES_TELEMETRY_H_ */
@@ -0,0 +1,131 @@
+/**
+ * @file telemetry_frame.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Telemetry wire format, shared by the firmware and the host decoder
+ *
+ * @details
+ *  Every frame is
+ *
+ *    SYNC | type | seq | len | payload[len] | crc hi | crc lo
+ *
+ *  The CRC is crc16() over type through the end of the payload. seq counts
+ *  frames modulo 256 so the receiver can spot gaps. Multi byte fields are
+ *  little endian. The same framing carries binary commands to the device.
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_TELEMETRY_FRAME_H_
+#define SRC_HEADER_FILES_TELEMETRY_FRAME_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define TELEMETRY_SYNC          0xA5u
+#define TELEMETRY_HEADER_SIZE   4u        // sync, type, seq, len
+#define TELEMETRY_CRC_SIZE      2u
+#define TELEMETRY_MAX_PAYLOAD   32u
+#define TELEMETRY_MAX_FRAME     (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + TELEMETRY_CRC_SIZE)
+
+// Frame types
+#define TELEMETRY_SAMPLES       0x01u     // codec encoded samples, first one is a keyframe
+#define TELEMETRY_SUMMARY       0x02u     // statistics window summary
+#define TELEMETRY_EVENT         0x03u     // alarm state change
+#define TELEMETRY_MEMORY        0x04u     // stack and RAM usage
+#define TELEMETRY_TRACE         0x05u     // trace entries from before the last reset
+#define TELEMETRY_FAULT         0x06u     // fault that caused the last reset
+#define TELEMETRY_COMMAND       0x10u     // host to device, configuration command
+#define TELEMETRY_REPLY         0x11u     // device to host, result of a command
+
+// TELEMETRY_SUMMARY payload
+#define TELEMETRY_SUMMARY_SEQ       0u    // uint32_t
+#define TELEMETRY_SUMMARY_COUNT     4u    // uint16_t
+#define TELEMETRY_SUMMARY_MIN       6u    // uint16_t, raw units
+#define TELEMETRY_SUMMARY_MAX       8u    // uint16_t, raw units
+#define TELEMETRY_SUMMARY_MEAN      10u   // uint16_t, raw units
+#define TELEMETRY_SUMMARY_VARIANCE  12u   // uint32_t, raw units squared
+#define TELEMETRY_SUMMARY_REPORTED  16u   // uint16_t, samples past the send-on-delta filter since the last summary
+#define TELEMETRY_SUMMARY_SIZE      18u
+
+// TELEMETRY_EVENT payload
+#define TELEMETRY_EVENT_STATE       0u    // uint32_t, alarm_get_state()
+#define TELEMETRY_EVENT_CHANGED     4u    // uint32_t, alarm_get_changed()
+#define TELEMETRY_EVENT_RAW         8u    // uint16_t, filtered reading that caused the change
+#define TELEMETRY_EVENT_SIZE        10u
+
+// TELEMETRY_MEMORY payload
+#define TELEMETRY_MEMORY_STACK_SIZE 0u    // uint16_t, bytes
+#define TELEMETRY_MEMORY_STACK_PEAK 2u    // uint16_t, bytes, deepest since reset
+#define TELEMETRY_MEMORY_STATIC_RAM 4u    // uint32_t, bytes of .data and .bss
+#define TELEMETRY_MEMORY_SIZE       8u
+
+// TELEMETRY_TRACE payload, as many entries as the length holds
+#define TELEMETRY_TRACE_FIRST       0u    // uint8_t, position of the first entry, 0 is the oldest
+#define TELEMETRY_TRACE_ENTRIES     1u    // uint32_t each, TRACE_* tag << 24 | argument
+#define TELEMETRY_TRACE_MAX         7u    // entries per frame
+
+// TELEMETRY_FAULT payload, see TRACE_Fault_TypeDef
+#define TELEMETRY_FAULT_KIND        0u    // uint8_t, TRACE_FAULT_*
+#define TELEMETRY_FAULT_PC          1u    // uint32_t
+#define TELEMETRY_FAULT_LR          5u    // uint32_t
+#define TELEMETRY_FAULT_XPSR        9u    // uint32_t
+#define TELEMETRY_FAULT_CFSR        13u   // uint32_t
+#define TELEMETRY_FAULT_HFSR        17u   // uint32_t
+#define TELEMETRY_FAULT_ADDR        21u   // uint32_t
+#define TELEMETRY_FAULT_SP          25u   // uint32_t
+#define TELEMETRY_FAULT_SIZE        29u
+
+// TELEMETRY_COMMAND payload
+#define TELEMETRY_COMMAND_ID        0u    // uint8_t
+#define TELEMETRY_COMMAND_ARG       1u    // int32_t
+#define TELEMETRY_COMMAND_SIZE      5u
+
+// TELEMETRY_REPLY payload
+#define TELEMETRY_REPLY_ID          0u    // uint8_t, command id or TELEMETRY_REPLY_NO_ID
+#define TELEMETRY_REPLY_STATUS      1u    // uint8_t, TELEMETRY_STATUS_*
+#define TELEMETRY_REPLY_VALUE       2u    // int32_t, value now in effect
+#define TELEMETRY_REPLY_SIZE        6u
+#define TELEMETRY_REPLY_NO_ID       0xFFu // the command could not be identified
+
+#define TELEMETRY_STATUS_OK         0u
+#define TELEMETRY_STATUS_UNKNOWN    1u    // no such command
+#define TELEMETRY_STATUS_RANGE      2u    // argument out of range
+#define TELEMETRY_STATUS_SYNTAX     3u    // line could not be parsed
+#define TELEMETRY_STATUS_CRC        4u    // binary command failed its CRC
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+static inline void telemetry_put16(uint8_t *p, uint32_t v){
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void telemetry_put32(uint8_t *p, uint32_t v){
+  telemetry_put16(p, v);
+  telemetry_put16(p + 2, v >> 16);
+}
+
+static inline uint32_t telemetry_get16(const uint8_t *p){
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t telemetry_get32(const uint8_t *p){
+  return telemetry_get16(p) | (telemetry_get16(p + 2) << 16);
+}
+
+#endif /* SRC_HEADER_FILES_TELEMETRY_FRAME_H_ */
@@ -0,0 +1,107 @@
+/**
+ * @file trace.h
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Header file for trace, a ring of recent events and the last fault, kept
+ *  across resets
+ *
+ * @details
+ *  An entry is one word, a TRACE_* tag in the top byte and a 24 bit argument
+ *  below it. trace() claims a slot with an atomic increment and stores the
+ *  word, a handful of cycles from any context, so it stays on in production.
+ *
+ */
+
+#ifndef SRC_HEADER_FILES_TRACE_H_
+#define SRC_HEADER_FILES_TRACE_H_
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "brd_config.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define TRACE_ENTRIES         64u         // entries kept, power of 2
+#define TRACE_TAG_SHIFT       24u
+#define TRACE_ARG_MASK        0x00FFFFFFu
+
+// Entry tags
+#define TRACE_BOOT            0x01u       // arg: boots since the trace was cleared
+#define TRACE_POST            0x02u       // arg: scheduler events posted
+#define TRACE_DISPATCH        0x03u       // arg: scheduler events removed for dispatch
+#define TRACE_I2C             0x04u       // arg: interrupt flags << 8 | state on entry
+#define TRACE_SLEEP           0x05u       // arg: energy mode entered, EM0 when none was allowed
+#define TRACE_ASSERT          0x06u       // arg: line of the failed check
+#define TRACE_SAMPLE_SKIP     0x07u       // arg: samples skipped so far, the sampler was busy
+#define TRACE_SENSOR_ERROR    0x08u       // arg: id of the sensor whose settings write was refused
+
+// TRACE_Fault_TypeDef.kind
+#define TRACE_FAULT_NONE      0u
+#define TRACE_FAULT_HARD      1u          // HardFault, registers from the exception frame
+#define TRACE_FAULT_ASSERT    2u          // failed EFM_ASSERT, pc is the caller, lr the line, addr the file
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t kind;
+  uint32_t pc;
+  uint32_t lr;
+  uint32_t xpsr;
+  uint32_t cfsr;
+  uint32_t hfsr;
+  uint32_t addr;                // BFAR or MMFAR when the fault set it valid
+  uint32_t sp;                  // exception frame
+} TRACE_Fault_TypeDef;
+
+typedef struct{
+  uint32_t magic;
+  uint32_t head;                // entries ever written
+  uint32_t boot_head;           // head when the current boot started
+  uint32_t boots;
+  TRACE_Fault_TypeDef fault;
+  uint32_t entry[TRACE_ENTRIES];
+} TRACE_Log_TypeDef;
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+
+extern TRACE_Log_TypeDef trace_log;
+
+//***********************************************************************************
+// function prototypes
+//***********************************************************************************
+
+void trace_open(void);
+
+uint32_t trace_last(uint32_t first, uint32_t *entries, uint32_t max);
+
+bool trace_last_fault(TRACE_Fault_TypeDef *fault);
+
+/***************************************************************************//**
+* @brief
+*  Append an entry, safe from any context
+*
+******************************************************************************/
+static inline void trace(uint32_t tag, uint32_t arg){
+  uint32_t n = __atomic_fetch_add(&trace_log.head, 1u, __ATOMIC_RELAXED);
+
+  trace_log.entry[n & (TRACE_ENTRIES - 1u)] = (tag << TRACE_TAG_SHIFT) | (arg & TRACE_ARG_MASK);
+}
+
+#endif /* SRC_HEADER_FILES_TRACE_H_ */
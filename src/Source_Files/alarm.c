@@ -0,0 +1,196 @@
+/**
+ * @file alarm.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Threshold alarms with hysteresis, dwell and rate of change triggers
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "alarm.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static ALARM_Open_TypeDef config;
+
+static uint8_t active;                            // bit n set: threshold n is active
+static uint8_t changed;                           // thresholds that changed on the last update
+static uint8_t dwell_count[ALARM_MAX_THRESHOLDS]; // consecutive samples pushing toward a change
+static uint16_t prev_raw;                         // last reading, for rate thresholds
+static bool have_prev;
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Check whether a value should move a threshold out of its current state
+*
+* @details
+*  An inactive threshold is pushed toward active once the value reaches set,
+*  an active one is pushed toward inactive once the value gets back to clear.
+*  The gap between set and clear is the hysteresis band.
+*
+* @param [in] threshold
+*  Threshold configuration
+*
+* @param [in] is_active
+*  Current state of the threshold
+*
+* @param [in] value
+*  Reading or rate in raw units
+*
+******************************************************************************/
+static bool alarm_toward_change(const ALARM_Threshold_TypeDef *threshold, bool is_active, int32_t value){
+  if(threshold->rising){
+      return is_active ? (value <= threshold->clear) : (value >= threshold->set);
+  }
+  return is_active ? (value >= threshold->clear) : (value <= threshold->set);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Configure the alarm engine
+*
+* @details
+*  Copies the threshold table and resets all alarms to inactive. Thresholds
+*  are given in raw sensor units so no conversion is needed per sample.
+*
+* @param [in] alarm_open
+*  Threshold table and the event to post on alarm state changes
+*
+******************************************************************************/
+void alarm_open(ALARM_Open_TypeDef *alarm_open){
+  EFM_ASSERT(alarm_open->num_thresholds <= ALARM_MAX_THRESHOLDS);
+
+  config = *alarm_open;
+
+  for(uint32_t i = 0; i < config.num_thresholds; i++){
+      const ALARM_Threshold_TypeDef *t = &config.threshold[i];
+      // clear must sit on the inactive side of set
+      EFM_ASSERT(t->rising ? (t->clear < t->set) : (t->clear > t->set));
+      dwell_count[i] = 0;
+  }
+
+  active = ALARM_NONE;
+  changed = ALARM_NONE;
+  have_prev = false;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Move one threshold while running
+*
+* @details
+*  The threshold keeps its current state and is re-evaluated against the
+*  new limits from the next reading, with its dwell count restarted.
+*
+* @param [in] index
+*  Threshold number in the table given to alarm_open()
+*
+* @param [in] set
+*  New set limit, raw units
+*
+* @param [in] clear
+*  New clear limit, raw units
+*
+******************************************************************************/
+void alarm_set_threshold(uint32_t index, int32_t set, int32_t clear){
+  EFM_ASSERT(index < config.num_thresholds);
+
+  ALARM_Threshold_TypeDef *t = &config.threshold[index];
+  EFM_ASSERT(t->rising ? (clear < set) : (clear > set));
+
+  t->set = set;
+  t->clear = clear;
+  dwell_count[index] = 0;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Run every threshold against a new reading
+*
+* @details
+*  A threshold only changes state after the reading stays past set (or back
+*  past clear) for dwell consecutive samples. The configured event is posted
+*  only when at least one threshold changed state, so steady readings cost
+*  nothing downstream.
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+******************************************************************************/
+void alarm_update(uint32_t raw){
+  int32_t rate = have_prev ? (int32_t)raw - (int32_t)prev_raw : 0;
+
+  changed = ALARM_NONE;
+
+  for(uint32_t i = 0; i < config.num_thresholds; i++){
+      const ALARM_Threshold_TypeDef *t = &config.threshold[i];
+      uint8_t bit = 1u << i;
+      int32_t value = (t->source == ALARM_RATE) ? rate : (int32_t)raw;
+
+      if((t->source == ALARM_RATE) && !have_prev){
+          continue;                               // no rate on the first sample
+      }
+
+      if(!alarm_toward_change(t, active & bit, value)){
+          dwell_count[i] = 0;
+          continue;
+      }
+
+      if(++dwell_count[i] >= t->dwell){
+          dwell_count[i] = 0;
+          active ^= bit;
+          changed |= bit;
+      }
+  }
+
+  prev_raw = raw;
+  have_prev = true;
+
+  if(changed){
+      add_scheduled_event(config.cb);
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the active alarms
+*
+* @details
+*  Bit n of the returned value is set while threshold n is active
+*
+******************************************************************************/
+uint32_t alarm_get_state(void){
+  return active;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the alarms that changed state on the last update
+*
+* @details
+*  Bit n of the returned value is set if threshold n changed state
+*
+******************************************************************************/
+uint32_t alarm_get_changed(void){
+  return changed;
+}
@@ -21,29 +21,81 @@
 // global variables
 //***********************************************************************************
 
+// ONE/TWO/THREE counter, shown on the LEDs in binary. THREE waits for two
+// more presses, so it is split into sub states that share its entry action.
 typedef enum {
-  ONE,
-  TWO,
-  THREE
+  COUNT_ONE = 1,
+  COUNT_TWO,
+  COUNT_THREE,
+  COUNT_THREE_WAIT,       // in THREE, no press yet
+  COUNT_THREE_PRESSED     // in THREE, one press
 } tCountState;
 
+// Energy mode cycling, each state blocks the energy mode it is named after
+typedef enum {
+  EM_STATE_EM0 = 1,
+  EM_STATE_EM1,
+  EM_STATE_EM2,
+  EM_STATE_EM3,
+  EM_STATE_EM4
+} tEMState;
+
+#define EM_STATE(em)      (EM_STATE_EM0 + (em))
+#define EM_OF_STATE(s)    ((s) - EM_STATE_EM0)
+
 typedef struct {
-  //Current state of the state machine
-  tCountState state;
-  //Keeps track of the # of times a btn has been pressed in the current state
-  uint32_t num_press;
-  //Encoded event handler to be serviced
-  uint32_t cb;
-  //For the current state, records whether btn0 has been pressed
-  bool btn0;
-  //For the current state, records whether btn1 has been pressed
-  bool btn1;
-}tAPP_STATE_MACHINE;
-
-
-// initialize the ASM as a global variable
-tAPP_STATE_MACHINE ASM;
-tAPP_STATE_MACHINE *p = &ASM;
+  //LED on time within each PWM period (s)
+  float active_period;
+  //Blink LED0 (LETIMER out 1)
+  bool led0;
+  //Blink LED1 (LETIMER out 0)
+  bool led1;
+}tLED_PATTERN;
+
+// LETIMER output pattern for each LED status
+static const tLED_PATTERN led_pattern[LED_STATUS_COUNT] = {
+  [LED_STATUS_OFF]          = { PWM_ACT_PER,       false, false },
+  [LED_STATUS_NORMAL]       = { PWM_ACT_PER,       true,  false },    // short LED0 blip
+  [LED_STATUS_ALARM]        = { PWM_ALARM_ACT_PER, false, true  },    // slow LED1 blink
+  [LED_STATUS_LOW_BATTERY]  = { PWM_ACT_PER,       true,  true  },    // short blip on both
+};
+
+static tLED_STATUS led_status = LED_STATUS_COUNT;
+
+// sample stream written to the flash log
+static CODEC_State_TypeDef log_codec;
+
+// settings that can be changed at run time over the LEUART
+static const SHELL_Command_TypeDef shell_commands[] = {
+  { "period", SHELL_CMD_PERIOD, SHELL_PERIOD_MIN, SHELL_PERIOD_MAX },
+  { "alarm",  SHELL_CMD_ALARM,  SHELL_ALARM_MIN,  SHELL_ALARM_MAX  },
+  { "res",    SHELL_CMD_RES,    SHELL_RES_MIN,    SHELL_RES_MAX    },
+  { "sleep",  SHELL_CMD_SLEEP,  EM0,              EM3              },
+  { "delta",  SHELL_CMD_DELTA,  SHELL_DELTA_MIN,  SHELL_DELTA_MAX  },
+  { "burst",  SHELL_CMD_BURST,  SHELL_BURST_MIN,  SHELL_BURST_MAX  },
+  { "median", SHELL_CMD_MEDIAN, 0,                1                },
+  { "ema",    SHELL_CMD_EMA,    SHELL_EMA_MIN,    SHELL_EMA_MAX    },
+};
+
+// registry id of the Si7021
+static uint32_t temp_sensor;
+
+// LETIMER period, every setting counted in samples is derived from it
+static uint32_t sample_period_ms = (uint32_t)(PWM_PER * 1000);
+
+// samples not started because the previous one was still under way
+static uint32_t samples_skipped;
+
+// noise filter stages, changed by the burst, median and ema commands
+static FILTER_Open_TypeDef filter_config;
+
+// energy mode blocked by the sleep command, MAX_ENERGY_MODES when none is
+static uint32_t shell_em_block = MAX_ENERGY_MODES;
+
+// records sent one per free frame buffer by app_send_reports()
+static bool fault_report_due;                   // previous boot ended in a fault
+static uint32_t trace_report_next;              // next trace entry of the previous boot
+static bool memory_report_due;                  // a summary just went out
 
 //***********************************************************************************
 // function
@@ -69,47 +121,36 @@ void app_gpio_open(void){
   gpio.btn1_pin  = BUT1_PIN;
   gpio.btn1_en   = ENABLE;
   gpio.btn1_irq_enable   = ENABLE;
+  gpio.btn0_cb   = APP_BTN0_CB;
+  gpio.btn1_cb   = APP_BTN1_CB;
   gpio_open(&gpio);
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Called every time a new state is entered
+ *  Entry action of the counter states
  *
  * @details
- *  Set the values of our state machine struct so they correspond to the
- *  beginning of a new state. This means resetting the button 0 and button 1
- *  values and number of presses
+ *  Sets the LEDs so the state number is represented in binary. The THREE sub
+ *  states have no entry action of their own, so the LEDs are only written
+ *  when THREE is entered from outside.
  *
- ******************************************************************************/
-void app_new_state(void){
-  p->num_press = NONE;
-  p->btn0 = NONE;
-  p->btn1 = NONE;
-}
-
-
-/***************************************************************************//**
- * @brief
- *  Set the LEDs that correspond to the state
- *
- * @details
- *  Using switch statements that read the current state, we update the LEDs
- *  so that the state number is represented in binary by the LEDs
+ * @param [in] state
+ *  Counter state being entered
  *
  ******************************************************************************/
-void app_set_LEDS(void){
-  switch(p->state){
-    case ONE:
+static void app_set_LEDS(uint32_t state){
+  switch(state){
+    case COUNT_ONE:
       GPIO_PinOutSet(LED0_PORT, LED0_PIN);              // LED0 ON
       GPIO_PinOutClear(LED1_PORT, LED1_PIN);            // LED1 OFF
       break;
-    case TWO:
+    case COUNT_TWO:
       GPIO_PinOutClear(LED0_PORT, LED0_PIN);            // LED0 OFF
       GPIO_PinOutSet(LED1_PORT, LED1_PIN);              // LED1 ON
       break;
-    case THREE:
+    case COUNT_THREE:
       GPIO_PinOutSet(LED0_PORT, LED0_PIN);              // LED0 ON
       GPIO_PinOutSet(LED1_PORT, LED1_PIN);              // LED1 ON
       break;
@@ -121,61 +162,96 @@ void app_set_LEDS(void){
 
 /***************************************************************************//**
  * @brief
- *  Initialize the state machine
- *
- * @details
- *  Set the state machine's state and LEDs that correspond to the inital state
- *  in this case this is state one
+ *  Entry action of the energy mode states, blocks the state's energy mode
  *
  ******************************************************************************/
-void app_init_state_machine(void){
-  p->state = ONE;
-  app_set_LEDS();
-  app_new_state();
+static void app_em_entry(uint32_t state){
+  sleep_block_mode(EM_OF_STATE(state));
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Handle the functionality and logic of the state machine
+ *  Exit action of the energy mode states, releases the state's energy mode
  *
- * @details
- *  Use the current state of the state machine, the presses of the buttons,
- *  and the number of presses to change states
- *
- ******************************************************************************/
-void app_state_machine(void){
-  switch(p->state){
-    case(ONE):
-        if(p->btn0){
-            p->state = TWO;
-            app_set_LEDS();
-            app_new_state();
-        }
-        break;
-
-    case(TWO):
-        if(p->btn0){
-            p->state = ONE;
-            app_set_LEDS();
-            app_new_state();
-        }
-        else if(p->btn1){
-            p->state = THREE;
-            app_set_LEDS();
-            app_new_state();
-        }
-        break;
-
-    case(THREE):
-        if(p->num_press == TWICE)
-            app_init_state_machine();
-        break;
+ ******************************************************************************/
+static void app_em_exit(uint32_t state){
+  sleep_unblock_mode(EM_OF_STATE(state));
+}
 
-    default:
-        break;
 
-  }
+// Counter: BTN0 toggles ONE/TWO, BTN1 moves TWO to THREE, two presses of
+// either button leave THREE
+static const SM_Transition_TypeDef count_one_on[APP_EVENTS] = {
+  [APP_EV_BTN0] = { COUNT_TWO, NULL },
+};
+static const SM_Transition_TypeDef count_two_on[APP_EVENTS] = {
+  [APP_EV_BTN0] = { COUNT_ONE, NULL },
+  [APP_EV_BTN1] = { COUNT_THREE_WAIT, NULL },
+};
+static const SM_Transition_TypeDef count_three_wait_on[APP_EVENTS] = {
+  [APP_EV_BTN0] = { COUNT_THREE_PRESSED, NULL },
+  [APP_EV_BTN1] = { COUNT_THREE_PRESSED, NULL },
+};
+static const SM_Transition_TypeDef count_three_pressed_on[APP_EVENTS] = {
+  [APP_EV_BTN0] = { COUNT_ONE, NULL },
+  [APP_EV_BTN1] = { COUNT_ONE, NULL },
+};
+
+static const SM_State_TypeDef count_states[] = {
+  [COUNT_ONE - 1]           = { SM_NONE,     app_set_LEDS, NULL, count_one_on },
+  [COUNT_TWO - 1]           = { SM_NONE,     app_set_LEDS, NULL, count_two_on },
+  [COUNT_THREE - 1]         = { SM_NONE,     app_set_LEDS, NULL, NULL },
+  [COUNT_THREE_WAIT - 1]    = { COUNT_THREE, NULL,         NULL, count_three_wait_on },
+  [COUNT_THREE_PRESSED - 1] = { COUNT_THREE, NULL,         NULL, count_three_pressed_on },
+};
+
+const SM_Table_TypeDef app_count_table = {
+  count_states, sizeof(count_states) / sizeof(count_states[0]), APP_EVENTS, COUNT_ONE
+};
+
+// Energy mode cycling: BTN0 moves the block to the next lower energy mode
+// (shallower sleep), BTN1 to the next higher one, wrapping at both ends
+#define EM_ROW(em, lower, higher)   { [APP_EV_BTN0] = { EM_STATE(lower), NULL }, \
+                                      [APP_EV_BTN1] = { EM_STATE(higher), NULL } }
+
+static const SM_Transition_TypeDef em_on[MAX_ENERGY_MODES][APP_EVENTS] = {
+  EM_ROW(EM0, EM4, EM1),
+  EM_ROW(EM1, EM0, EM2),
+  EM_ROW(EM2, EM1, EM3),
+  EM_ROW(EM3, EM2, EM4),
+  EM_ROW(EM4, EM3, EM0),
+};
+
+static const SM_State_TypeDef em_states[MAX_ENERGY_MODES] = {
+  { SM_NONE, app_em_entry, app_em_exit, em_on[EM0] },
+  { SM_NONE, app_em_entry, app_em_exit, em_on[EM1] },
+  { SM_NONE, app_em_entry, app_em_exit, em_on[EM2] },
+  { SM_NONE, app_em_entry, app_em_exit, em_on[EM3] },
+  { SM_NONE, app_em_entry, app_em_exit, em_on[EM4] },
+};
+
+static const SM_Table_TypeDef em_table = {
+  em_states, MAX_ENERGY_MODES, APP_EVENTS, EM_STATE_EM4
+};
+
+static SM_Machine_TypeDef count_sm;
+static SM_Machine_TypeDef em_sm;
+
+
+/***************************************************************************//**
+ * @brief
+ *  Initialize the state machines
+ *
+ * @details
+ *  The counter starts in state one and the energy mode cycling starts by
+ *  blocking EM4, which the running LETIMER blocks anyway. Must run after
+ *  sleep_open() since the energy mode states block and unblock modes.
+ *
+ ******************************************************************************/
+void app_init_state_machine(void){
+  sm_open(&count_sm, &app_count_table);
+  sm_open(&em_sm, &em_table);
 }
 
 
@@ -196,11 +272,13 @@ void app_letimer_pwm_open(float period, float act_period, uint32_t out0_route, u
   a.out_pin_route1 = out1_route;
   a.out_pin_0_en = !LETIMER_ROUTEPEN_OUT0PEN;
   a.out_pin_1_en = !LETIMER_ROUTEPEN_OUT1PEN;      // this variable should be a uint32_t
+  a.out_pin_0_pol = DISABLE;                        // idle low, LED on while active
+  a.out_pin_1_pol = DISABLE;
   a.period = period;
   a.active_period = act_period;
-  a.comp0_irq_enable = ENABLE;
+  a.comp0_irq_enable = DISABLE;                     // LED patterns need no CPU wakeups
   a.comp0_cb = LETIMER_COMP0_IRQ_CB;
-  a.comp1_irq_enable = ENABLE;
+  a.comp1_irq_enable = DISABLE;
   a.comp1_cb = LETIMER_COMP1_IRQ_CB;
   a.uf_irq_enable = ENABLE;
   a.uf_cb = LETIMER_UF_IRQ_CB;
@@ -208,6 +286,410 @@ void app_letimer_pwm_open(float period, float act_period, uint32_t out0_route, u
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *  Samples in a span of time at the current sample period
+ *
+ * @param [in] seconds
+ *  Whole minutes, so the count is exact at every period the shell accepts
+ *
+ ******************************************************************************/
+static uint32_t app_samples(uint32_t seconds){
+  return seconds * 1000u / sample_period_ms;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Rate alarm limit per sample at the current sample period
+ *
+ * @details
+ *  Converted per minute and scaled in raw codes, a rise per sample in
+ *  centi-degrees would round to nothing at short periods.
+ *
+ * @param [in] per_minute
+ *  Rise in degrees C per minute
+ *
+ ******************************************************************************/
+static int32_t app_rate_threshold(double per_minute){
+  return sensor_delta_to_raw(temp_sensor, CENTI(per_minute)) * (int32_t)sample_period_ms / (int32_t)MS_PER_MIN;
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the temperature alarms
+ *
+ * @details
+ *  Sets up a level alarm at AMBIENT_TEMP with hysteresis and a rate of change
+ *  alarm on fast rises. Thresholds are converted to raw sensor units through
+ *  the sensor registry here so the per sample check is integer only, the
+ *  rate ones to a rise per sample. The sensors are registered first.
+ *
+ ******************************************************************************/
+void app_alarm_open(void){
+  ALARM_Open_TypeDef a;
+  a.num_thresholds = 2;
+
+  a.threshold[0].source = ALARM_LEVEL;
+  a.threshold[0].rising = true;
+  a.threshold[0].set = sensor_to_raw(temp_sensor, CENTI(AMBIENT_TEMP));
+  a.threshold[0].clear = sensor_to_raw(temp_sensor, CENTI(AMBIENT_TEMP - TEMP_ALARM_HYST));
+  a.threshold[0].dwell = TEMP_ALARM_DWELL;
+
+  a.threshold[1].source = ALARM_RATE;
+  a.threshold[1].rising = true;
+  a.threshold[1].set = app_rate_threshold(TEMP_RATE_SET);
+  a.threshold[1].clear = app_rate_threshold(TEMP_RATE_CLEAR);
+  a.threshold[1].dwell = TEMP_RATE_DWELL;
+
+  a.cb = ALARM_CB;
+  alarm_open(&a);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the summary statistics
+ *
+ * @details
+ *  Every STATS_HOP_S a min/max/mean/variance summary of the last
+ *  STATS_WINDOW_S is produced, so consumers see one record per window
+ *  instead of every reading.
+ *
+ ******************************************************************************/
+void app_stats_open(void){
+  STATS_Open_TypeDef s;
+  s.window = app_samples(STATS_WINDOW_S);
+  s.hop = app_samples(STATS_HOP_S);
+  s.cb = STATS_CB;
+  stats_open(&s);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Register the sensors the sampler reads every LETIMER period
+ *
+ * @details
+ *  A new sensor is one more sensor_register() here. The sampler starts all
+ *  of them before collecting any result, so their conversions overlap.
+ *
+ ******************************************************************************/
+void app_sensor_open(void){
+  SENSOR_Open_TypeDef s;
+  s.step_cb = SENSOR_STEP_CB;
+  s.error_cb = SENSOR_ERROR_CB;
+  s.sample_cb = SENSOR_SAMPLE_CB;
+  sensor_open(&s);
+  temp_sensor = sensor_register(&si7021_sensor);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the noise filter
+ *
+ ******************************************************************************/
+void app_filter_open(void){
+  filter_config.burst = FILTER_BURST;
+  filter_config.median = FILTER_MEDIAN;
+  filter_config.ema_shift = FILTER_EMA_SHIFT;
+  filter_open(&filter_config);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the send-on-delta filter
+ *
+ * @details
+ *  Readings that moved less than REPORT_DELTA since the last one reported
+ *  are kept out of the flash log and the telemetry samples, except for one
+ *  every REPORT_HEARTBEAT_S.
+ *
+ ******************************************************************************/
+void app_report_open(void){
+  REPORT_Open_TypeDef r;
+  r.delta = sensor_delta_to_raw(temp_sensor, CENTI(REPORT_DELTA));
+  r.heartbeat = app_samples(REPORT_HEARTBEAT_S);
+  report_open(&r);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Start the post to dispatch latency trace of the scheduler events
+ *
+ ******************************************************************************/
+void app_latency_open(void){
+  LATENCY_Open_TypeDef l;
+  l.window = LATENCY_WINDOW;
+  latency_open(&l);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Send the next deferred telemetry record
+ *
+ * @details
+ *  Sends the fault that ended the previous boot, then the trace entries
+ *  written before the reset, then the memory usage due after a summary, one
+ *  record per call. Called at open and each time a frame has gone out, so a
+ *  frame buffer is free and none of them is dropped.
+ *
+ ******************************************************************************/
+static void app_send_reports(void){
+  uint8_t record[TELEMETRY_MAX_PAYLOAD];
+
+  if(fault_report_due){
+      TRACE_Fault_TypeDef fault;
+
+      trace_last_fault(&fault);
+      record[TELEMETRY_FAULT_KIND] = (uint8_t)fault.kind;
+      telemetry_put32(&record[TELEMETRY_FAULT_PC], fault.pc);
+      telemetry_put32(&record[TELEMETRY_FAULT_LR], fault.lr);
+      telemetry_put32(&record[TELEMETRY_FAULT_XPSR], fault.xpsr);
+      telemetry_put32(&record[TELEMETRY_FAULT_CFSR], fault.cfsr);
+      telemetry_put32(&record[TELEMETRY_FAULT_HFSR], fault.hfsr);
+      telemetry_put32(&record[TELEMETRY_FAULT_ADDR], fault.addr);
+      telemetry_put32(&record[TELEMETRY_FAULT_SP], fault.sp);
+      fault_report_due = !telemetry_send(TELEMETRY_FAULT, record, TELEMETRY_FAULT_SIZE);
+      return;
+  }
+
+  uint32_t entry[TELEMETRY_TRACE_MAX];
+  uint32_t n = trace_last(trace_report_next, entry, TELEMETRY_TRACE_MAX);
+
+  if(n){
+      record[TELEMETRY_TRACE_FIRST] = (uint8_t)trace_report_next;
+      for(uint32_t i = 0; i < n; i++){
+          telemetry_put32(&record[TELEMETRY_TRACE_ENTRIES + 4 * i], entry[i]);
+      }
+      if(telemetry_send(TELEMETRY_TRACE, record, TELEMETRY_TRACE_ENTRIES + 4 * n)){
+          trace_report_next += n;
+      }
+      return;
+  }
+
+  if(memory_report_due){
+      MEM_Usage_TypeDef mem;
+
+      mem_get(&mem);
+      telemetry_put16(&record[TELEMETRY_MEMORY_STACK_SIZE], mem.stack_size);
+      telemetry_put16(&record[TELEMETRY_MEMORY_STACK_PEAK], mem.stack_peak);
+      telemetry_put32(&record[TELEMETRY_MEMORY_STATIC_RAM], mem.static_ram);
+      memory_report_due = !telemetry_send(TELEMETRY_MEMORY, record, TELEMETRY_MEMORY_SIZE);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Configure the telemetry stream
+ *
+ * @details
+ *  Opens LEUART0 on the LFXO so it keeps running in EM2, then starts the
+ *  framed telemetry on top of it. Transmit completion is routed back through
+ *  the scheduler to scheduled_telemetry_tx_cb(), and received bytes to the
+ *  configuration shell in scheduled_shell_rx_cb(). A fault and the trace
+ *  kept from before the reset are the first records sent.
+ *
+ ******************************************************************************/
+void app_telemetry_open(void){
+  LEUART_OPEN_STRUCT l;
+  l.baudrate = LEUART0_BAUD;
+  l.databits = leuartDatabits8;
+  l.enable = leuartEnable;
+  l.parity = leuartNoParity;
+  l.stopbits = leuartStopbits1;
+  l.refFreq = 0;                                  // use the current LFB clock
+  l.tx_loc = LEUART0_TX_ROUTE;
+  l.rx_loc = LEUART0_RX_ROUTE;
+  l.tx_pin_en = ENABLE;
+  l.rx_pin_en = ENABLE;
+  l.tx_done_cb = TELEMETRY_TX_CB;
+  l.rx_irq_enable = ENABLE;
+  l.rx_cb = SHELL_RX_CB;
+  leuart_open(LEUART0, &l);
+
+  TELEMETRY_Open_TypeDef t;
+  t.leuart = LEUART0;
+  t.samples_per_frame = TELEMETRY_SAMPLES_PER_FRAME;
+  telemetry_open(&t);
+
+  SHELL_Open_TypeDef s;
+  s.leuart = LEUART0;
+  s.commands = shell_commands;
+  s.num_commands = sizeof(shell_commands) / sizeof(shell_commands[0]);
+  shell_open(&s);
+
+  TRACE_Fault_TypeDef fault;
+  fault_report_due = trace_last_fault(&fault);
+  app_send_reports();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Change the sample period
+ *
+ * @details
+ *  The alarm rates, the summary windows, the report heartbeat and the trend
+ *  history are set in time and counted in samples, so each is rescaled to
+ *  the new period. The period has to divide a minute for the counts to come
+ *  out whole. The summary being built restarts at the new length.
+ *
+ * @param [in] period_ms
+ *  Sample period, a divisor of MS_PER_MIN
+ *
+ ******************************************************************************/
+static void app_set_sample_period(uint32_t period_ms){
+  EFM_ASSERT(!(MS_PER_MIN % period_ms));
+
+  letimer_set_period(LETIMER0, period_ms / 1000.0f);
+  sample_period_ms = period_ms;
+
+  alarm_set_threshold(1, app_rate_threshold(TEMP_RATE_SET), app_rate_threshold(TEMP_RATE_CLEAR));
+  stats_set_window(app_samples(STATS_WINDOW_S), app_samples(STATS_HOP_S));
+  report_set_heartbeat(app_samples(REPORT_HEARTBEAT_S));
+  history_set_rate(app_samples(60u));
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Apply a configuration command from the shell
+ *
+ * @details
+ *  The argument has already been range checked against shell_commands[].
+ *  Each setting goes straight to the driver that owns it. The resolution
+ *  is kept by the sensor driver and written by the sampler before the next
+ *  sample. A period that does not divide a minute is refused, see
+ *  app_set_sample_period(). The applied value is echoed in the reply.
+ *
+ * @param [in] request
+ *  Command id and argument
+ *
+ ******************************************************************************/
+void app_shell_command(const SHELL_Request_TypeDef *request){
+  int32_t arg = request->arg;
+
+  switch(request->id){
+    case SHELL_CMD_PERIOD:
+      if(MS_PER_MIN % arg){
+          shell_reply(request->id, TELEMETRY_STATUS_RANGE, arg);
+          return;
+      }
+      app_set_sample_period(arg);
+      break;
+
+    case SHELL_CMD_ALARM:
+      alarm_set_threshold(0, sensor_to_raw(temp_sensor, arg),
+                          sensor_to_raw(temp_sensor, arg - CENTI(TEMP_ALARM_HYST)));
+      break;
+
+    case SHELL_CMD_RES:
+      sensor_set_resolution(temp_sensor, arg);
+      break;
+
+    case SHELL_CMD_SLEEP:
+      // blocking EMn keeps the core at EM(n-1) or above
+      if(shell_em_block < MAX_ENERGY_MODES){
+          sleep_unblock_mode(shell_em_block);
+      }
+      shell_em_block = arg + EM1;
+      sleep_block_mode(shell_em_block);
+      break;
+
+    case SHELL_CMD_DELTA:
+      report_set_delta(sensor_delta_to_raw(temp_sensor, arg));
+      break;
+
+    // the filter restarts from the next reading
+    case SHELL_CMD_BURST:
+      filter_config.burst = arg;
+      filter_open(&filter_config);
+      break;
+
+    case SHELL_CMD_MEDIAN:
+      filter_config.median = arg;
+      filter_open(&filter_config);
+      break;
+
+    case SHELL_CMD_EMA:
+      filter_config.ema_shift = arg;
+      filter_open(&filter_config);
+      break;
+
+    default:
+      EFM_ASSERT(false);
+      return;
+  }
+
+  shell_reply(request->id, TELEMETRY_STATUS_OK, arg);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Append a sample to the flash log
+ *
+ * @details
+ *  Samples are stored delta/varint encoded. A page is sealed before it could
+ *  split a sample and every page starts with a keyframe, so each committed
+ *  page decodes on its own. A dropped sample forces a keyframe since the
+ *  next delta would otherwise refer to a value the log never saw.
+ *
+ * @param [in] raw
+ *  Raw sensor reading
+ *
+ ******************************************************************************/
+void app_log_sample(uint32_t raw){
+  uint8_t record[CODEC_MAX_BYTES];
+
+  if(flash_log_space() < CODEC_MAX_BYTES){
+      flash_log_flush();
+  }
+  if(flash_log_space() == FLASH_LOG_PAYLOAD_SIZE){
+      codec_keyframe(&log_codec);
+  }
+
+  uint32_t len = codec_encode(&log_codec, raw, record);
+  if(!flash_log_write(record, len)){
+      codec_keyframe(&log_codec);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Show a status on the LEDs
+ *
+ * @details
+ *  The LEDs are driven by the LETIMER PWM outputs, so a status keeps blinking
+ *  through EM2/EM3 with no CPU involvement. Switching status only rewrites
+ *  COMP1 and the route enables, and nothing is written if the status is
+ *  unchanged.
+ *
+ * @param [in] status
+ *  LED status pattern to display
+ *
+ ******************************************************************************/
+void app_set_led_status(tLED_STATUS status){
+  EFM_ASSERT(status < LED_STATUS_COUNT);
+
+  if(status == led_status){
+      return;
+  }
+  led_status = status;
+
+  letimer_pwm_pattern(LETIMER0, led_pattern[status].active_period,
+                      led_pattern[status].led1, led_pattern[status].led0);
+}
+
+
 /***************************************************************************//**
  * @brief
  *  Setup the peripheral interrupts and scheduler
@@ -222,6 +704,7 @@ void app_peripheral_open(void){
   NVIC_EnableIRQ(GPIO_EVEN_IRQn);
   NVIC_EnableIRQ(LETIMER0_IRQn);
   NVIC_EnableIRQ(I2C0_IRQn);
+  NVIC_EnableIRQ(LEUART0_IRQn);
   scheduler_open();
 }
 
@@ -234,149 +717,279 @@ void app_peripheral_open(void){
  *  Setup multiple different peripherals that we are going to use in our
  *  application including the CMU, letimer, and GPIO. We also initialize the
  *  application state machine, start the timer, instantiate our sleep modes,
- *  and open our si7021 sensor for compatibility with the i2c.
+ *  and register our sensors, which opens the si7021 and the i2c.
  *
  ******************************************************************************/
 void app_peripheral_setup(void){
+	assert_log_open();
+	trace_open();
 	cmu_open();
+	PROF_OPEN();
+	app_latency_open();
 	app_peripheral_open();
 	sleep_open();
 	app_letimer_pwm_open(PWM_PER, PWM_ACT_PER, OUT0_ROUTE, OUT1_ROUTE);
 	app_gpio_open();
 	app_init_state_machine();
+	app_set_led_status(LED_STATUS_NORMAL);
+	app_sensor_open();
+	app_alarm_open();
+	app_stats_open();
+	app_filter_open();
+	app_report_open();
+	history_open(app_samples(60u));
+	flash_log_open(FLASH_LOG_CB);
+	codec_init(&log_codec, CODEC_KEYFRAME_INTERVAL);
+	app_telemetry_open();
 	letimer_start(LETIMER0, ENABLE);
-  si7021_open();
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Using scheduler to handle a GPIO even IRQ
+ *  Using scheduler to determine what button was
  *
  * @details
- *  Schedule a button 0 call back
+ *  Delivers the press to the energy mode state machine. The counter machine
+ *  is not fed while the buttons cycle energy modes, since its LEDs are
+ *  driven by the LETIMER status patterns.
  *
  ******************************************************************************/
-void scheduled_gpio_even_irq_cb(void){
-  add_scheduled_event(APP_BTN0_CB);               // add event for btn0 press
+void scheduled_record_button_press_cb(uint32_t button){
+  if(button == APP_BTN0_CB){
+      sm_dispatch(&em_sm, APP_EV_BTN0);
+  }
+  if(button == APP_BTN1_CB){
+      sm_dispatch(&em_sm, APP_EV_BTN1);
+  }
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Using scheduler to handle a GPIO odd IRQ
+ *  Call back function for comp0 interrupt
  *
  * @details
- *  Schedule a button 1 call back
+ *  Handles a scheduled event call back for the comp0 interrupt within letimer
  *
  ******************************************************************************/
-void scheduled_gpio_odd_irq_cb(void){
-  add_scheduled_event(APP_BTN1_CB);               // add event for btn1 press
+void scheduled_letimer_comp0_cb(void){
+
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Using scheduler to determine what button was
+ *  Call back function for comp1 interrupt
  *
  * @details
- *  Update state machine struct and schedule a state machine check
+ *  Handles a scheduled event call back for the comp1 interrupt within letimer
  *
  ******************************************************************************/
-void scheduled_record_button_press_cb(uint32_t button){
-  if(button == APP_BTN0_CB){
-      //p->btn0 = PRESS;
-      uint32_t current_block_em = current_block_energy_mode();
-      sleep_unblock_mode(current_block_em);
-      if(current_block_em > EM0){
-          sleep_block_mode(current_block_em - EM1);
-      }
-      else{
-          sleep_block_mode(EM4);
-      }
-  }
-  if(button == APP_BTN1_CB){
-      //p->btn1 = PRESS;
-      uint32_t current_block_em = current_block_energy_mode();
-      sleep_unblock_mode(current_block_em);
-      if(current_block_em < EM4){
-          sleep_block_mode(current_block_em + EM1);
-      }
-      else{
-          sleep_block_mode(EM0);
-      }
-  }
-  //p->num_press++;
-  //add_scheduled_event(APP_CHK_INPUT_CB);
+void scheduled_letimer_comp1_cb(void){
+
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Call back function for comp0 interrupt
+ *  Start a sample of every registered sensor
  *
  * @details
- *  Handles a scheduled event call back for the comp0 interrupt within letimer
+ *  The sampler refuses while the previous sample is still under way. That
+ *  sample still ends in scheduled_sensor_sample_cb(), so a burst carries on
+ *  from there, and the skip only shows up in the trace.
  *
  ******************************************************************************/
-void scheduled_letimer_comp0_cb(void){
-
+static void app_sample(void){
+  if(!sensor_sample()){
+      trace(TRACE_SAMPLE_SKIP, ++samples_skipped);
+  }
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Call back function for comp1 interrupt
+ *  Call back function for uf interrupt
  *
  * @details
- *  Handles a scheduled event call back for the comp1 interrupt within letimer
+ *  Handles a scheduled event call back for the uf interrupt within the letimer
+ *  by starting a sample of every registered sensor
  *
  ******************************************************************************/
-void scheduled_letimer_comp1_cb(void){
-
+void scheduled_letimer_uf_cb(void){
+  app_sample();
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Call back function for uf interrupt
+ *  Call back function for a completed sample
  *
  * @details
- *  Handles a scheduled event call back for the uf interrupt within the letimer
+ *  Every registered sensor has been read. Hands the temperature reading to
+ *  the noise filter. While a burst is under way the next sample starts right
+ *  away, back to back on the bus within the same wake window. Once the
+ *  filter has a sample it goes through the alarm engine and the summary
+ *  statistics, and into the trend history. Samples the send-on-delta filter
+ *  lets through are also appended to the flash log and queued for
+ *  telemetry. The alarms, statistics and history see every sample, they are
+ *  cheap and the rate alarm and the windows assume one sample per period.
+ *  Nothing else happens here unless an alarm changes state or a window
+ *  completes, in which case scheduled_alarm_cb() or scheduled_stats_cb()
+ *  follows.
  *
  ******************************************************************************/
-void scheduled_letimer_uf_cb(void){
-  si7021_read(SI7021_TEMP_READ_CB);
+void scheduled_sensor_sample_cb(void){
+  if(!filter_add(sensor_get_raw(temp_sensor))){
+      app_sample();
+      return;
+  }
+
+  uint32_t raw_data = filter_get();
+
+  alarm_update(raw_data);
+  stats_update(raw_data);
+  history_insert(raw_data);
+  if(report_filter(raw_data)){
+      app_log_sample(raw_data);
+      telemetry_add_sample(raw_data);
+  }
 }
 
 
 /***************************************************************************//**
  * @brief
- *  Call back function for i2c read
+ *  Call back function for an alarm state change
  *
  * @details
- *  Converts the raw data into a standard temperature value using the Si7021
- *  datasheet for the conversion. Turns on LED1 if the value is greater than
- *  or equal to the ambient temp, otherwise it turns it off.
+ *  Shows the alarm LED pattern while the temperature is at or above the
+ *  ambient temp or rising quickly, otherwise the normal pattern, and reports
+ *  the change over telemetry.
  *
  ******************************************************************************/
-void scheduled_read_i2c_cb(void){
-  uint32_t raw_data = si7021_get_raw_data();
+void scheduled_alarm_cb(void){
+  uint8_t event[TELEMETRY_EVENT_SIZE];
 
-  float temp = si7021_calc_temp(raw_data);
+  telemetry_put32(&event[TELEMETRY_EVENT_STATE], alarm_get_state());
+  telemetry_put32(&event[TELEMETRY_EVENT_CHANGED], alarm_get_changed());
+  telemetry_put16(&event[TELEMETRY_EVENT_RAW], filter_get());
+  telemetry_send(TELEMETRY_EVENT, event, TELEMETRY_EVENT_SIZE);
 
-  if(temp >= AMBIENT_TEMP){
-      GPIO_PinOutSet(LED1_PORT, LED1_PIN);              // LED1 ON
-      GPIO_PinOutClear(LED0_PORT, LED0_PIN);            // LED0 OFF
+  if(alarm_get_state() & (TEMP_ALARM_BIT | TEMP_RATE_BIT)){
+      app_set_led_status(LED_STATUS_ALARM);
   }
   else{
-      GPIO_PinOutClear(LED1_PORT, LED1_PIN);            // LED1 OFF
-      GPIO_PinOutClear(LED0_PORT, LED0_PIN);            // LED0 OFF
+      app_set_led_status(LED_STATUS_NORMAL);
   }
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *  Call back function for a completed statistics window
+ *
+ * @details
+ *  Collects the summary of the window that just closed and sends it over
+ *  telemetry, with the number of readings the send-on-delta filter let
+ *  through since the last one. This is the one record per window handed to
+ *  logging and uplink. A memory usage record follows it from
+ *  app_send_reports().
+ *
+ ******************************************************************************/
+void scheduled_stats_cb(void){
+  static uint32_t last_forwarded;
+  STATS_Summary_TypeDef summary;
+  REPORT_Stats_TypeDef report;
+  uint8_t record[TELEMETRY_SUMMARY_SIZE];
+
+  stats_get_summary(&summary);
+  report_get_stats(&report);
+
+  telemetry_put32(&record[TELEMETRY_SUMMARY_SEQ], summary.seq);
+  telemetry_put16(&record[TELEMETRY_SUMMARY_COUNT], summary.count);
+  telemetry_put16(&record[TELEMETRY_SUMMARY_MIN], summary.min);
+  telemetry_put16(&record[TELEMETRY_SUMMARY_MAX], summary.max);
+  telemetry_put16(&record[TELEMETRY_SUMMARY_MEAN], summary.mean);
+  telemetry_put32(&record[TELEMETRY_SUMMARY_VARIANCE], summary.variance);
+  telemetry_put16(&record[TELEMETRY_SUMMARY_REPORTED], report.forwarded - last_forwarded);
+  last_forwarded = report.forwarded;
+  telemetry_send(TELEMETRY_SUMMARY, record, TELEMETRY_SUMMARY_SIZE);
+  memory_report_due = true;
+}
+
 
+/***************************************************************************//**
+ * @brief
+ *  Call back function for the flash log
+ *
+ * @details
+ *  Runs one step of the pending flash page commit. The log posts this event
+ *  again until the page is committed.
+ *
+ ******************************************************************************/
+void scheduled_flash_log_cb(void){
+  flash_log_commit();
+}
 
 
 
+/***************************************************************************//**
+ * @brief
+ *  Call back function for a finished telemetry transmit
+ *
+ * @details
+ *  Frees the frame buffer that just went out and starts the next one, then
+ *  sends a deferred record if one is due.
+ *
+ ******************************************************************************/
+void scheduled_telemetry_tx_cb(void){
+  telemetry_tx_done();
+  app_send_reports();
+}
+
+
+
+/***************************************************************************//**
+ * @brief
+ *  Call back function for bytes received on the LEUART
+ *
+ * @details
+ *  Parses the buffered bytes and applies every complete command. This runs
+ *  at scheduler level like any other event, so a command never delays the
+ *  sensor interrupts.
+ *
+ ******************************************************************************/
+void scheduled_shell_rx_cb(void){
+  SHELL_Request_TypeDef request;
+
+  while(shell_poll(&request)){
+      app_shell_command(&request);
+  }
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Call back function for a sensor bus transfer
+ *
+ * @details
+ *  Moves the sampler on to the next start or collect.
+ *
+ ******************************************************************************/
+void scheduled_sensor_step_cb(void){
+  sensor_step();
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Call back function for a sensor bus transfer the device refused
+ *
+ * @details
+ *  The sampler traces it and carries on with the sample.
+ *
+ ******************************************************************************/
+void scheduled_sensor_error_cb(void){
+  sensor_error();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file assert_log.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Failed cheap tier assertions, kept in RAM across resets
+ *
+ * @details
+ *  The log lives in RETAINED RAM, which startup neither clears nor
+ *  initialises. A magic word tells a log that survived a reset from the
+ *  random contents RAM comes up with after power on.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "assert_log.h"
+#include "em_core.h"
+#include "trace.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define ASSERT_LOG_MAGIC        0xA55E7106u
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef struct{
+  uint32_t magic;
+  uint32_t count;                           // failures since the log was cleared
+  ASSERT_LOG_Entry_TypeDef entry[ASSERT_LOG_ENTRIES];
+} tASSERT_LOG;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static RETAINED tASSERT_LOG retained_log;
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Keep a log that survived the reset, start an empty one otherwise
+*
+******************************************************************************/
+void assert_log_open(void){
+  if(retained_log.magic != ASSERT_LOG_MAGIC){
+      assert_log_clear();
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Record a failed assertion and carry on
+*
+* @details
+*  Safe from any context. Reached through TIERED_ASSERT() only when a check
+*  fails, so the critical section costs nothing on the normal path.
+*
+* @param [in] file
+*  Source file of the check
+*
+* @param [in] line
+*  Line of the check
+*
+******************************************************************************/
+void assert_log(const char *file, int line){
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  ASSERT_LOG_Entry_TypeDef *e = &retained_log.entry[retained_log.count % ASSERT_LOG_ENTRIES];
+  e->file = file;
+  e->line = (uint32_t)line;
+  retained_log.count++;
+  CORE_EXIT_CRITICAL();
+
+  trace(TRACE_ASSERT, (uint32_t)line);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Failures recorded since the log was cleared, including ones that no
+*  longer fit
+*
+******************************************************************************/
+uint32_t assert_log_count(void){
+  return retained_log.count;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Read back one recorded failure
+*
+* @param [in] age
+*  0 for the most recent failure, 1 for the one before, and so on
+*
+* @param [in] entry
+*  Filled in when the failure is still held
+*
+* @return
+*  false when fewer than age + 1 failures are held
+*
+******************************************************************************/
+bool assert_log_get(uint32_t age, ASSERT_LOG_Entry_TypeDef *entry){
+  if(age >= retained_log.count || age >= ASSERT_LOG_ENTRIES){
+      return false;
+  }
+  *entry = retained_log.entry[(retained_log.count - 1u - age) % ASSERT_LOG_ENTRIES];
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Empty the log
+*
+******************************************************************************/
+void assert_log_clear(void){
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  for(uint32_t i = 0; i < ASSERT_LOG_ENTRIES; i++){
+      retained_log.entry[i] = (ASSERT_LOG_Entry_TypeDef){ 0 };
+  }
+  retained_log.count = 0;
+  retained_log.magic = ASSERT_LOG_MAGIC;
+  CORE_EXIT_CRITICAL();
+}
@@ -45,9 +45,10 @@ void cmu_open(void){
     //CMU_OscillatorEnable(cmuOsc_ULFRCO, true, true);  // this is enabled by default
 
 		CMU_OscillatorEnable(cmuOsc_LFRCO, false, false);	  // By default, LFRCO is enabled
-		CMU_OscillatorEnable(cmuOsc_LFXO, false, false);		// Disable LFXO
+		CMU_OscillatorEnable(cmuOsc_LFXO, true, true);		// LFXO for the LEUART baud clock
 
 		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_ULFRCO);	// routing clock to LFA
+		CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFXO);		// routing clock to LFB (LEUART)
 
 		CMU_ClockEnable(cmuClock_CORELE, true);
 
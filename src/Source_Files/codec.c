@@ -0,0 +1,170 @@
+/**
+ * @file codec.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Compact encoding of raw sensor samples for logging and streaming
+ *
+ * @details
+ *  Each sample is one varint (7 bits per byte, high bit set on all but the
+ *  last byte). Bit 0 of the value tags the sample: a keyframe carries the raw
+ *  value, a delta carries the zig-zag encoded difference from the previous
+ *  sample. A slow moving temperature changes by a few codes per sample, so
+ *  most samples take one byte instead of two. Keyframes are sent every
+ *  CODEC_KEYFRAME_INTERVAL samples and can be forced at the start of each
+ *  storage or transmit unit, so a reader that joins late or loses a unit
+ *  resumes at the next keyframe.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "codec.h"
+
+// the host telemetry decoder builds this file without the emlib headers
+#ifdef PROF_ENABLE
+#include "prof.h"
+#else
+#define PROF_BEGIN(id)      ((void)0)
+#define PROF_END(id)        ((void)0)
+#endif
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start a stream
+*
+* @param [in] codec
+*  Stream state
+*
+* @param [in] keyframe_interval
+*  Samples between keyframes, 1 sends every sample as a keyframe
+*
+******************************************************************************/
+void codec_init(CODEC_State_TypeDef *codec, uint32_t keyframe_interval){
+  codec->prev = 0;
+  codec->since_key = 0;
+  codec->interval = keyframe_interval;
+  codec->synced = false;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Make the next encoded sample a keyframe
+*
+* @details
+*  Used when a stream is split, for example at a flash page boundary or when
+*  an encoded sample could not be stored, so the next unit decodes on its own.
+*
+******************************************************************************/
+void codec_keyframe(CODEC_State_TypeDef *codec){
+  codec->synced = false;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Encode one sample
+*
+* @param [in] codec
+*  Stream state
+*
+* @param [in] raw
+*  Raw 16 bit sample
+*
+* @param [out] out
+*  At least CODEC_MAX_BYTES bytes
+*
+* @return
+*  Bytes written to out
+*
+******************************************************************************/
+uint32_t codec_encode(CODEC_State_TypeDef *codec, uint32_t raw, uint8_t *out){
+  PROF_BEGIN(PROF_CODEC_ENCODE);
+  uint32_t value;
+  uint32_t len = 0;
+
+  if(!codec->synced || ++codec->since_key >= codec->interval){
+      value = (raw << 1) | CODEC_TAG_KEYFRAME;
+      codec->since_key = 0;
+      codec->synced = true;
+  }
+  else{
+      int32_t delta = (int16_t)(raw - codec->prev);           // wraps like the 16 bit sample
+      uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+      value = zigzag << 1;
+  }
+  codec->prev = raw;
+
+  while(value >= CODEC_VARINT_MORE){
+      out[len++] = (value & ~CODEC_VARINT_MORE) | CODEC_VARINT_MORE;
+      value >>= CODEC_VARINT_BITS;
+  }
+  out[len++] = value;
+
+  PROF_END(PROF_CODEC_ENCODE);
+  return len;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Decode one sample
+*
+* @details
+*  Deltas decoded while the stream is not synced are consumed but meaningless,
+*  so a reader that joins a stream part way, or calls codec_keyframe() after
+*  losing a unit, skips samples until the next keyframe. Decoding must start
+*  on a sample boundary, which every unit (flash page, frame) begins with.
+*
+* @param [in] codec
+*  Stream state
+*
+* @param [in] in
+*  Encoded bytes
+*
+* @param [in] len
+*  Bytes available at in
+*
+* @param [out] raw
+*  Decoded sample, valid when the return value is non zero and codec->synced
+*
+* @return
+*  Bytes consumed, 0 if in does not hold a complete sample
+*
+******************************************************************************/
+uint32_t codec_decode(CODEC_State_TypeDef *codec, const uint8_t *in, uint32_t len, uint16_t *raw){
+  uint32_t value = 0;
+  uint32_t used = 0;
+
+  do{
+      if(used == len || used == CODEC_MAX_BYTES){
+          return 0;
+      }
+      value |= (uint32_t)(in[used] & ~CODEC_VARINT_MORE) << (CODEC_VARINT_BITS * used);
+  }while(in[used++] & CODEC_VARINT_MORE);
+
+  if(value & CODEC_TAG_KEYFRAME){
+      codec->prev = value >> 1;
+      codec->synced = true;
+  }
+  else{
+      uint32_t zigzag = value >> 1;
+      int32_t delta = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1u);
+      codec->prev += delta;
+  }
+
+  *raw = codec->prev;
+  return used;
+}
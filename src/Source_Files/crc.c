@@ -0,0 +1,51 @@
+/**
+ * @file crc.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  CRC used to protect stored and transmitted records
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "crc.h"
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  CRC-16/CCITT (polynomial 0x1021)
+*
+* @details
+*  Bytewise form without a lookup table, so it costs no flash beyond the
+*  code itself. Pass CRC16_INIT to start, or a previous result to continue
+*  over more data.
+*
+* @param [in] crc
+*  Seed or running CRC
+*
+* @param [in] data
+*  Bytes to add
+*
+* @param [in] len
+*  Number of bytes
+*
+******************************************************************************/
+uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t len){
+  while(len--){
+      uint8_t x = (crc >> 8) ^ *data++;
+      x ^= x >> 4;
+      crc = (crc << 8) ^ ((uint16_t)x << 12) ^ ((uint16_t)x << 5) ^ x;
+  }
+  return crc;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file filter.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Noise filtering of the raw sensor readings, in fixed point
+ *
+ * @details
+ *  Readings go through up to three stages, each one optional:
+ *   - burst, the mean of burst readings taken back to back makes one sample,
+ *     uncorrelated noise drops by sqrt(burst)
+ *   - median of 3, a single spike never reaches the output, a step is
+ *     delayed by one sample
+ *   - EMA, y += (x - y) / 2^ema_shift, noise drops by
+ *     sqrt(2^(ema_shift + 1) - 1) at the cost of a lag of about
+ *     2^ema_shift samples
+ *
+ *  The EMA state carries FILTER_EMA_FRAC fractional bits so small steps are
+ *  not lost to truncation. Every stage starts from the first sample instead
+ *  of ramping up from zero.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "filter.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static FILTER_Open_TypeDef config;
+static uint32_t burst_sum;
+static uint32_t burst_count;
+static uint32_t window[3];                // last three burst means, newest in [0]
+static uint32_t samples;                  // burst means seen, saturates at 3
+static int32_t ema;                       // raw units << FILTER_EMA_FRAC
+static uint32_t output;
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Median of three values
+*
+******************************************************************************/
+static uint32_t filter_median3(uint32_t a, uint32_t b, uint32_t c){
+  uint32_t lo = a < b ? a : b;
+  uint32_t hi = a < b ? b : a;
+
+  if(c <= lo){
+      return lo;
+  }
+  return c < hi ? c : hi;
+}
+
+//***********************************************************************************
+// Global functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Configure the stages and forget earlier readings
+*
+* @param [in] filter_open
+*  Burst length, median and EMA weight
+*
+******************************************************************************/
+void filter_open(FILTER_Open_TypeDef *filter_open){
+  EFM_ASSERT(filter_open->burst >= 1 && filter_open->burst <= FILTER_MAX_BURST);
+  EFM_ASSERT(filter_open->ema_shift <= FILTER_MAX_EMA_SHIFT);
+
+  config = *filter_open;
+  burst_sum = 0;
+  burst_count = 0;
+  samples = 0;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add one reading
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+* @return
+*  true when the reading completed a sample, filter_get() then returns it.
+*  false while more readings of the burst are due.
+*
+******************************************************************************/
+bool filter_add(uint32_t raw){
+  burst_sum += raw;
+  if(++burst_count < config.burst){
+      return false;
+  }
+
+  uint32_t x = (burst_sum + config.burst / 2) / config.burst;
+  burst_sum = 0;
+  burst_count = 0;
+
+  window[2] = window[1];
+  window[1] = window[0];
+  window[0] = x;
+  if(samples < 3){
+      samples++;
+  }
+  if(config.median && samples == 3){
+      x = filter_median3(window[0], window[1], window[2]);
+  }
+
+  if(config.ema_shift){
+      int32_t target = (int32_t)(x << FILTER_EMA_FRAC);
+
+      if(samples == 1){
+          ema = target;
+      }
+      ema += (target - ema) >> config.ema_shift;
+      x = (uint32_t)(ema + (1 << (FILTER_EMA_FRAC - 1))) >> FILTER_EMA_FRAC;
+  }
+
+  output = x;
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Latest filtered sample
+*
+* @return
+*  Raw units
+*
+******************************************************************************/
+uint32_t filter_get(void){
+  return output;
+}
@@ -0,0 +1,382 @@
+/**
+ * @file flash_log.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Persistent record log in internal flash
+ *
+ * @details
+ *  A page erase stalls every fetch from flash for about 20 ms, and the
+ *  vector table and the handlers live there, RAM_HOT_PATHS or not. Interrupts
+ *  that arrive during an erase wait it out. The sampling path only loses
+ *  time, the I2C master holds the bus and the LETIMER keeps counting, but a
+ *  LEUART byte can be overrun. Splitting the commit keeps thread mode free
+ *  between steps, but each erase still holds up the whole core.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "flash_log.h"
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef enum{
+  LOG_IDLE,
+  LOG_ERASE,
+  LOG_PROGRAM,
+  LOG_SEAL
+} tLOG_STATE;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+// page images are built in RAM and committed a whole page at a time
+static uint32_t page_buf[2][FLASH_PAGE_SIZE / sizeof(uint32_t)];
+static bool page_pending[2];          // sealed, waiting for or in the middle of a commit
+static uint32_t fill;                 // buffer taking new records
+
+static tLOG_STATE state;
+static uint32_t commit_buf;           // buffer being committed
+static uint32_t commit_offset;        // bytes of commit_buf already programmed
+static uint32_t commit_size;          // bytes of commit_buf to program
+
+static uint32_t next_page;            // round robin position in the log region
+static uint32_t next_seq;
+static uint32_t next_record;          // records logged since the log was created
+static uint32_t log_cb;
+
+static FLASH_LOG_Stats_TypeDef log_stats;
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Address of a page in the log region
+*
+******************************************************************************/
+static uint32_t *flash_log_page(uint32_t page){
+  return (uint32_t *)(FLASH_LOG_START + page * FLASH_PAGE_SIZE);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Check that a page holds a complete commit
+*
+******************************************************************************/
+static bool flash_log_valid(const FLASH_LOG_Header_TypeDef *header){
+  if(header->magic != FLASH_LOG_MAGIC || header->length > FLASH_LOG_PAYLOAD_SIZE){
+      return false;
+  }
+  return header->crc == crc16(CRC16_INIT, (const uint8_t *)(header + 1), header->length);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Empty a page buffer so it can take records
+*
+******************************************************************************/
+static void flash_log_reset_buf(uint32_t buf){
+  FLASH_LOG_Header_TypeDef *header = (FLASH_LOG_Header_TypeDef *)page_buf[buf];
+  header->magic = FLASH_LOG_ERASED;
+  header->first_record = next_record;
+  header->records = 0;
+  header->length = 0;
+  header->reserved = 0;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Start committing a sealed buffer
+*
+******************************************************************************/
+static void flash_log_start_commit(uint32_t buf){
+  FLASH_LOG_Header_TypeDef *header = (FLASH_LOG_Header_TypeDef *)page_buf[buf];
+
+  header->seq = next_seq;
+  header->crc = crc16(CRC16_INIT, (const uint8_t *)(header + 1), header->length);
+
+  commit_buf = buf;
+  commit_offset = sizeof(uint32_t);                                   // magic goes last
+  commit_size = (FLASH_LOG_HEADER_SIZE + header->length + 3u) & ~3u;  // whole words
+  state = LOG_ERASE;
+  add_scheduled_event(log_cb);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Seal the buffer being filled and switch to the other one
+*
+* @return
+*  false if the other buffer is still being committed
+*
+******************************************************************************/
+static bool flash_log_seal(void){
+  uint32_t other = fill ^ 1u;
+
+  if(page_pending[other]){
+      return false;
+  }
+
+  page_pending[fill] = true;
+  if(state == LOG_IDLE){
+      flash_log_start_commit(fill);
+  }
+
+  fill = other;
+  flash_log_reset_buf(fill);
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Open the log
+*
+* @details
+*  Scans the log region for the newest valid page and resumes after it, so
+*  logging continues across resets and wear is spread over every page in the
+*  region in turn. The image must end before the region, see FLASH_LOG_START.
+*
+* @param [in] cb
+*  Event used to run the page commit from the scheduler (unique for scheduler)
+*
+******************************************************************************/
+void flash_log_open(uint32_t cb){
+  const FLASH_LOG_Header_TypeDef *newest = NULL;
+  uint32_t newest_page = 0;
+
+  EFM_ASSERT(FLASH_LOG_IMAGE_END <= FLASH_LOG_START);
+
+  MSC_Init();
+
+  for(uint32_t page = 0; page < FLASH_LOG_PAGES; page++){
+      const FLASH_LOG_Header_TypeDef *header = (const FLASH_LOG_Header_TypeDef *)flash_log_page(page);
+      if(flash_log_valid(header) && (!newest || (int32_t)(header->seq - newest->seq) > 0)){
+          newest = header;
+          newest_page = page;
+      }
+  }
+
+  if(newest){
+      next_page = (newest_page + 1) % FLASH_LOG_PAGES;
+      next_seq = newest->seq + 1;
+      next_record = newest->first_record + newest->records;
+  }
+  else{
+      next_page = 0;
+      next_seq = 0;
+      next_record = 0;
+  }
+
+  log_cb = cb;
+  state = LOG_IDLE;
+  page_pending[0] = false;
+  page_pending[1] = false;
+  fill = 0;
+  flash_log_reset_buf(fill);
+  memset(&log_stats, 0, sizeof(log_stats));
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Append a record
+*
+* @details
+*  Only copies into the RAM page buffer, so it is cheap enough for the
+*  sampling path. A full buffer is sealed and committed from the scheduler
+*  while the other buffer takes new records. Records never span pages.
+*
+* @param [in] record
+*  Record bytes
+*
+* @param [in] len
+*  Record length, at most FLASH_LOG_PAYLOAD_SIZE
+*
+* @return
+*  false if the record was dropped because both buffers are busy
+*
+******************************************************************************/
+bool flash_log_write(const void *record, uint32_t len){
+  EFM_ASSERT(len && len <= FLASH_LOG_PAYLOAD_SIZE);
+  FLASH_LOG_Header_TypeDef *header = (FLASH_LOG_Header_TypeDef *)page_buf[fill];
+
+  if(header->length + len > FLASH_LOG_PAYLOAD_SIZE && !flash_log_seal()){
+      log_stats.dropped++;
+      return false;
+  }
+
+  header = (FLASH_LOG_Header_TypeDef *)page_buf[fill];
+  memcpy((uint8_t *)(header + 1) + header->length, record, len);
+  header->length += len;
+  header->records++;
+  next_record++;
+
+  log_stats.records++;
+  log_stats.payload_bytes += len;
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the room left in the page being filled
+*
+* @details
+*  FLASH_LOG_PAYLOAD_SIZE means the next record starts a new page, which lets
+*  a writer begin every page with a self contained record.
+*
+******************************************************************************/
+uint32_t flash_log_space(void){
+  const FLASH_LOG_Header_TypeDef *header = (const FLASH_LOG_Header_TypeDef *)page_buf[fill];
+  return FLASH_LOG_PAYLOAD_SIZE - header->length;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Commit the partially filled page
+*
+* @details
+*  A writer that needs each page to start on a record boundary of its own,
+*  such as app_log_sample() starting every page with a keyframe, calls this
+*  once flash_log_space() is below its longest record. The page then goes
+*  out at most that many bytes short of full, so it costs no extra erases.
+*  Called on a page with little in it, e.g. before a planned shutdown or
+*  dump, it wears a page early.
+*
+******************************************************************************/
+void flash_log_flush(void){
+  FLASH_LOG_Header_TypeDef *header = (FLASH_LOG_Header_TypeDef *)page_buf[fill];
+
+  if(header->length){
+      flash_log_seal();
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Run the next step of a page commit
+*
+* @details
+*  Called from the scheduler. The commit is split into the erase, a
+*  FLASH_LOG_CHUNK sized write per call and finally the magic word, posting
+*  the log event again between steps so other events, sampling included,
+*  are serviced in between rather than waiting on the whole page. The erase
+*  step itself stalls the core for about 20 ms.
+*
+******************************************************************************/
+void flash_log_commit(void){
+  uint32_t *page = flash_log_page(next_page);
+  const uint8_t *src = (const uint8_t *)page_buf[commit_buf];
+  uint32_t len;
+
+  switch(state){
+    case LOG_ERASE:
+      MSC_ErasePage(page);
+      log_stats.erases++;
+      state = LOG_PROGRAM;
+      break;
+
+    case LOG_PROGRAM:
+      len = commit_size - commit_offset;
+      if(len > FLASH_LOG_CHUNK){
+          len = FLASH_LOG_CHUNK;
+      }
+      MSC_WriteWord((uint32_t *)((uint8_t *)page + commit_offset), src + commit_offset, len);
+      log_stats.programmed_bytes += len;
+      commit_offset += len;
+      if(commit_offset == commit_size){
+          state = LOG_SEAL;
+      }
+      break;
+
+    case LOG_SEAL:
+      {
+        uint32_t magic = FLASH_LOG_MAGIC;
+        MSC_WriteWord(page, &magic, sizeof(magic));
+        log_stats.programmed_bytes += sizeof(magic);
+        log_stats.pages++;
+      }
+      page_pending[commit_buf] = false;
+      next_page = (next_page + 1) % FLASH_LOG_PAGES;
+      next_seq++;
+      state = LOG_IDLE;
+      if(page_pending[commit_buf ^ 1u]){
+          flash_log_start_commit(commit_buf ^ 1u);
+      }
+      return;
+
+    case LOG_IDLE:
+    default:
+      return;
+  }
+
+  add_scheduled_event(log_cb);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Read a committed page
+*
+* @param [in] age
+*  0 for the newest committed page, FLASH_LOG_PAGES - 1 for the oldest
+*
+* @param [out] header
+*  Page header, in flash
+*
+* @param [out] payload
+*  Page payload, in flash
+*
+* @return
+*  false if that page is not valid (never written, torn or being replaced)
+*
+******************************************************************************/
+bool flash_log_read(uint32_t age, const FLASH_LOG_Header_TypeDef **header, const uint8_t **payload){
+  if(age >= FLASH_LOG_PAGES){
+      return false;
+  }
+
+  uint32_t page = (next_page + FLASH_LOG_PAGES - 1 - age) % FLASH_LOG_PAGES;
+  const FLASH_LOG_Header_TypeDef *h = (const FLASH_LOG_Header_TypeDef *)flash_log_page(page);
+
+  if(!flash_log_valid(h)){
+      return false;
+  }
+
+  *header = h;
+  *payload = (const uint8_t *)(h + 1);
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the log counters
+*
+* @details
+*  Write amplification is programmed_bytes / payload_bytes.
+*
+******************************************************************************/
+void flash_log_get_stats(FLASH_LOG_Stats_TypeDef *stats){
+  *stats = log_stats;
+}
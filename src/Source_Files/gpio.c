@@ -20,8 +20,7 @@
 //***********************************************************************************
 // private variables
 //***********************************************************************************
-static uint32_t gpio_even_irq_cb = GPIO_EVEN_IRQ_CB;
-static uint32_t gpio_odd_irq_cb = GPIO_ODD_IRQ_CB;
+static uint32_t exti_route[GPIO_EXTI_LINES];     // scheduler event posted per EXTI line
 
 //***********************************************************************************
 // function prototypes
@@ -31,6 +30,40 @@ static uint32_t gpio_odd_irq_cb = GPIO_ODD_IRQ_CB;
 // functions
 //***********************************************************************************
 
+/***************************************************************************//**
+* @brief
+*  Route an external interrupt line to a scheduler event
+*
+* @details
+*  Configures the EXTI line matching the pin number and records which event
+*  the GPIO interrupt handlers post when the line fires. Any pin can be added
+*  this way without touching the interrupt handlers.
+*
+*  @param [in] port
+*   GPIO port of the interrupt source
+*
+*  @param [in] pin
+*   GPIO pin of the interrupt source, also used as the EXTI line number
+*
+*  @param [in] rising
+*   Trigger on a rising edge
+*
+*  @param [in] falling
+*   Trigger on a falling edge
+*
+*  @param [in] cb
+*   Event added to the scheduler when the line fires
+*
+******************************************************************************/
+void gpio_exti_open(GPIO_Port_TypeDef port, uint32_t pin, bool rising, bool falling, uint32_t cb){
+  EFM_ASSERT(pin < GPIO_EXTI_LINES);
+
+  exti_route[pin] = cb;
+  GPIO->IFC = 1u << pin;                              // clear stale flag on this line
+  GPIO_ExtIntConfig(port, pin, pin, rising, falling, true);
+}
+
+
 /***************************************************************************//**
 * @brief
 *  Enable the interrupts for GPIO peripheral
@@ -47,12 +80,10 @@ void gpio_start(GAME_GPIO_TypeDef *game_gpio){
 
   // configure button interrupts
     if(game_gpio->btn0_irq_enable){
-        GPIO->IFC = GPIO_EVEN_INT_PIN_6_MASK;       // clear flag on interrupt pin 6
-        GPIO_ExtIntConfig(game_gpio->btn0_port, game_gpio->btn0_pin, game_gpio->btn0_pin, false, true, game_gpio->btn0_irq_enable);
+        gpio_exti_open(game_gpio->btn0_port, game_gpio->btn0_pin, false, true, game_gpio->btn0_cb);
     }
     if(game_gpio->btn1_irq_enable){
-        GPIO->IFC = GPIO_ODD_INT_PIN_7_MASK;       // clear flag on interrupt pin 7
-        GPIO_ExtIntConfig(game_gpio->btn1_port, game_gpio->btn1_pin, game_gpio->btn1_pin, false, true, game_gpio->btn1_irq_enable);
+        gpio_exti_open(game_gpio->btn1_port, game_gpio->btn1_pin, false, true, game_gpio->btn1_cb);
     }
 
 }
@@ -89,6 +120,11 @@ void gpio_open(GAME_GPIO_TypeDef* game_gpio){
 	GPIO_PinModeSet(SI7021_SCL_PORT, SI7021_SCL_PIN, SI7021_SCL_MODE, SCL_DEFAULT);
 	GPIO_PinModeSet(SI7021_SDA_PORT, SI7021_SDA_PIN, SI7021_SDA_MODE, SDA_DEFAULT);
 
+	// Configure LEUART pins
+	GPIO_DriveStrengthSet(LEUART0_TX_PORT, gpioDriveStrengthStrongAlternateWeak);
+	GPIO_PinModeSet(LEUART0_TX_PORT, LEUART0_TX_PIN, LEUART0_TX_MODE, LEUART0_TX_DEFAULT);
+	GPIO_PinModeSet(LEUART0_RX_PORT, LEUART0_RX_PIN, LEUART0_RX_MODE, LEUART0_RX_DEFAULT);
+
 	// Configure Button pins
   if(game_gpio->btn0_en){
       GPIO_DriveStrengthSet(BUT0_PORT, BUT0_DRIVE_STRENGTH);
@@ -106,40 +142,60 @@ void gpio_open(GAME_GPIO_TypeDef* game_gpio){
 
 /***************************************************************************//**
  * @brief
- *  GPIO Interrupt Handler for Even Interrupts
+ *  Post the scheduler events for every pending EXTI line
  *
  * @details
- *  Check what interrupt was called based on the flag and the interrupts enabled.
- *  Make sure that this corresponds to the pin 6 interrupt, or button 0.
- *  Clear the corresponding interrupt's flag and assert that it was properly
- *  cleared.
+ *  Reads the pending and enabled flags for the lines this handler owns, clears
+ *  them all at once and walks the set bits lowest first. The routed events are
+ *  combined so every pending line is served in a single interrupt entry.
  *
+ * @param [in] line_mask
+ *  EXTI lines owned by the calling interrupt handler
  *
  ******************************************************************************/
-void GPIO_EVEN_IRQHandler(void){
-  uint32_t flag = (((GPIO->IF) & (GPIO->IEN)) & GPIO_EVEN_INT_PIN_6_MASK);    // check pin 6 interrupt
-  GPIO->IFC = flag;                                                           // clear the flag
-  EFM_ASSERT(!(GPIO->IF & GPIO_EVEN_INT_PIN_6_MASK));                         // assert flag was properly cleared
-  add_scheduled_event(gpio_even_irq_cb);                                      // add the event to scheduler
+HOT_PATH static void gpio_exti_dispatch(uint32_t line_mask){
+  uint32_t flag = (GPIO->IF) & (GPIO->IEN) & line_mask;    // pending lines
+  uint32_t events = NO_EVENTS;
+
+  GPIO->IFC = flag;                                         // clear the flags
+  GPIO_ASSERT(!(GPIO->IF & flag));                           // assert flags were properly cleared
+
+  while(flag){
+      events |= exti_route[SL_CTZ(flag)];                   // lowest pending line
+      flag &= flag - 1;                                     // done with that line
+  }
+
+  if(events){
+      add_scheduled_event(events);                          // add the events to scheduler
+  }
 }
 
 
+/***************************************************************************//**
+ * @brief
+ *  GPIO Interrupt Handler for Even Interrupts
+ *
+ * @details
+ *  Serves every pending even EXTI line through the routing table
+ *
+ ******************************************************************************/
+HOT_PATH void GPIO_EVEN_IRQHandler(void){
+  PROF_BEGIN(PROF_GPIO_EVEN_IRQ);
+  gpio_exti_dispatch(GPIO_EXTI_EVEN_MASK);
+  PROF_END(PROF_GPIO_EVEN_IRQ);
+}
+
 
 /***************************************************************************//**
  * @brief
  *  GPIO Interrupt Handler for Odd Interrupts
  *
  * @details
- *  Check what interrupt was called based on the flag and the interrupts enabled.
- *  Make sure that this corresponds to the pin 7 interrupt, or button 1.
- *  Clear the corresponding interrupt's flag and assert that it was properly
- *  cleared.
- *
+ *  Serves every pending odd EXTI line through the routing table
  *
  ******************************************************************************/
-void GPIO_ODD_IRQHandler(void){
-  uint32_t flag = (((GPIO->IF) & (GPIO->IEN)) & GPIO_ODD_INT_PIN_7_MASK);     // check pin 7 interrupt
-  GPIO->IFC = flag;                                                           // clear the flag
-  EFM_ASSERT(!(GPIO->IF & GPIO_ODD_INT_PIN_7_MASK));                          // assert flag was properly cleared
-  add_scheduled_event(gpio_odd_irq_cb);                                      // add the event to scheduler
+HOT_PATH void GPIO_ODD_IRQHandler(void){
+  PROF_BEGIN(PROF_GPIO_ODD_IRQ);
+  gpio_exti_dispatch(GPIO_EXTI_ODD_MASK);
+  PROF_END(PROF_GPIO_ODD_IRQ);
 }
@@ -0,0 +1,220 @@
+/**
+ * @file history.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Multi-resolution trend history kept in RAM
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "history.h"
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// running min/mean/max for the entry currently being built in a tier
+typedef struct{
+  uint32_t sum;
+  uint16_t n;
+  uint16_t min;
+  uint16_t max;
+} tHISTORY_ACC;
+
+typedef struct{
+  HISTORY_Entry_TypeDef *ring;
+  uint16_t len;             // capacity of ring
+  uint16_t head;            // next slot to write
+  uint16_t count;           // valid entries, saturates at len
+  uint16_t per_entry;       // inputs rolled into one entry
+  tHISTORY_ACC acc;
+} tHISTORY_TIER_STATE;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static HISTORY_Entry_TypeDef minute_ring[HISTORY_MINUTE_LEN];
+static HISTORY_Entry_TypeDef quarter_ring[HISTORY_QUARTER_LEN];
+static HISTORY_Entry_TypeDef hour_ring[HISTORY_HOUR_LEN];
+
+static tHISTORY_TIER_STATE tier_state[HISTORY_TIERS] = {
+  [HISTORY_MINUTE]  = { minute_ring,  HISTORY_MINUTE_LEN,  0, 0, 1,                             { 0 } },
+  [HISTORY_QUARTER] = { quarter_ring, HISTORY_QUARTER_LEN, 0, 0, HISTORY_MINUTES_PER_QUARTER,   { 0 } },
+  [HISTORY_HOUR]    = { hour_ring,    HISTORY_HOUR_LEN,    0, 0, HISTORY_QUARTERS_PER_HOUR,     { 0 } },
+};
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Empty a roll-up accumulator
+*
+******************************************************************************/
+static void history_acc_reset(tHISTORY_ACC *acc){
+  acc->sum = 0;
+  acc->n = 0;
+  acc->min = UINT16_MAX;
+  acc->max = 0;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Roll an entry into a tier
+*
+* @details
+*  Adds the entry to the tier accumulator. When the accumulator holds
+*  per_entry inputs the finished entry is written to the ring, overwriting
+*  the oldest, and passed up to the next tier.
+*
+* @param [in] tier
+*  Tier receiving the input
+*
+* @param [in] in
+*  Entry from the tier below, or a raw sample with min == mean == max
+*
+******************************************************************************/
+static void history_roll(tHISTORY_TIER tier, const HISTORY_Entry_TypeDef *in){
+  tHISTORY_TIER_STATE *t = &tier_state[tier];
+  tHISTORY_ACC *acc = &t->acc;
+
+  acc->sum += in->mean;
+  if(in->min < acc->min) acc->min = in->min;
+  if(in->max > acc->max) acc->max = in->max;
+
+  if(++acc->n < t->per_entry){
+      return;
+  }
+
+  HISTORY_Entry_TypeDef *out = &t->ring[t->head];
+  out->min = acc->min;
+  out->max = acc->max;
+  out->mean = (acc->sum + acc->n / 2) / acc->n;
+
+  t->head = (t->head + 1 == t->len) ? 0 : t->head + 1;
+  if(t->count < t->len){
+      t->count++;
+  }
+  history_acc_reset(acc);
+
+  if(tier + 1 < HISTORY_TIERS){
+      history_roll(tier + 1, out);
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Clear the history
+*
+* @param [in] samples_per_minute
+*  Raw samples per minute, set by the sample period of the application
+*
+******************************************************************************/
+void history_open(uint32_t samples_per_minute){
+  EFM_ASSERT(samples_per_minute && samples_per_minute <= UINT16_MAX);
+
+  tier_state[HISTORY_MINUTE].per_entry = samples_per_minute;
+  for(int i = 0; i < HISTORY_TIERS; i++){
+      tier_state[i].head = 0;
+      tier_state[i].count = 0;
+      history_acc_reset(&tier_state[i].acc);
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Follow a change of sample period without clearing the history
+*
+* @details
+*  Only the raw samples rolled into each minute entry change. The minute
+*  being built finishes with the new count.
+*
+* @param [in] samples_per_minute
+*  Raw samples per minute at the new sample period
+*
+******************************************************************************/
+void history_set_rate(uint32_t samples_per_minute){
+  EFM_ASSERT(samples_per_minute && samples_per_minute <= UINT16_MAX);
+
+  tier_state[HISTORY_MINUTE].per_entry = samples_per_minute;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add a raw sample to the history
+*
+* @details
+*  Updates the minute accumulator and cascades into the 15 minute and hour
+*  tiers as each one completes an entry. Every tier has a fixed capacity and
+*  overwrites its oldest entry once full.
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+******************************************************************************/
+void history_insert(uint32_t raw){
+  PROF_BEGIN(PROF_HISTORY_INSERT);
+  HISTORY_Entry_TypeDef in;
+  in.min = raw;
+  in.mean = raw;
+  in.max = raw;
+  history_roll(HISTORY_MINUTE, &in);
+  PROF_END(PROF_HISTORY_INSERT);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the number of entries held by a tier
+*
+******************************************************************************/
+uint32_t history_count(tHISTORY_TIER tier){
+  EFM_ASSERT(tier < HISTORY_TIERS);
+  return tier_state[tier].count;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Read one entry of a tier
+*
+* @param [in] tier
+*  Tier to read
+*
+* @param [in] age
+*  0 for the newest entry, history_count(tier) - 1 for the oldest
+*
+* @param [out] entry
+*  Copy of the requested entry
+*
+* @return
+*  false if the tier does not hold that many entries
+*
+******************************************************************************/
+bool history_read(tHISTORY_TIER tier, uint32_t age, HISTORY_Entry_TypeDef *entry){
+  EFM_ASSERT(tier < HISTORY_TIERS);
+  const tHISTORY_TIER_STATE *t = &tier_state[tier];
+
+  if(age >= t->count){
+      return false;
+  }
+
+  uint32_t idx = (t->head + t->len - 1 - age) % t->len;
+  *entry = t->ring[idx];
+  return true;
+}
@@ -21,12 +21,79 @@
 // Private variables
 //***********************************************************************************
 
-static I2C_StateMachine_TypeDef sm;
+static I2C_StateMachine_TypeDef sm[I2C_INSTANCES];     // one per instance, indexed by i2c_index()
 
 //***********************************************************************************
 // Functions
 //***********************************************************************************
 
+/***************************************************************************//**
+* @brief
+*  State machine slot of an instance
+*
+*  @param [in] i2c
+*  I2C0 or I2C1
+*
+******************************************************************************/
+static uint32_t i2c_index(I2C_TypeDef *i2c){
+  EFM_ASSERT(i2c == I2C0 || i2c == I2C1);
+  return (i2c == I2C0) ? 0u : 1u;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Send the next data byte of a write, or STOP once all are acknowledged
+*
+* @details
+*  Bytes go out MSB first from the i2c_data word, matching the order the
+*  receive path assembles them in.
+*
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
+*  @param [in] i2c_sm
+*  Uses the struct to handle interrupt based on input state and parameters
+*
+******************************************************************************/
+HOT_PATH static void i2c_tx_next(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
+  if(i2c_sm->i2c_curr_bytes == i2c_sm->i2c_num_bytes){
+      i2c_sm->current_state = I2C_CLOSE;                  // last byte was acknowledged
+      i2c->CMD = I2C_CMD_STOP;                            // send STOP
+      return;
+  }
+
+  i2c_sm->i2c_curr_bytes++;
+  i2c->TXDATA = (uint8_t)(*(i2c_sm->i2c_data) >> (BUFFER_OFFSET*(i2c_sm->i2c_num_bytes - i2c_sm->i2c_curr_bytes)));
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Give up the transfer
+*
+* @details
+*  ABORT releases the bus at once and raises no MSTOP, so the busy bit and
+*  the energy mode block are released here instead of in i2c_mstop(), and
+*  i2c_err_cb is posted in place of i2c_cb.
+*
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
+*  @param [in] i2c_sm
+*  Uses the struct to handle interrupt based on input state and parameters
+*
+******************************************************************************/
+static void i2c_abort(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
+  i2c->CMD = I2C_CMD_ABORT;                               // release the bus, no STOP follows
+  i2c_sm->current_state = I2C_CLOSE;
+
+  i2c_sm->i2c_busy = DISABLE;                  // done using i2c, can set busy bit to false
+  sleep_unblock_mode(I2C_EM_BLOCK);            // done using i2c, can unblock energy mode
+  add_scheduled_event(i2c_sm->i2c_err_cb);     // tell the caller the transfer failed
+}
+
+
 /***************************************************************************//**
 * @brief
 *  Interrupt handling for ACK
@@ -35,25 +102,33 @@ static I2C_StateMachine_TypeDef sm;
 *  Routine for the ACK interrupt. Performs the appropriate functions based on
 *  the current state and interrupt for the i2c state machine
 *
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
 *  @param [in] i2c_sm
 *  Uses the struct to handle interrupt based on input state and parameters
 *
 ******************************************************************************/
-static void i2c_ack(I2C_StateMachine_TypeDef *i2c_sm){
+HOT_PATH static void i2c_ack(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
   switch(i2c_sm->current_state){
     case I2C_INIT:
       i2c_sm->current_state = I2C_RX_SEND_CMD;            // can move on to next state
 
-      i2c_sm->i2c->TXDATA = i2c_sm->device_cmd;           // send measure temp CMD (0xF3)
+      i2c->TXDATA = i2c_sm->device_cmd;                   // send measure temp CMD (0xF3)
       break;
 
     case I2C_RX_SEND_CMD:
+      if(i2c_sm->i2c_direction == WRITE){
+          i2c_sm->current_state = I2C_TX_SEND_DATA;       // data follows the command
+          i2c_tx_next(i2c, i2c_sm);
+          break;
+      }
       i2c_sm->current_state = I2C_RX_SEND_ADDR;           // can move on to next state
 
       i2c_sm->i2c_cmd = READ;                             // next time we will read
 
-      i2c_sm->i2c->CMD = I2C_CMD_START;                                                           // send repeated start CMD
-      i2c_sm->i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // read from address
+      i2c->CMD = I2C_CMD_START;                                                           // send repeated start CMD
+      i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // read from address
       break;
 
     case I2C_RX_SEND_ADDR:
@@ -62,16 +137,20 @@ static void i2c_ack(I2C_StateMachine_TypeDef *i2c_sm){
       // nothing else, RX data interrupt should occur next
       break;
 
+    case I2C_TX_SEND_DATA:
+      i2c_tx_next(i2c, i2c_sm);
+      break;
+
     case I2C_RX_RECEIVE_DATA:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
 
     case I2C_CLOSE:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
 
     default:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
   }
 }
@@ -85,36 +164,43 @@ static void i2c_ack(I2C_StateMachine_TypeDef *i2c_sm){
 *  Routine for the NACK interrupt. Performs the appropriate functions based on
 *  the current state and interrupt for the i2c state machine
 *
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
 *  @param [in] i2c_sm
 *  Uses the struct to handle interrupt based on input state and parameters
 *
 ******************************************************************************/
-static void i2c_nack(I2C_StateMachine_TypeDef *i2c_sm){
+HOT_PATH static void i2c_nack(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
   switch(i2c_sm->current_state){
     case I2C_INIT:
-      i2c_sm->i2c->CMD = I2C_CMD_START;                                                           // send start
-      i2c_sm->i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // write to address
+      i2c->CMD = I2C_CMD_START;                                                           // send start
+      i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // write to address
       break;
 
     case I2C_RX_SEND_CMD:
-      i2c_sm->i2c->TXDATA = i2c_sm->device_cmd;                                                   // send measure temp CMD (0xF3)
+      i2c->TXDATA = i2c_sm->device_cmd;                                                   // send measure temp CMD (0xF3)
       break;
 
     case I2C_RX_SEND_ADDR:
-      i2c_sm->i2c->CMD = I2C_CMD_START;                                                           // send repeated start CMD
-      i2c_sm->i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // read from address
+      i2c->CMD = I2C_CMD_START;                                                           // send repeated start CMD
+      i2c->TXDATA = (i2c_sm->i2c_device_address << I2C_ADDRESS_SHIFT) | i2c_sm->i2c_cmd;  // read from address
+      break;
+
+    case I2C_TX_SEND_DATA:
+      i2c_abort(i2c, i2c_sm);                                  // device refused a data byte
       break;
 
     case I2C_RX_RECEIVE_DATA:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
 
     case I2C_CLOSE:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
 
     default:
-      EFM_ASSERT(false);
+      I2C_ASSERT(false);
       break;
   }
 }
@@ -128,30 +214,33 @@ static void i2c_nack(I2C_StateMachine_TypeDef *i2c_sm){
 *  Routine for the RXDATAV interrupt. Performs the appropriate functions based on
 *  the current state and interrupt for the i2c state machine
 *
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
 *  @param [in] i2c_sm
 *  Uses the struct to handle interrupt based on input state and parameters
 *
 ******************************************************************************/
-static void i2c_rxdatav(I2C_StateMachine_TypeDef *i2c_sm){
+HOT_PATH static void i2c_rxdatav(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
   // should be in this state, otherwise some other issue
-  EFM_ASSERT(i2c_sm->current_state == I2C_RX_RECEIVE_DATA);
+  I2C_ASSERT(i2c_sm->current_state == I2C_RX_RECEIVE_DATA);
 
   i2c_sm->i2c_curr_bytes++;                           // we have received one byte
 
-  uint8_t raw_data = i2c_sm->i2c->RXDATA;
+  uint8_t raw_data = i2c->RXDATA;
 
-  i2c_sm->i2c->IFC = I2C_IF_RXDATAV;                   // wait till we read data before clearing interrupt flag
-  EFM_ASSERT(!(i2c_sm->i2c->IF & I2C_IF_RXDATAV));     // ensure flag was cleared properly
+  i2c->IFC = I2C_IF_RXDATAV;                           // wait till we read data before clearing interrupt flag
+  I2C_IF_ASSERT(!(i2c->IF & I2C_IF_RXDATAV));     // ensure flag was cleared properly
 
   if(i2c_sm->i2c_curr_bytes == i2c_sm->i2c_num_bytes){
       // read from RXDATA and put into raw_sensor_data in order of MSB to LSB
       *(i2c_sm->i2c_data) = (*(i2c_sm->i2c_data) << (BUFFER_OFFSET*(i2c_sm->i2c_curr_bytes-1))) | raw_data;
-      i2c_sm->i2c->CMD = I2C_CMD_NACK;                // send NACK
-      i2c_sm->i2c->CMD = I2C_CMD_STOP;                // send STOP
+      i2c->CMD = I2C_CMD_NACK;                        // send NACK
+      i2c->CMD = I2C_CMD_STOP;                        // send STOP
   }
   else{
       *(i2c_sm->i2c_data) = (*(i2c_sm->i2c_data) << (BUFFER_OFFSET*(i2c_sm->i2c_curr_bytes-1))) | raw_data;
-      i2c_sm->i2c->CMD = I2C_CMD_ACK;                 // send ACK
+      i2c->CMD = I2C_CMD_ACK;                         // send ACK
   }
 
 }
@@ -165,14 +254,17 @@ static void i2c_rxdatav(I2C_StateMachine_TypeDef *i2c_sm){
 *  Routine for the MSTOP interrupt. Performs the appropriate functions based on
 *  the current state and interrupt for the i2c state machine
 *
+*  @param [in] i2c
+*  Instance the transfer runs on
+*
 *  @param [in] i2c_sm
 *  Uses the struct to handle interrupt based on input state and parameters
 *
 ******************************************************************************/
-static void i2c_mstop(I2C_StateMachine_TypeDef *i2c_sm){
+HOT_PATH static void i2c_mstop(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
 
-  // should only receive MSTOP when in this state
-  EFM_ASSERT(i2c_sm->current_state == I2C_RX_RECEIVE_DATA);
+  // should only receive MSTOP at the end of a read or a write
+  I2C_ASSERT(i2c_sm->current_state == I2C_RX_RECEIVE_DATA || i2c_sm->current_state == I2C_CLOSE);
 
   i2c_sm->i2c_busy = DISABLE;                  // done using i2c, can set busy bit to false
   sleep_unblock_mode(I2C_EM_BLOCK);            // done using i2c, can unblock energy mode
@@ -228,7 +320,7 @@ void i2c_open(I2C_TypeDef *i2c_peripheral, I2C_Open_TypeDef *i2c_open){
   i2c_bus_reset(i2c_peripheral);
 
 
-  sm.i2c_busy = DISABLE;    // set SM busy bit to not true
+  sm[i2c_index(i2c_peripheral)].i2c_busy = DISABLE;    // set SM busy bit to not true
 
 }
 
@@ -246,24 +338,28 @@ void i2c_open(I2C_TypeDef *i2c_peripheral, I2C_Open_TypeDef *i2c_open){
 ******************************************************************************/
 void i2c_start(I2C_StateMachine_TypeDef *i2c_sm){
 
-  while(sm.i2c_busy);
+  I2C_StateMachine_TypeDef *state = &sm[i2c_index(i2c_sm->i2c)];
+
+  while(state->i2c_busy);
 
   // use parameters from function call state machine to private state machine
-  sm.current_state = i2c_sm->current_state;
-  sm.i2c = i2c_sm->i2c;
-  //sm.i2c_busy = i2c_sm->i2c_busy;
-  sm.i2c_cb = i2c_sm->i2c_cb;
-  sm.i2c_cmd = i2c_sm->i2c_cmd;
-  sm.i2c_curr_bytes = i2c_sm->i2c_curr_bytes;
-  sm.i2c_data = i2c_sm->i2c_data;
-  sm.i2c_device_address = i2c_sm->i2c_device_address;
-  sm.i2c_num_bytes = i2c_sm->i2c_num_bytes;
-  sm.device_cmd = i2c_sm->device_cmd;
+  state->current_state = i2c_sm->current_state;
+  state->i2c = i2c_sm->i2c;
+  //state->i2c_busy = i2c_sm->i2c_busy;
+  state->i2c_cb = i2c_sm->i2c_cb;
+  state->i2c_err_cb = i2c_sm->i2c_err_cb;
+  state->i2c_cmd = i2c_sm->i2c_cmd;
+  state->i2c_direction = i2c_sm->i2c_direction;
+  state->i2c_curr_bytes = i2c_sm->i2c_curr_bytes;
+  state->i2c_data = i2c_sm->i2c_data;
+  state->i2c_device_address = i2c_sm->i2c_device_address;
+  state->i2c_num_bytes = i2c_sm->i2c_num_bytes;
+  state->device_cmd = i2c_sm->device_cmd;
 
 
-  EFM_ASSERT((I2C0->STATE & _I2C_STATE_STATE_MASK) == I2C_STATE_STATE_IDLE);
+  EFM_ASSERT((i2c_sm->i2c->STATE & _I2C_STATE_STATE_MASK) == I2C_STATE_STATE_IDLE);
 
-  sm.i2c_busy = ENABLE;
+  state->i2c_busy = ENABLE;
 
   sleep_block_mode(I2C_EM_BLOCK);                             // block sleep mode
 
@@ -312,72 +408,58 @@ void i2c_bus_reset(I2C_TypeDef *i2c_peripheral){
 
 /***************************************************************************//**
 * @brief
-*  Interrupt handler for I2C0
+*  Service the interrupt flags of one I2C instance
 *
 * @details
-*  Checks what flag called the interrupt and call the associated helper function
+*  Checks what flag called the interrupt and call the associated helper
+*  function. Always inlined into I2C_IRQ_HANDLER(), so i2c and i2c_sm are
+*  constants there: each handler works on its own registers and its own
+*  state machine, and passes both on to the helpers. The flags and the
+*  state they arrive in go in the retained trace.
 *
-******************************************************************************/
-void I2C0_IRQHandler(){
-  uint32_t flag = (I2C0->IF) & (I2C0->IEN);
-
-  if((flag & I2C_IF_ACK) == I2C_IF_ACK){
-      I2C0->IFC = I2C_IFC_ACK;
-      EFM_ASSERT(!(I2C0->IF & I2C_IF_ACK));
-      i2c_ack(&sm);
-  }
-
-  if((flag & I2C_IF_NACK) == I2C_IF_NACK){
-      I2C0->IFC = I2C_IFC_NACK;
-      EFM_ASSERT(!(I2C0->IF & I2C_IF_NACK));
-      i2c_nack(&sm);
-  }
-
-  if((flag & I2C_IF_RXDATAV) == I2C_IF_RXDATAV){
-      i2c_rxdatav(&sm);
-  }
-
-  if((flag & I2C_IF_MSTOP) == I2C_IF_MSTOP){
-      I2C0->IFC = I2C_IF_MSTOP;
-      EFM_ASSERT(!(I2C0->IF & I2C_IF_MSTOP));
-      i2c_mstop(&sm);
-  }
-}
-
-
-
-/***************************************************************************//**
-* @brief
-*  Interrupt handler for I2C1
+* @param [in] i2c
+*  Instance the interrupt came from
 *
-* @details
-*  Checks what flag called the interrupt and call the associated helper function
+* @param [in] i2c_sm
+*  State machine of that instance
 *
 ******************************************************************************/
-void I2C1_IRQHandler(){
-  uint32_t flag = (I2C1->IF) & (I2C1->IEN);
+HOT_PATH static inline __attribute__((always_inline)) void i2c_irq(I2C_TypeDef *i2c, I2C_StateMachine_TypeDef *i2c_sm){
+  uint32_t flag = (i2c->IF) & (i2c->IEN);
+
+  trace(TRACE_I2C, (flag << 8) | i2c_sm->current_state);
 
   if((flag & I2C_IF_ACK) == I2C_IF_ACK){
-      I2C1->IFC = I2C_IFC_ACK;
-      EFM_ASSERT(!(I2C1->IF & I2C_IF_ACK));
-      i2c_ack(&sm);
+      i2c->IFC = I2C_IFC_ACK;
+      I2C_IF_ASSERT(!(i2c->IF & I2C_IF_ACK));
+      i2c_ack(i2c, i2c_sm);
   }
 
   if((flag & I2C_IF_NACK) == I2C_IF_NACK){
-      I2C1->IFC = I2C_IFC_NACK;
-      EFM_ASSERT(!(I2C1->IF & I2C_IF_NACK));
-      i2c_nack(&sm);
+      i2c->IFC = I2C_IFC_NACK;
+      I2C_IF_ASSERT(!(i2c->IF & I2C_IF_NACK));
+      i2c_nack(i2c, i2c_sm);
   }
 
   if((flag & I2C_IF_RXDATAV) == I2C_IF_RXDATAV){
-      i2c_rxdatav(&sm);
+      i2c_rxdatav(i2c, i2c_sm);
   }
 
   if((flag & I2C_IF_MSTOP) == I2C_IF_MSTOP){
-      I2C1->IFC = I2C_IF_MSTOP;
-      EFM_ASSERT(!(I2C1->IF & I2C_IF_MSTOP));
-      i2c_mstop(&sm);
+      i2c->IFC = I2C_IF_MSTOP;
+      I2C_IF_ASSERT(!(i2c->IF & I2C_IF_MSTOP));
+      i2c_mstop(i2c, i2c_sm);
   }
 }
 
 
+// Interrupt handler for I2C<n>, one copy of i2c_irq() per instance
+#define I2C_IRQ_HANDLER(n, prof_id)                                             \
+  HOT_PATH void I2C##n##_IRQHandler(){                                          \
+    PROF_BEGIN(prof_id);                                                        \
+    i2c_irq(I2C##n, &sm[n]);                                                    \
+    PROF_END(prof_id);                                                          \
+  }
+
+I2C_IRQ_HANDLER(0, PROF_I2C0_IRQ)
+I2C_IRQ_HANDLER(1, PROF_I2C1_IRQ)
@@ -0,0 +1,248 @@
+/**
+ * @file latency.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Post to dispatch latency of scheduler events
+ *
+ * @details
+ *  The scheduler calls latency_post() with the events that just became
+ *  pending and latency_dispatch() with the pending events the main loop is
+ *  about to run. The first post of an event is what counts, later posts
+ *  while it is pending are coalesced by the scheduler anyway.
+ *
+ *  Both calls append to a trace ring. A slot is claimed with an atomic
+ *  increment, so an interrupt posting in the middle of another record gets
+ *  the next slot instead of a lock. A record's seq is written last, which
+ *  lets latency_trace() skip one still being written.
+ *
+ *  The histograms and worst cases are only touched on dispatch, which runs
+ *  from the main loop, and read from the main loop with latency_get().
+ *
+ *  Ticks come from prof_now(). The cycle counter doesn't run while the core
+ *  sleeps, which leaves the wake up before the posting handler out of the
+ *  measurement but nothing after it.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "latency.h"
+#include "em_common.h"
+#include "brd_config.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static LATENCY_Open_TypeDef config;
+static uint32_t post_tick[LATENCY_MAX_EVENTS];
+static LATENCY_Stats_TypeDef stats[LATENCY_MAX_EVENTS];
+static uint32_t window_cur[LATENCY_MAX_EVENTS];     // worst of the window in progress
+static uint32_t window_dispatches;
+
+static LATENCY_Record_TypeDef ring[LATENCY_RING_SIZE];
+static uint32_t ring_head;                          // records ever claimed
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Append one record to the trace ring
+*
+* @param [in] event
+*  Event bit number, with LATENCY_DISPATCH for a dispatch
+*
+* @param [in] tick
+*  Time of the post or dispatch
+*
+******************************************************************************/
+HOT_PATH static void latency_log(uint32_t event, uint32_t tick){
+  uint32_t n = __atomic_fetch_add(&ring_head, 1u, __ATOMIC_RELAXED);
+  LATENCY_Record_TypeDef *r = &ring[n & (LATENCY_RING_SIZE - 1u)];
+
+  __atomic_store_n(&r->seq, 0u, __ATOMIC_RELAXED);
+  r->tick = tick;
+  r->event = (uint8_t)event;
+  __atomic_store_n(&r->seq, n + 1u, __ATOMIC_RELEASE);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Close the worst case window once it holds enough dispatches
+*
+******************************************************************************/
+HOT_PATH static void latency_window_step(void){
+  if(!config.window || ++window_dispatches < config.window){
+      return;
+  }
+  window_dispatches = 0;
+  for(uint32_t i = 0; i < LATENCY_MAX_EVENTS; i++){
+      stats[i].window_max = window_cur[i];
+      window_cur[i] = 0;
+  }
+}
+
+//***********************************************************************************
+// Global functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start the tick source and clear the statistics and the trace
+*
+* @param [in] latency_open
+*  Window length for the worst case
+*
+******************************************************************************/
+void latency_open(LATENCY_Open_TypeDef *latency_open){
+  CORE_DECLARE_IRQ_STATE;
+
+  prof_clock_open();
+
+  CORE_ENTER_CRITICAL();
+  config = *latency_open;
+  window_dispatches = 0;
+  for(uint32_t i = 0; i < LATENCY_MAX_EVENTS; i++){
+      stats[i] = (LATENCY_Stats_TypeDef){ 0 };
+      window_cur[i] = 0;
+  }
+  for(uint32_t i = 0; i < LATENCY_RING_SIZE; i++){
+      ring[i].seq = 0;
+  }
+  ring_head = 0;
+  CORE_EXIT_CRITICAL();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Note the time events were posted
+*
+* @details
+*  Safe from any interrupt priority. Events above LATENCY_MAX_EVENTS are not
+*  traced.
+*
+* @param [in] events
+*  Events that were not pending before this post
+*
+******************************************************************************/
+HOT_PATH void latency_post(uint32_t events){
+  uint32_t now = prof_now();
+
+  events &= (1u << LATENCY_MAX_EVENTS) - 1u;
+  while(events){
+      uint32_t bit = SL_CTZ(events);
+
+      post_tick[bit] = now;
+      latency_log(bit, now);
+      events &= events - 1;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Account for events about to be run by the main loop
+*
+* @details
+*  Call before the events are cleared, so a post arriving in between can't
+*  replace the post time being measured.
+*
+* @param [in] events
+*  Pending events being dispatched
+*
+******************************************************************************/
+HOT_PATH void latency_dispatch(uint32_t events){
+  uint32_t now = prof_now();
+
+  events &= (1u << LATENCY_MAX_EVENTS) - 1u;
+  while(events){
+      uint32_t bit = SL_CTZ(events);
+      uint32_t ticks = now - post_tick[bit];
+      uint32_t bucket = ticks ? 31u - __CLZ(ticks) : 0u;
+      LATENCY_Stats_TypeDef *s = &stats[bit];
+
+      if(bucket >= LATENCY_HIST_BUCKETS){
+          bucket = LATENCY_HIST_BUCKETS - 1u;
+      }
+      s->hist[bucket]++;
+      s->count++;
+      if(ticks > s->max){
+          s->max = ticks;
+      }
+      if(ticks > window_cur[bit]){
+          window_cur[bit] = ticks;
+      }
+      latency_log(bit | LATENCY_DISPATCH, now);
+      latency_window_step();
+      events &= events - 1;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Copy out the latency statistics of one event
+*
+* @param [in] bit
+*  Event bit number, below LATENCY_MAX_EVENTS
+*
+* @param [in] latency_stats
+*  Filled in, in ticks
+*
+******************************************************************************/
+void latency_get(uint32_t bit, LATENCY_Stats_TypeDef *latency_stats){
+  EFM_ASSERT(bit < LATENCY_MAX_EVENTS);
+  *latency_stats = stats[bit];
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Copy out the most recent trace records, oldest first
+*
+* @details
+*  Records overwritten or still being written while copying are left out.
+*
+* @param [in] records
+*  Destination
+*
+* @param [in] max
+*  Records the destination holds
+*
+* @return
+*  Records copied
+*
+******************************************************************************/
+uint32_t latency_trace(LATENCY_Record_TypeDef *records, uint32_t max){
+  uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+  uint32_t n = head < LATENCY_RING_SIZE ? head : LATENCY_RING_SIZE;
+  uint32_t copied = 0;
+
+  if(n > max){
+      n = max;
+  }
+  for(uint32_t seq = head - n + 1u; seq <= head; seq++){
+      const LATENCY_Record_TypeDef *r = &ring[(seq - 1u) & (LATENCY_RING_SIZE - 1u)];
+      LATENCY_Record_TypeDef copy;
+
+      copy.seq = __atomic_load_n(&r->seq, __ATOMIC_ACQUIRE);
+      copy.tick = r->tick;
+      copy.event = r->event;
+      if(copy.seq == seq && __atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) == seq){
+          records[copied++] = copy;
+      }
+  }
+  return copied;
+}
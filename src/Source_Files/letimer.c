@@ -67,8 +67,8 @@ void letimer_pwm_open(LETIMER_TypeDef *letimer, APP_LETIMER_PWM_TypeDef *app_let
   letimer_pwm_values.comp0Top = true;
   letimer_pwm_values.debugRun = app_letimer_struct->debugRun;
   letimer_pwm_values.enable = app_letimer_struct->enable;
-  letimer_pwm_values.out0Pol = DISABLE;
-  letimer_pwm_values.out1Pol = ENABLE;
+  letimer_pwm_values.out0Pol = app_letimer_struct->out_pin_0_pol;
+  letimer_pwm_values.out1Pol = app_letimer_struct->out_pin_1_pol;
   letimer_pwm_values.repMode = letimerRepeatFree;
   letimer_pwm_values.ufoa0 = letimerUFOAPwm;
   letimer_pwm_values.ufoa1 = letimerUFOAPwm;
@@ -146,6 +146,63 @@ void letimer_start(LETIMER_TypeDef *letimer, bool enable){
   }
 }
 
+/***************************************************************************//**
+ * @brief
+ *  Change the PWM output pattern of a running LETIMER
+ *
+ * @details
+ *  Only COMP1 and the route enables are written, so the period (COMP0) and
+ *  with it the underflow timing used by the rest of the application is left
+ *  untouched. The outputs keep toggling in EM2/EM3 without waking the CPU.
+ *
+ * @param [in] letimer
+ *  Pointer to the LETIMER peripheral register
+ *
+ * @param [in] active_period
+ *  Part of the period, in seconds, that the routed outputs are active
+ *
+ * @param [in] out_pin_0_en
+ *  Route out 0 to its gpio port/pin
+ *
+ * @param [in] out_pin_1_en
+ *  Route out 1 to its gpio port/pin
+ *
+ ******************************************************************************/
+void letimer_pwm_pattern(LETIMER_TypeDef *letimer, float active_period, bool out_pin_0_en, bool out_pin_1_en){
+  EFM_ASSERT(active_period * LETIMER_HZ < letimer->COMP0);    // active part must fit in the period
+
+  while(letimer->SYNCBUSY);
+
+  letimer->COMP1 = active_period * LETIMER_HZ;
+  letimer->ROUTEPEN = out_pin_0_en | (out_pin_1_en << ROUTE_1_EN_BIT_SHIFT);
+}
+
+
+/***************************************************************************//**
+ * @brief
+ *  Change the period of a running LETIMER
+ *
+ * @details
+ *  COMP0 is the top value, so the new period takes effect from the next
+ *  underflow and the current period finishes at its old length. The active
+ *  period (COMP1) must still fit inside the new period.
+ *
+ * @param [in] letimer
+ *  Pointer to the LETIMER peripheral register
+ *
+ * @param [in] period
+ *  Total period in seconds
+ *
+ ******************************************************************************/
+void letimer_set_period(LETIMER_TypeDef *letimer, float period){
+  EFM_ASSERT(letimer->COMP1 < period * LETIMER_HZ);
+
+  while(letimer->SYNCBUSY);
+
+  letimer->COMP0 = period * LETIMER_HZ;
+}
+
+
 /***************************************************************************//**
  * @brief
  *  IRQ Handler for the LETIMER0
@@ -155,27 +212,29 @@ void letimer_start(LETIMER_TypeDef *letimer, bool enable){
  *  current implementation we only handle COMP0, COMP1, and UF
  *
  ******************************************************************************/
-void LETIMER0_IRQHandler(void){
+HOT_PATH void LETIMER0_IRQHandler(void){
+  PROF_BEGIN(PROF_LETIMER0_IRQ);
   // read interrupt source
   uint32_t flag = (LETIMER0->IF) & (LETIMER0->IEN);
 
   if((flag & _LETIMER_IF_COMP0_MASK) == LETIMER_IF_COMP0){
       LETIMER0->IFC = LETIMER_IFC_COMP0;
-      EFM_ASSERT(!(LETIMER0->IF & LETIMER_IF_COMP0));
+      LETIMER_ASSERT(!(LETIMER0->IF & LETIMER_IF_COMP0));
       add_scheduled_event(scheduled_comp0_cb);
   }
 
   if((flag & _LETIMER_IF_COMP1_MASK) == LETIMER_IF_COMP1){
       LETIMER0->IFC = LETIMER_IFC_COMP1;
-      EFM_ASSERT(!(LETIMER0->IF & LETIMER_IF_COMP1));
+      LETIMER_ASSERT(!(LETIMER0->IF & LETIMER_IF_COMP1));
       add_scheduled_event(scheduled_comp1_cb);
   }
 
   if((flag & _LETIMER_IF_UF_MASK) == LETIMER_IF_UF){
       LETIMER0->IFC = LETIMER_IFC_UF;
-      EFM_ASSERT(!(LETIMER0->IF & LETIMER_IF_UF));
+      LETIMER_ASSERT(!(LETIMER0->IF & LETIMER_IF_UF));
       add_scheduled_event(scheduled_uf_cb);
   }
+  PROF_END(PROF_LETIMER0_IRQ);
 }
 
 
@@ -0,0 +1,268 @@
+/**
+ * @file leuart.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  LEUART driver with LDMA transmit
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "leuart.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static uint32_t scheduled_tx_done_cb;
+static volatile bool tx_busy;
+static LDMA_Descriptor_t tx_desc;         // must stay valid while the channel loads it
+
+// written by the RXDATAV interrupt, read by the scheduler
+static uint32_t scheduled_rx_cb;
+static uint8_t rx_buffer[LEUART_RX_BUFFER];
+static volatile uint32_t rx_head;
+static volatile uint32_t rx_tail;
+static volatile uint32_t rx_overflows;
+static bool rx_em_blocked;                // LEUART_RX_EM held for the receiver
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Configure the LEUART
+*
+* @details
+*  Enables the LEUART clock, initializes the peripheral and its routes and
+*  sets up LDMA for transmit. TX DMA wakeup lets the LDMA keep feeding the
+*  LEUART while the core stays in EM2.
+*
+*  With rx_irq_enable the receiver has to run whenever a byte may arrive, so
+*  EM3 is blocked until leuart_close(), not only while a transmit is in
+*  flight.
+*
+* @param [in] leuart
+*  Pointer to the LEUART peripheral register
+*
+* @param [in] leuart_settings
+*  The application specific struct used to configure the LEUART
+*
+******************************************************************************/
+void leuart_open(LEUART_TypeDef *leuart, LEUART_OPEN_STRUCT *leuart_settings){
+  LEUART_Init_TypeDef leuart_init;
+  LDMA_Init_t ldma_init = LDMA_INIT_DEFAULT;
+
+  EFM_ASSERT(leuart == LEUART0);
+  CMU_ClockEnable(cmuClock_LEUART0, true);
+  CMU_ClockEnable(cmuClock_LDMA, true);
+
+  // test clock tree is enabled properly
+  leuart->STARTFRAME = LEUART_TEST_BITS;
+  while(leuart->SYNCBUSY);
+  EFM_ASSERT(leuart->STARTFRAME == LEUART_TEST_BITS);
+  leuart->STARTFRAME = 0;
+  while(leuart->SYNCBUSY);
+
+  leuart_init.baudrate = leuart_settings->baudrate;
+  leuart_init.databits = leuart_settings->databits;
+  leuart_init.enable = leuartDisable;
+  leuart_init.parity = leuart_settings->parity;
+  leuart_init.refFreq = leuart_settings->refFreq;
+  leuart_init.stopbits = leuart_settings->stopbits;
+
+  LEUART_Init(leuart, &leuart_init);
+  while(leuart->SYNCBUSY);
+
+  leuart->ROUTELOC0 = leuart_settings->tx_loc | leuart_settings->rx_loc;    // already shifted
+  leuart->ROUTEPEN = (leuart_settings->tx_pin_en ? LEUART_ROUTEPEN_TXPEN : 0)
+                   | (leuart_settings->rx_pin_en ? LEUART_ROUTEPEN_RXPEN : 0);
+
+  leuart->CTRL |= LEUART_CTRL_TXDMAWU;
+  leuart->CMD = LEUART_CMD_CLEARTX | LEUART_CMD_CLEARRX;
+  leuart->IFC = _LEUART_IF_MASK;
+
+  LDMA_Init(&ldma_init);
+
+  scheduled_tx_done_cb = leuart_settings->tx_done_cb;
+  tx_busy = false;
+
+  scheduled_rx_cb = leuart_settings->rx_cb;
+  rx_head = 0;
+  rx_tail = 0;
+  rx_overflows = 0;
+  if(leuart_settings->rx_irq_enable){
+      leuart->IEN |= LEUART_IEN_RXDATAV;            // RXDATAV wakes the core from EM2
+      if(!rx_em_blocked){
+          sleep_block_mode(LEUART_RX_EM);
+          rx_em_blocked = true;
+      }
+  }
+
+  LEUART_Enable(leuart, leuart_settings->enable);
+  while(leuart->SYNCBUSY);
+
+  // LEUART0 Interrupt is enabled within NVIC in the app_peripheral_open() function
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Stop the LEUART and release the energy mode the receiver held
+*
+* @details
+*  Waits for a transmit in flight to finish first, its tx done event is
+*  still posted.
+*
+* @param [in] leuart
+*  Pointer to the LEUART peripheral register
+*
+******************************************************************************/
+void leuart_close(LEUART_TypeDef *leuart){
+  EFM_ASSERT(leuart == LEUART0);
+
+  while(tx_busy);
+  leuart->IEN &= ~LEUART_IEN_RXDATAV;
+  LEUART_Enable(leuart, leuartDisable);
+  while(leuart->SYNCBUSY);
+
+  if(rx_em_blocked){
+      sleep_unblock_mode(LEUART_RX_EM);
+      rx_em_blocked = false;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Transmit a buffer through LDMA
+*
+* @details
+*  The LDMA moves each byte into TXDATA as the LEUART asks for it, so the
+*  core can sleep in EM2 for the whole transmit. EM3 is blocked until the
+*  last byte has left the shift register, signalled by TXC.
+*
+* @param [in] leuart
+*  Pointer to the LEUART peripheral register
+*
+* @param [in] data
+*  Bytes to send, must stay untouched until the tx done event
+*
+* @param [in] len
+*  Number of bytes
+*
+******************************************************************************/
+void leuart_tx_dma(LEUART_TypeDef *leuart, const uint8_t *data, uint32_t len){
+  LDMA_TransferCfg_t tx_cfg = LDMA_TRANSFER_CFG_PERIPHERAL(ldmaPeripheralSignal_LEUART0_TXBL);
+  LDMA_Descriptor_t desc = LDMA_DESCRIPTOR_SINGLE_M2P_BYTE(data, &leuart->TXDATA, len);
+
+  EFM_ASSERT(!tx_busy && len);
+
+  tx_busy = true;
+  tx_desc = desc;
+  sleep_block_mode(LEUART_TX_EM);
+
+  leuart->IFC = LEUART_IFC_TXC;
+  leuart->IEN |= LEUART_IEN_TXC;
+  LDMA_StartTransfer(LEUART_TX_DMA_CH, &tx_cfg, &tx_desc);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Check whether a transmit is in progress
+*
+******************************************************************************/
+bool leuart_tx_busy(LEUART_TypeDef *leuart){
+  (void)leuart;
+  return tx_busy;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Take the oldest received byte
+*
+* @details
+*  Called from the scheduler. The interrupt only stores bytes, so whatever
+*  parses them runs here at scheduler priority.
+*
+* @param [in] leuart
+*  Pointer to the LEUART peripheral register
+*
+* @param [out] byte
+*  Received byte
+*
+* @return
+*  false if nothing is waiting
+*
+******************************************************************************/
+bool leuart_rx_read(LEUART_TypeDef *leuart, uint8_t *byte){
+  (void)leuart;
+  if(rx_tail == rx_head){
+      return false;
+  }
+  *byte = rx_buffer[rx_tail & (LEUART_RX_BUFFER - 1)];
+  rx_tail++;
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Number of received bytes lost because the buffer was full
+*
+******************************************************************************/
+uint32_t leuart_rx_overflows(LEUART_TypeDef *leuart){
+  (void)leuart;
+  return rx_overflows;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  IRQ Handler for the LEUART0
+*
+* @details
+*  TXC can also be raised if the LDMA falls behind mid buffer, so the transmit
+*  only completes once the LDMA channel is done as well. Received bytes are
+*  only copied into the ring buffer here.
+*
+******************************************************************************/
+void LEUART0_IRQHandler(void){
+  PROF_BEGIN(PROF_LEUART0_IRQ);
+  uint32_t flag = (LEUART0->IF) & (LEUART0->IEN);
+
+  if(flag & LEUART_IF_RXDATAV){
+      uint8_t byte = LEUART0->RXDATA;               // reading RXDATA clears RXDATAV
+      if(rx_head - rx_tail < LEUART_RX_BUFFER){
+          rx_buffer[rx_head & (LEUART_RX_BUFFER - 1)] = byte;
+          rx_head++;
+      }
+      else{
+          rx_overflows++;
+      }
+      add_scheduled_event(scheduled_rx_cb);
+  }
+
+  if(flag & LEUART_IF_TXC){
+      LEUART0->IFC = LEUART_IFC_TXC;
+      EFM_ASSERT(!(LEUART0->IF & LEUART_IF_TXC));
+      if(LDMA_TransferDone(LEUART_TX_DMA_CH)){
+          LEUART0->IEN &= ~LEUART_IEN_TXC;
+          tx_busy = false;
+          sleep_unblock_mode(LEUART_TX_EM);
+          add_scheduled_event(scheduled_tx_done_cb);
+      }
+  }
+  PROF_END(PROF_LEUART0_IRQ);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file mem.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Stack high water mark and static RAM footprint
+ *
+ * @details
+ *  main() paints the free stack with MEM_PAINT before anything else runs.
+ *  The interrupt handlers share the main stack, so the deepest point ever
+ *  reached, nested interrupts included, is the lowest word that no longer
+ *  holds the paint.
+ *
+ *  The stack only ever gets deeper, so mem_stack_peak() carries on from the
+ *  last mark it found instead of scanning the whole stack. It costs a word
+ *  per word of new depth and one compare when nothing changed. A used word
+ *  that happens to equal MEM_PAINT stops the scan early, which under reports
+ *  the peak by at most the words below it.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "mem.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static uint32_t *stack_mark = MEM_STACK_TOP;    // lowest stack word known to be used
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Fill the unused part of the stack with MEM_PAINT
+*
+* @details
+*  Call first thing in main(). Everything below this function's frame, less
+*  MEM_PAINT_MARGIN for the frame itself, is painted. When the frame is not
+*  on the stack being measured (the host build) all of it is painted.
+*
+******************************************************************************/
+__attribute__((noinline)) void mem_paint_stack(void){
+  uintptr_t frame = (uintptr_t)__builtin_frame_address(0) - MEM_PAINT_MARGIN;
+  uint32_t *end = MEM_STACK_TOP;
+
+  if(frame > (uintptr_t)MEM_STACK_LIMIT && frame < (uintptr_t)MEM_STACK_TOP){
+      end = (uint32_t *)(frame & ~(uintptr_t)3u);
+  }
+  for(uint32_t *p = MEM_STACK_LIMIT; p < end; p++){
+      *p = MEM_PAINT;
+  }
+  stack_mark = end;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Deepest the stack has been since it was painted
+*
+* @return
+*  Bytes, equal to the stack size when the stack has been exhausted
+*
+******************************************************************************/
+uint32_t mem_stack_peak(void){
+  while(stack_mark > MEM_STACK_LIMIT && stack_mark[-1] != MEM_PAINT){
+      stack_mark--;
+  }
+  return (uint32_t)((uintptr_t)MEM_STACK_TOP - (uintptr_t)stack_mark);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Stack and static RAM usage
+*
+* @param [in] mem_usage
+*  Filled in, in bytes
+*
+******************************************************************************/
+void mem_get(MEM_Usage_TypeDef *mem_usage){
+  mem_usage->stack_size = (uint32_t)((uintptr_t)MEM_STACK_TOP - (uintptr_t)MEM_STACK_LIMIT);
+  mem_usage->stack_peak = mem_stack_peak();
+  mem_usage->static_ram = MEM_STATIC_RAM;
+}
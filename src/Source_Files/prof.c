@@ -0,0 +1,282 @@
+/**
+ * @file prof.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Duration statistics for the PROF_BEGIN() / PROF_END() probes
+ *
+ * @details
+ *  Each probe id keeps a count, min, max, total and a log2 histogram of the
+ *  durations recorded for it. Every id is recorded from one context only, an
+ *  interrupt handler or the main loop, so recording needs no lock; reads take
+ *  a critical section to get a consistent copy.
+ *
+ *  A duration includes any interrupt that preempted the probed code, and so
+ *  do its cache hits and misses. It excludes the cost of the probe itself,
+ *  which prof_open() measures on an empty probe, so short functions such as
+ *  history_insert() read close to their own cost.
+ *
+ *  The cache counters run once prof_open() starts them and wrap at
+ *  PROF_CACHE_MASK, far more fetches than one probe makes. A wake window hit
+ *  rate close to the callbacks' says the cache stays warm across EM2, a much
+ *  lower one that every wake refills it.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "prof.h"
+
+#ifdef DWT
+#include "em_cmu.h"
+#else
+#include <time.h>
+#endif
+
+//***********************************************************************************
+// Tick source
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start the tick source
+*
+* @details
+*  On the target this enables trace in the debug block, which the DWT cycle
+*  counter needs, and starts the counter. Calling it again leaves a running
+*  counter alone.
+*
+******************************************************************************/
+void prof_clock_open(void){
+#ifdef DWT
+  if(!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)){
+      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+      DWT->CYCCNT = 0;
+      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  }
+#endif
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Ticks per second
+*
+******************************************************************************/
+uint32_t prof_tick_hz(void){
+#ifdef DWT
+  return CMU_ClockFreqGet(cmuClock_CORE);
+#else
+  return 1000000000u;
+#endif
+}
+
+
+#ifndef DWT
+/***************************************************************************//**
+* @brief
+*  Monotonic nanoseconds standing in for the cycle counter, wraps like it
+*
+******************************************************************************/
+uint32_t prof_now(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+
+#ifdef PROF_ENABLE
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static PROF_Stats_TypeDef prof[PROF_NUM_IDS];
+static PROF_Mark_TypeDef wake_start;
+static uint32_t overhead;                         // ticks an empty probe records
+static bool awake;                                // wake_start marks an open window
+
+static const char *const prof_names[PROF_NUM_IDS] = {
+  [PROF_I2C0_IRQ]             = "I2C0 irq",
+  [PROF_I2C1_IRQ]             = "I2C1 irq",
+  [PROF_LETIMER0_IRQ]         = "LETIMER0 irq",
+  [PROF_GPIO_EVEN_IRQ]        = "GPIO even irq",
+  [PROF_GPIO_ODD_IRQ]         = "GPIO odd irq",
+  [PROF_APP_BTN0_CB]          = "btn0 cb",
+  [PROF_APP_BTN1_CB]          = "btn1 cb",
+  [PROF_LETIMER_COMP0_CB]     = "letimer comp0 cb",
+  [PROF_LETIMER_COMP1_CB]     = "letimer comp1 cb",
+  [PROF_LETIMER_UF_CB]        = "letimer uf cb",
+  [PROF_SENSOR_SAMPLE_CB]     = "sample cb",
+  [PROF_ALARM_CB]             = "alarm cb",
+  [PROF_STATS_CB]             = "stats cb",
+  [PROF_FLASH_LOG_CB]         = "flash log cb",
+  [PROF_TELEMETRY_TX_CB]      = "telemetry tx cb",
+  [PROF_SHELL_RX_CB]          = "shell rx cb",
+  [PROF_SENSOR_STEP_CB]       = "sensor step cb",
+  [PROF_SENSOR_ERROR_CB]      = "sensor error cb",
+  [PROF_HISTORY_INSERT]       = "history insert",
+  [PROF_CODEC_ENCODE]         = "codec encode",
+  [PROF_LEUART0_IRQ]          = "LEUART0 irq",
+  [PROF_TELEMETRY_BUILD]      = "telemetry build",
+  [PROF_TELEMETRY_SEND]       = "telemetry send",
+  [PROF_TELEMETRY_TX_DONE]    = "telemetry tx done",
+  [PROF_WAKE_WINDOW]          = "wake window",
+};
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start the tick source, measure the probe overhead and clear every probe
+*
+* @details
+*  The overhead is the least of PROF_OVERHEAD_RUNS empty probes, the two
+*  counter reads and whatever the core needs between them.
+*
+******************************************************************************/
+void prof_open(void){
+  PROF_Mark_TypeDef start, end;
+
+  prof_clock_open();
+#ifdef PROF_CACHE_MASK
+  MSC->CACHECMD = MSC_CACHECMD_STARTPC;
+#endif
+
+  overhead = UINT32_MAX;
+  for(uint32_t i = 0; i < PROF_OVERHEAD_RUNS; i++){
+      prof_mark(&start);
+      prof_mark(&end);
+      if(end.tick - start.tick < overhead){
+          overhead = end.tick - start.tick;
+      }
+  }
+  prof_clear();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add one duration to a probe
+*
+* @param [in] id
+*  Probe the duration belongs to
+*
+* @param [in] start
+*  Counters taken by prof_mark() when the probed code started
+*
+******************************************************************************/
+void prof_record(PROF_ID id, const PROF_Mark_TypeDef *start){
+  PROF_Mark_TypeDef end;
+  PROF_Stats_TypeDef *p = &prof[id];
+  uint32_t ticks;
+
+  prof_mark(&end);
+  ticks = end.tick - start->tick;
+  ticks = ticks > overhead ? ticks - overhead : 0;
+#ifdef PROF_CACHE_MASK
+  p->hits += (end.hits - start->hits) & PROF_CACHE_MASK;
+  p->misses += (end.misses - start->misses) & PROF_CACHE_MASK;
+#endif
+
+  if(ticks < p->min){
+      p->min = ticks;
+  }
+  if(ticks > p->max){
+      p->max = ticks;
+  }
+  p->count++;
+  p->total += ticks;
+  p->hist[ticks ? 31u - __CLZ(ticks) : 0u]++;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Close the wake window, the core is about to sleep
+*
+******************************************************************************/
+void prof_sleep(void){
+  if(awake){
+      prof_record(PROF_WAKE_WINDOW, &wake_start);
+      awake = false;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Open a wake window, the core just left enter_sleep()
+*
+******************************************************************************/
+void prof_wake(void){
+  prof_mark(&wake_start);
+  awake = true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Copy out the statistics of a probe
+*
+* @param [in] id
+*  Probe to read
+*
+* @param [in] stats
+*  Filled in, min is 0 when nothing was recorded
+*
+******************************************************************************/
+void prof_get(PROF_ID id, PROF_Stats_TypeDef *stats){
+  EFM_ASSERT(id < PROF_NUM_IDS);
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  *stats = prof[id];
+  CORE_EXIT_CRITICAL();
+
+  if(!stats->count){
+      stats->min = 0;
+      stats->mean = 0;
+      return;
+  }
+  stats->mean = (uint32_t)((stats->total + stats->count / 2) / stats->count);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Forget everything recorded so far
+*
+******************************************************************************/
+void prof_clear(void){
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+  for(uint32_t i = 0; i < PROF_NUM_IDS; i++){
+      prof[i] = (PROF_Stats_TypeDef){ .min = UINT32_MAX };
+  }
+  CORE_EXIT_CRITICAL();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Printable name of a probe
+*
+******************************************************************************/
+const char *prof_name(PROF_ID id){
+  return id < PROF_NUM_IDS ? prof_names[id] : "?";
+}
+
+
+#endif /* PROF_ENABLE */
@@ -0,0 +1,133 @@
+/**
+ * @file report.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Send-on-delta filter between the sensor and the consumers that cost
+ *  energy or flash per sample
+ *
+ * @details
+ *  A sample is forwarded when it differs from the last forwarded one by more
+ *  than delta, or when heartbeat samples have gone by without one. Comparing
+ *  against the last forwarded sample rather than the previous reading means
+ *  a slow drift is still reported once it adds up to delta.
+ *
+ *  Consumers of the filtered stream hold the last value they were given. The
+ *  heartbeat bounds how stale that value can be and shows the device is
+ *  alive while the temperature is steady.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "report.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static REPORT_Open_TypeDef config;
+static REPORT_Stats_TypeDef report_stats;
+static uint32_t last_raw;
+static uint32_t since_last;             // samples since the last forwarded one
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Configure the filter and clear the counters
+*
+* @details
+*  The first sample after opening is always forwarded.
+*
+* @param [in] report_open
+*  Delta and heartbeat
+*
+******************************************************************************/
+void report_open(REPORT_Open_TypeDef *report_open){
+  config = *report_open;
+  report_stats = (REPORT_Stats_TypeDef){ 0 };
+  since_last = UINT32_MAX;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the delta, takes effect from the next sample
+*
+* @param [in] delta
+*  Raw units
+*
+******************************************************************************/
+void report_set_delta(uint32_t delta){
+  config.delta = delta;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the heartbeat, samples since the last report still count
+*
+* @param [in] heartbeat
+*  Samples, 0 for never
+*
+******************************************************************************/
+void report_set_heartbeat(uint32_t heartbeat){
+  config.heartbeat = heartbeat;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Decide whether a sample goes on to the consumers
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+* @return
+*  true to forward the sample
+*
+******************************************************************************/
+bool report_filter(uint32_t raw){
+  uint32_t change = raw > last_raw ? raw - last_raw : last_raw - raw;
+  bool changed = since_last == UINT32_MAX || change > config.delta;
+
+  report_stats.samples++;
+  if(!changed){
+      since_last++;
+      if(!config.heartbeat || since_last < config.heartbeat){
+          return false;
+      }
+      report_stats.heartbeats++;
+  }
+
+  report_stats.forwarded++;
+  last_raw = raw;
+  since_last = 0;
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Copy out the counters
+*
+* @details
+*  1 - forwarded / samples is the fraction of samples suppressed.
+*
+* @param [in] stats
+*  Filled in
+*
+******************************************************************************/
+void report_get_stats(REPORT_Stats_TypeDef *stats){
+  *stats = report_stats;
+}
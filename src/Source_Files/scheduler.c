@@ -21,7 +21,7 @@
 // private variables
 //***********************************************************************************
 
-static uint32_t event_scheduled;
+static volatile uint32_t event_scheduled;
 
 //***********************************************************************************
 // function prototypes
@@ -51,7 +51,7 @@ void scheduler_open(void){
  *  returns a 32 bit integer that represents the scheduled events
  *
  ******************************************************************************/
-uint32_t get_scheduled_events(void){
+HOT_PATH uint32_t get_scheduled_events(void){
   return event_scheduled;
 }
 
@@ -61,15 +61,22 @@ uint32_t get_scheduled_events(void){
  *  Add a scheduled event
  *
  * @details
- *  Use an atomic operation to access and update our even scheduler, to add a
- *  new event
+ *  Sets the event bits with an exclusive load/store pair instead of masking
+ *  interrupts. An interrupt between the two clears the exclusive monitor, the
+ *  store fails and the update is retried on the new value. Events that
+ *  weren't already pending are time stamped for the latency trace, and every
+ *  post goes in the retained trace.
  *
  ******************************************************************************/
-void add_scheduled_event(uint32_t event){
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_CRITICAL();
-  event_scheduled |= event;
-  CORE_EXIT_CRITICAL();
+HOT_PATH void add_scheduled_event(uint32_t event){
+  uint32_t was;
+
+  do{
+      was = __LDREXW(&event_scheduled);
+  }while(__STREXW(was | event, &event_scheduled));
+
+  trace(TRACE_POST, event);
+  latency_post(event & ~was);
 }
 
 
@@ -79,12 +86,18 @@ void add_scheduled_event(uint32_t event){
  *
  * @details
  *  Used to remove a specific event in the event scheduler. Often done after
- *  reading the events.
+ *  reading the events. Removing a pending event counts as its dispatch in the
+ *  latency trace. Clears the bits with an exclusive load/store pair, like
+ *  add_scheduled_event().
  *
  ******************************************************************************/
-void remove_scheduled_event(uint32_t event){
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_CRITICAL();
-  event_scheduled &= ~event;
-  CORE_EXIT_CRITICAL();
+HOT_PATH void remove_scheduled_event(uint32_t event){
+  uint32_t was;
+
+  trace(TRACE_DISPATCH, event);
+  latency_dispatch(event & event_scheduled);
+
+  do{
+      was = __LDREXW(&event_scheduled);
+  }while(__STREXW(was & ~event, &event_scheduled));
 }
@@ -0,0 +1,316 @@
+/**
+ * @file sensor.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Sensor registry and the sampler that runs over it
+ *
+ * @details
+ *  The sampler is a small state machine driven from the main loop. Each
+ *  driver transfer posts step_cb when it completes, and sensor_step() moves
+ *  on to the next sensor. Nothing waits on the bus in thread mode, so
+ *  sensors on a shared bus never start a transfer while another is in
+ *  flight.
+ *
+ *    IDLE --sensor_sample()--> CONFIGURING, configure() on each sensor in
+ *                              turn until one has a settings write to make
+ *    CONFIGURING --step or error--> configure() on the next sensor, then
+ *                              STARTING, start() on sensor 0
+ *    STARTING --step--> start() on the next sensor, or collect() on sensor 0
+ *    COLLECTING --step--> result kept, collect() on the next sensor, or
+ *                         post sample_cb and back to IDLE
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "sensor.h"
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+typedef enum{
+  SENSOR_IDLE,
+  SENSOR_CONFIGURING,
+  SENSOR_STARTING,
+  SENSOR_COLLECTING
+} tSENSOR_PHASE;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static SENSOR_Open_TypeDef config;
+static const SENSOR_Driver_TypeDef *drivers[SENSOR_MAX];
+static uint32_t raw[SENSOR_MAX];
+static uint32_t count;
+static tSENSOR_PHASE phase;
+static uint32_t current;                  // sensor the pending transfer belongs to
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Write the pending settings of the next sensor that has any, or start the
+*  conversions once none are left
+*
+******************************************************************************/
+static void sensor_configure_next(void){
+  for(; current < count; current++){
+      if(drivers[current]->configure(config.step_cb, config.error_cb)){
+          return;                         // step_cb or error_cb follows the write
+      }
+  }
+  phase = SENSOR_STARTING;
+  current = 0;
+  drivers[0]->start(config.step_cb);
+}
+
+//***********************************************************************************
+// Global functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Empty the registry and set the events the sampler uses
+*
+* @param [in] sensor_open
+*  Step and sample complete events
+*
+******************************************************************************/
+void sensor_open(SENSOR_Open_TypeDef *sensor_open){
+  config = *sensor_open;
+  count = 0;
+  phase = SENSOR_IDLE;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add a sensor to the registry and open it
+*
+* @param [in] driver
+*  Driver of the sensor, must stay valid
+*
+* @return
+*  Id of the sensor, for sensor_get_raw()
+*
+******************************************************************************/
+uint32_t sensor_register(const SENSOR_Driver_TypeDef *driver){
+  EFM_ASSERT(count < SENSOR_MAX);
+  EFM_ASSERT(phase == SENSOR_IDLE);
+
+  drivers[count] = driver;
+  raw[count] = 0;
+  driver->open();
+  return count++;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Start one sample of every registered sensor
+*
+* @details
+*  Settings changed since the last sample are written first. sample_cb is
+*  posted once every result is in.
+*
+* @return
+*  false when the previous sample is still under way, nothing is started
+*
+******************************************************************************/
+bool sensor_sample(void){
+  if(phase != SENSOR_IDLE || !count){
+      return false;
+  }
+  phase = SENSOR_CONFIGURING;
+  current = 0;
+  sensor_configure_next();
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Move the sampler on, a driver transfer just completed
+*
+* @details
+*  Call from the main loop when step_cb is dispatched.
+*
+******************************************************************************/
+void sensor_step(void){
+  switch(phase){
+    case SENSOR_CONFIGURING:
+      current++;
+      sensor_configure_next();
+      break;
+
+    case SENSOR_STARTING:
+      if(++current < count){
+          drivers[current]->start(config.step_cb);
+          break;
+      }
+      phase = SENSOR_COLLECTING;
+      current = 0;
+      drivers[0]->collect(config.step_cb);
+      break;
+
+    case SENSOR_COLLECTING:
+      raw[current] = drivers[current]->get_raw();
+      if(++current < count){
+          drivers[current]->collect(config.step_cb);
+          break;
+      }
+      phase = SENSOR_IDLE;
+      add_scheduled_event(config.sample_cb);
+      break;
+
+    default:
+      EFM_ASSERT(false);
+      break;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  A device refused its settings write
+*
+* @details
+*  Call from the main loop when error_cb is dispatched. The settings are
+*  left as the device had them, the refusal goes in the trace and the
+*  sample carries on.
+*
+******************************************************************************/
+void sensor_error(void){
+  EFM_ASSERT(phase == SENSOR_CONFIGURING);     // only settings writes carry data bytes
+
+  trace(TRACE_SENSOR_ERROR, current);
+  current++;
+  sensor_configure_next();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Latest reading of one sensor
+*
+* @param [in] id
+*  Id returned by sensor_register()
+*
+******************************************************************************/
+uint32_t sensor_get_raw(uint32_t id){
+  EFM_ASSERT(id < count);
+  return raw[id];
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Convert a reading of one sensor to centi-units
+*
+* @param [in] id
+*  Id returned by sensor_register()
+*
+* @param [in] raw_data
+*  Reading of that sensor
+*
+******************************************************************************/
+int32_t sensor_convert(uint32_t id, uint32_t raw_data){
+  EFM_ASSERT(id < count);
+  return drivers[id]->convert(raw_data);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Convert a level in centi-units to a reading of one sensor
+*
+* @param [in] id
+*  Id returned by sensor_register()
+*
+* @param [in] centi
+*  Level, centi-degrees C for a temperature sensor
+*
+******************************************************************************/
+int32_t sensor_to_raw(uint32_t id, int32_t centi){
+  EFM_ASSERT(id < count);
+  return drivers[id]->to_raw(centi);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Convert a change in centi-units to a change in the readings of one sensor
+*
+* @details
+*  The registered sensors are linear, so a change is the same number of
+*  codes at every level.
+*
+* @param [in] id
+*  Id returned by sensor_register()
+*
+* @param [in] centi
+*  Change, centi-degrees C for a temperature sensor
+*
+******************************************************************************/
+int32_t sensor_delta_to_raw(uint32_t id, int32_t centi){
+  EFM_ASSERT(id < count);
+  return drivers[id]->to_raw(centi) - drivers[id]->to_raw(0);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Switch the supply of every sensor that has one
+*
+* @details
+*  Only between samples. Nothing waits for the sensors to come up, a
+*  driver that loses its settings while off writes them again before the
+*  next sample.
+*
+* @param [in] on
+*  true to power the sensors up
+*
+******************************************************************************/
+void sensor_power(bool on){
+  EFM_ASSERT(phase == SENSOR_IDLE);
+
+  for(uint32_t i = 0; i < count; i++){
+      if(drivers[i]->power){
+          drivers[i]->power(on);
+      }
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the resolution of one sensor
+*
+* @details
+*  The driver keeps it and writes it from configure() before the next
+*  sample, so this is safe while a sample is under way.
+*
+* @param [in] id
+*  Id returned by sensor_register()
+*
+* @param [in] bits
+*  Bits per reading, one the driver supports
+*
+******************************************************************************/
+void sensor_set_resolution(uint32_t id, uint32_t bits){
+  EFM_ASSERT(id < count);
+  EFM_ASSERT(drivers[id]->set_resolution);
+  drivers[id]->set_resolution(bits);
+}
@@ -0,0 +1,299 @@
+/**
+ * @file shell.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Runtime configuration commands received on the LEUART
+ *
+ * @details
+ *  Two input forms share the receive line:
+ *
+ *  Human mode, one command per line from a terminal, e.g. "period 5000".
+ *  Backspace edits the line, and the line ends with CR or LF.
+ *
+ *  Binary mode, a TELEMETRY_COMMAND frame in the telemetry framing. A
+ *  TELEMETRY_SYNC byte at the start of a line selects it. That byte can't
+ *  appear in typed text, so no mode switch is needed.
+ *
+ *  Every command gets a TELEMETRY_REPLY frame on the telemetry stream. The
+ *  receive interrupt only buffers bytes; all parsing happens here, from the
+ *  scheduler.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "shell.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+typedef enum{
+  SHELL_IDLE,                   // start of a line
+  SHELL_TEXT,                   // collecting a human mode line
+  SHELL_BINARY                  // collecting a binary frame
+} tSHELL_STATE;
+
+static SHELL_Open_TypeDef config;
+static tSHELL_STATE state;
+static uint8_t line[TELEMETRY_MAX_FRAME];   // holds either a text line or a frame
+static uint32_t line_len;
+static bool line_overflow;
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Look up a command by keyword or by id
+*
+* @param [in] name
+*  Keyword to match, or NULL to match by id
+*
+* @param [in] id
+*  Binary id to match when name is NULL
+*
+******************************************************************************/
+static const SHELL_Command_TypeDef *shell_find(const char *name, uint32_t id){
+  for(uint32_t i = 0; i < config.num_commands; i++){
+      const SHELL_Command_TypeDef *c = &config.commands[i];
+      if(name ? (strcmp(name, c->name) == 0) : (id == c->id)){
+          return c;
+      }
+  }
+  return NULL;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Range check a command argument
+*
+* @details
+*  Replies with the error itself, so the caller only has to act on success.
+*
+******************************************************************************/
+static bool shell_accept(const SHELL_Command_TypeDef *c, int32_t arg, SHELL_Request_TypeDef *request){
+  if(arg < c->min || arg > c->max){
+      shell_reply(c->id, TELEMETRY_STATUS_RANGE, arg);
+      return false;
+  }
+  request->id = c->id;
+  request->arg = arg;
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Parse a finished human mode line, "<keyword> <integer>"
+*
+******************************************************************************/
+static bool shell_parse_text(SHELL_Request_TypeDef *request){
+  char *name;
+  char *value;
+  char *end;
+
+  if(line_overflow){
+      shell_reply(TELEMETRY_REPLY_NO_ID, TELEMETRY_STATUS_SYNTAX, 0);
+      return false;
+  }
+  line[line_len] = '\0';
+
+  name = strtok((char *)line, " \t");
+  value = strtok(NULL, " \t");
+  if(name == NULL){
+      return false;                             // empty line
+  }
+
+  const SHELL_Command_TypeDef *c = shell_find(name, 0);
+  if(c == NULL){
+      shell_reply(TELEMETRY_REPLY_NO_ID, TELEMETRY_STATUS_UNKNOWN, 0);
+      return false;
+  }
+  if(value == NULL || strtok(NULL, " \t") != NULL){
+      shell_reply(c->id, TELEMETRY_STATUS_SYNTAX, 0);
+      return false;
+  }
+
+  long arg = strtol(value, &end, 10);
+  if(*end != '\0' || arg < INT32_MIN || arg > INT32_MAX){
+      shell_reply(c->id, TELEMETRY_STATUS_SYNTAX, 0);
+      return false;
+  }
+  return shell_accept(c, (int32_t)arg, request);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Check a finished binary command frame
+*
+******************************************************************************/
+static bool shell_parse_binary(SHELL_Request_TypeDef *request){
+  uint32_t len = line[3];
+  const uint8_t *payload = &line[TELEMETRY_HEADER_SIZE];
+  uint16_t crc = crc16(CRC16_INIT, &line[1], TELEMETRY_HEADER_SIZE - 1 + len);
+
+  if(crc != ((payload[len] << 8) | payload[len + 1])){
+      shell_reply(TELEMETRY_REPLY_NO_ID, TELEMETRY_STATUS_CRC, 0);
+      return false;
+  }
+  if(line[1] != TELEMETRY_COMMAND || len != TELEMETRY_COMMAND_SIZE){
+      shell_reply(TELEMETRY_REPLY_NO_ID, TELEMETRY_STATUS_SYNTAX, 0);
+      return false;
+  }
+
+  const SHELL_Command_TypeDef *c = shell_find(NULL, payload[TELEMETRY_COMMAND_ID]);
+  if(c == NULL){
+      shell_reply(payload[TELEMETRY_COMMAND_ID], TELEMETRY_STATUS_UNKNOWN, 0);
+      return false;
+  }
+  return shell_accept(c, (int32_t)telemetry_get32(&payload[TELEMETRY_COMMAND_ARG]), request);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Feed one received byte to the parser
+*
+* @return
+*  true when the byte completed a valid command
+*
+******************************************************************************/
+static bool shell_input(uint8_t byte, SHELL_Request_TypeDef *request){
+  switch(state){
+    case SHELL_IDLE:
+      line_len = 0;
+      line_overflow = false;
+      if(byte == TELEMETRY_SYNC){
+          line[line_len++] = byte;
+          state = SHELL_BINARY;
+          return false;
+      }
+      if(byte == '\r' || byte == '\n'){
+          return false;
+      }
+      state = SHELL_TEXT;
+      // falls through
+
+    case SHELL_TEXT:
+      if(byte == '\r' || byte == '\n'){
+          state = SHELL_IDLE;
+          return shell_parse_text(request);
+      }
+      if(byte == SHELL_BACKSPACE || byte == SHELL_DELETE){
+          if(line_len){
+              line_len--;
+          }
+      }
+      else if(line_len < SHELL_LINE_MAX){
+          line[line_len++] = byte;
+      }
+      else{
+          line_overflow = true;
+      }
+      return false;
+
+    case SHELL_BINARY:
+      line[line_len++] = byte;
+      if(line_len == TELEMETRY_HEADER_SIZE && line[3] > TELEMETRY_MAX_PAYLOAD){
+          state = SHELL_IDLE;
+          shell_reply(TELEMETRY_REPLY_NO_ID, TELEMETRY_STATUS_SYNTAX, 0);
+          return false;
+      }
+      if(line_len < TELEMETRY_HEADER_SIZE || line_len < TELEMETRY_HEADER_SIZE + line[3] + TELEMETRY_CRC_SIZE){
+          return false;
+      }
+      state = SHELL_IDLE;
+      return shell_parse_binary(request);
+
+    default:
+      EFM_ASSERT(false);
+      state = SHELL_IDLE;
+      return false;
+  }
+}
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start accepting commands
+*
+* @param [in] shell_open
+*  The LEUART to read and the table of accepted commands
+*
+******************************************************************************/
+void shell_open(SHELL_Open_TypeDef *shell_open){
+  EFM_ASSERT(shell_open->commands && shell_open->num_commands);
+  EFM_ASSERT(SHELL_LINE_MAX < sizeof(line));
+
+  config = *shell_open;
+  state = SHELL_IDLE;
+  line_len = 0;
+  line_overflow = false;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Parse received bytes until a command is complete
+*
+* @details
+*  Called from the scheduler on the LEUART receive event. Stops at the first
+*  complete command so the caller can apply it; call again until it returns
+*  false to drain the receive buffer. Malformed input is answered here.
+*
+* @param [out] request
+*  The command and its range checked argument
+*
+* @return
+*  true if request holds a command to apply
+*
+******************************************************************************/
+bool shell_poll(SHELL_Request_TypeDef *request){
+  uint8_t byte;
+
+  while(leuart_rx_read(config.leuart, &byte)){
+      if(shell_input(byte, request)){
+          return true;
+      }
+  }
+  return false;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Report the result of a command
+*
+* @param [in] id
+*  Command id, or TELEMETRY_REPLY_NO_ID
+*
+* @param [in] status
+*  TELEMETRY_STATUS_OK or the reason the command was refused
+*
+* @param [in] value
+*  Value now in effect, or the rejected argument
+*
+******************************************************************************/
+void shell_reply(uint32_t id, uint32_t status, int32_t value){
+  uint8_t reply[TELEMETRY_REPLY_SIZE];
+
+  reply[TELEMETRY_REPLY_ID] = (uint8_t)id;
+  reply[TELEMETRY_REPLY_STATUS] = (uint8_t)status;
+  telemetry_put32(&reply[TELEMETRY_REPLY_VALUE], (uint32_t)value);
+  telemetry_send(TELEMETRY_REPLY, reply, TELEMETRY_REPLY_SIZE);
+}
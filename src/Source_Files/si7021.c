@@ -23,6 +23,25 @@
 //***********************************************************************************
 
 static uint32_t raw_sensor_data;
+static uint32_t user_reg;                       // written by the I2C state machine after the call returns
+static tSI7021_RESOLUTION resolution;
+static bool resolution_pending;                 // resolution is written before the next sample
+
+//***********************************************************************************
+// global variables
+//***********************************************************************************
+
+const SENSOR_Driver_TypeDef si7021_sensor = {
+  .open = si7021_open,
+  .configure = si7021_configure,
+  .start = si7021_start,
+  .collect = si7021_collect,
+  .get_raw = si7021_get_raw_data,
+  .convert = si7021_to_centi,
+  .to_raw = si7021_to_raw,
+  .power = si7021_power,
+  .set_resolution = si7021_set_bits,
+};
 
 //***********************************************************************************
 // Functions
@@ -46,8 +65,8 @@ void si7021_open(void){
   i2c->enable = ENABLE;
   i2c->clhr = i2cClockHLRAsymetric;
   i2c->freq = I2C_FREQ_FAST_MAX;
-  i2c->out_pin_route_SCL = I2C_ROUTELOC0_SCLLOC_LOC15;
-  i2c->out_pin_route_SDA = I2C_ROUTELOC0_SDALOC_LOC15;
+  i2c->out_pin_route_SCL = SI7021_SCL_ROUTE;
+  i2c->out_pin_route_SDA = SI7021_SDA_ROUTE;
   i2c->out_pin_SCL_en = I2C_ROUTEPEN_SCLPEN;
   i2c->out_pin_SDA_en = I2C_ROUTEPEN_SDAPEN;
   i2c->master = ENABLE;
@@ -79,7 +98,9 @@ void si7021_read(uint32_t call_back){
   sm.i2c = I2C0;                                // I2C Peripheral Number
   //sm.i2c_busy = DISABLE;                      // Not busy yet
   sm.i2c_cb = call_back;                        // Call Back bit
+  sm.i2c_err_cb = call_back;                    // no data bytes are written
   sm.i2c_cmd = WRITE;                           // read or write bit
+  sm.i2c_direction = READ;                      // read the measurement back
   sm.i2c_curr_bytes = Si7021_CUR_BYTES;         // number of bytes read so far (0)
   sm.i2c_data = &raw_sensor_data;               // pointer to raw data
   sm.i2c_device_address = SI7021_I2C_ADDRESS;   // address of peripheral sensor
@@ -90,6 +111,179 @@ void si7021_read(uint32_t call_back){
 }
 
 
+/***************************************************************************//**
+* @brief
+*  Start a temperature conversion
+*
+* @details
+*  Sends the no hold measure command and releases the bus. The result is
+*  read back with si7021_collect().
+*
+* @param [in] call_back
+*   The call back to be added to the events scheduler once the command is
+*   sent
+*
+******************************************************************************/
+void si7021_start(uint32_t call_back){
+  I2C_StateMachine_TypeDef sm;
+  sm.current_state = I2C_INIT;                  // initial state of SM
+  sm.i2c = I2C0;                                // I2C Peripheral Number
+  sm.i2c_cb = call_back;                        // Call Back bit
+  sm.i2c_err_cb = call_back;                    // no data bytes are written
+  sm.i2c_cmd = WRITE;                           // read or write bit
+  sm.i2c_direction = WRITE;                     // nothing follows the command
+  sm.i2c_curr_bytes = Si7021_CUR_BYTES;         // number of bytes written so far (0)
+  sm.i2c_data = &raw_sensor_data;               // not used, no data bytes
+  sm.i2c_device_address = SI7021_I2C_ADDRESS;   // address of peripheral sensor
+  sm.i2c_num_bytes = 0;                         // command only
+  sm.device_cmd = Si7021_READ_TEMP_CMD;         // measure temperature cmd
+
+  i2c_start(&sm);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Read back the conversion si7021_start() began
+*
+* @details
+*  Starts with the read address. The sensor NACKs it until the conversion
+*  is done, and the state machine retries it until then, as it does within
+*  si7021_read().
+*
+* @param [in] call_back
+*   The call back to be added to the events scheduler once the result is in
+*
+******************************************************************************/
+void si7021_collect(uint32_t call_back){
+  raw_sensor_data = 0;                          // reset raw sensor data value
+
+  I2C_StateMachine_TypeDef sm;
+  sm.current_state = I2C_RX_SEND_ADDR;          // command was sent by si7021_start()
+  sm.i2c = I2C0;                                // I2C Peripheral Number
+  sm.i2c_cb = call_back;                        // Call Back bit
+  sm.i2c_err_cb = call_back;                    // no data bytes are written
+  sm.i2c_cmd = READ;                            // read or write bit
+  sm.i2c_direction = READ;                      // read the measurement back
+  sm.i2c_curr_bytes = Si7021_CUR_BYTES;         // number of bytes read so far (0)
+  sm.i2c_data = &raw_sensor_data;               // pointer to raw data
+  sm.i2c_device_address = SI7021_I2C_ADDRESS;   // address of peripheral sensor
+  sm.i2c_num_bytes = Si7021_NUM_BYTES;          // number of bytes to read
+  sm.device_cmd = Si7021_READ_TEMP_CMD;         // not sent
+
+  i2c_start(&sm);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Switch the sensor supply
+*
+* @details
+*  Does not wait for the sensor to come up. It NACKs its address until it
+*  has, and the state machine retries the address until then, so the next
+*  sample waits it out on the bus. The sensor powers up at 14 bit, a
+*  different resolution is written again before the next sample.
+*
+* @param [in] on
+*   true to power the sensor up
+*
+******************************************************************************/
+void si7021_power(bool on){
+  if(!on){
+      GPIO_PinOutClear(SI7021_SENSOR_EN_PORT, SI7021_SENSOR_EN_PIN);
+      return;
+  }
+  GPIO_PinOutSet(SI7021_SENSOR_EN_PORT, SI7021_SENSOR_EN_PIN);
+  resolution_pending = (resolution != SI7021_RES_RH12_T14);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the measurement resolution
+*
+* @details
+*  Only records the resolution. The sampler writes it with
+*  si7021_configure() before it starts the next sample, so the write never
+*  waits on a transfer in flight. Conversion time follows the resolution,
+*  and since reads poll the sensor with NACKs until the measurement is
+*  ready no other timing has to change.
+*
+* @param [in] res
+*   Resolution to use from the next sample on
+*
+******************************************************************************/
+void si7021_set_resolution(tSI7021_RESOLUTION res){
+  EFM_ASSERT(!(res & ~Si7021_USER_REG_RES));
+
+  resolution = res;
+  resolution_pending = true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the temperature resolution, in bits
+*
+* @param [in] bits
+*   14, 13, 12 or 11
+*
+******************************************************************************/
+void si7021_set_bits(uint32_t bits){
+  switch(bits){
+    case 14: si7021_set_resolution(SI7021_RES_RH12_T14); break;
+    case 13: si7021_set_resolution(SI7021_RES_RH10_T13); break;
+    case 12: si7021_set_resolution(SI7021_RES_RH8_T12);  break;
+    case 11: si7021_set_resolution(SI7021_RES_RH11_T11); break;
+    default: EFM_ASSERT(false); break;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Write a resolution set since the last sample
+*
+* @details
+*  Writes User Register 1. Called by the sampler while the bus is idle.
+*
+* @param [in] call_back
+*   The call back to be added to the events scheduler once the register is
+*   written
+*
+* @param [in] error_cb
+*   The call back to be added instead if the sensor refuses the value
+*
+* @return
+*   false when there is nothing to write, no call back follows
+*
+******************************************************************************/
+bool si7021_configure(uint32_t call_back, uint32_t error_cb){
+  if(!resolution_pending){
+      return false;
+  }
+  resolution_pending = false;
+  user_reg = (Si7021_USER_REG_DEFAULT & ~Si7021_USER_REG_RES) | resolution;
+
+  I2C_StateMachine_TypeDef sm;
+  sm.current_state = I2C_INIT;                  // initial state of SM
+  sm.i2c = I2C0;                                // I2C Peripheral Number
+  sm.i2c_cb = call_back;                        // Call Back bit
+  sm.i2c_err_cb = error_cb;                     // the resolution is left as it was
+  sm.i2c_cmd = WRITE;                           // read or write bit
+  sm.i2c_direction = WRITE;                     // register value follows the command
+  sm.i2c_curr_bytes = Si7021_CUR_BYTES;         // number of bytes written so far (0)
+  sm.i2c_data = &user_reg;                      // pointer to the register value
+  sm.i2c_device_address = SI7021_I2C_ADDRESS;   // address of peripheral sensor
+  sm.i2c_num_bytes = Si7021_USER_REG_BYTES;     // number of bytes to write
+  sm.device_cmd = Si7021_WRITE_USER_REG1;       // write user register cmd
+
+  i2c_start(&sm);
+  return true;
+}
+
+
 /***************************************************************************//**
 * @brief
 *  Function to access the raw sensor data
@@ -105,6 +299,36 @@ uint32_t si7021_get_raw_data(void){
 
 
 
+/***************************************************************************//**
+* @brief
+*  Convert the raw data into centi-degrees C
+*
+* @details
+*  The data sheet conversion in integers, rounded to the nearest
+*  centi-degree. 17572 * 0xFFFF still fits in 32 bits.
+*
+******************************************************************************/
+int32_t si7021_to_centi(uint32_t raw_data){
+  return (int32_t)((Si7021_TEMP_SPAN * raw_data + Si7021_CODES / 2u) / Si7021_CODES) - Si7021_TEMP_OFFSET;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Convert centi-degrees C into the raw reading of that temperature
+*
+* @details
+*  The inverse of si7021_to_centi(), rounded to the nearest code. Used to
+*  turn thresholds into raw readings once, when they are set.
+*
+******************************************************************************/
+int32_t si7021_to_raw(int32_t centi){
+  int32_t codes = (centi + Si7021_TEMP_OFFSET) * (int32_t)Si7021_CODES;
+
+  return (codes + (codes < 0 ? -1 : 1) * (int32_t)(Si7021_TEMP_SPAN / 2u)) / (int32_t)Si7021_TEMP_SPAN;
+}
+
+
 /***************************************************************************//**
 * @brief
 *  Convert the raw data into a temperature
@@ -51,7 +51,7 @@
 // private variables
 //***********************************************************************************
 
-static uint32_t lowest_energy_mode[MAX_ENERGY_MODES];
+static volatile uint32_t lowest_energy_mode[MAX_ENERGY_MODES];
 
 //***********************************************************************************
 // function
@@ -66,7 +66,7 @@ static uint32_t lowest_energy_mode[MAX_ENERGY_MODES];
  *
  ******************************************************************************/
 void sleep_open(void){
-  for(int i=0; i< MAX_ENERGY_MODES; i++){
+  for(uint32_t i = 0; i < MAX_ENERGY_MODES; i++){
       lowest_energy_mode[i] = 0;
    }
 }
@@ -79,22 +79,23 @@ void sleep_open(void){
  * @details
  *  Utilized by a peripheral to prevent the Mighty Gecko from
  *  going into that sleep mode while the peripheral is active. It will increment the associated array
- *  element in lowest_energy_mode[] by one.
+ *  element in lowest_energy_mode[] by one. The increment is an exclusive
+ *  load/store pair retried until no interrupt came in between, so interrupts
+ *  stay enabled.
  *
  * @param [in] EM
  *  Block the given energy mode
  *
  ******************************************************************************/
 void sleep_block_mode(uint32_t EM){
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_CRITICAL();
+  uint32_t count;
 
-  lowest_energy_mode[EM] ++;
-
-  CORE_EXIT_CRITICAL();
+  do{
+      count = __LDREXW(&lowest_energy_mode[EM]) + 1;
+  }while(__STREXW(count, &lowest_energy_mode[EM]));
 
   // should not go over the max energy modes
-  EFM_ASSERT(lowest_energy_mode[EM] < MAX_ENERGY_MODES);
+  SLEEP_ASSERT(count < MAX_ENERGY_MODES);
 }
 
 
@@ -105,22 +106,26 @@ void sleep_block_mode(uint32_t EM){
  * @details
  *  Utilized to release the processor from going into a sleep
  *  mode with a peripheral that is no longer active. It will decrement the associated array element in
- *  lowest_energy_mode[] by one.
+ *  lowest_energy_mode[] by one, the same way sleep_block_mode() increments
+ *  it. An unblock without a matching block leaves the count at zero.
  *
  * @param [in] EM
  *  Unblock the given energy mode
  *
  ******************************************************************************/
 void sleep_unblock_mode(uint32_t EM){
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_CRITICAL();
-
-  lowest_energy_mode[EM] --;
+  uint32_t count;
 
-  CORE_EXIT_CRITICAL();
+  do{
+      count = __LDREXW(&lowest_energy_mode[EM]);
+      if(!count){
+          __CLREX();
+          break;
+      }
+  }while(__STREXW(count - 1, &lowest_energy_mode[EM]));
 
   // application is calling more unblock sleep modes than block sleep modes
-  EFM_ASSERT(lowest_energy_mode[EM] >= EM0);
+  SLEEP_ASSERT(count != 0);
 }
 
 
@@ -130,21 +135,27 @@ void sleep_unblock_mode(uint32_t EM){
  *
  * @details
  *  Function that will enter the appropriate sleep Energy Mode based on the
- *  first non-zero array element in lowest_energy_mode[].
+ *  first non-zero array element in lowest_energy_mode[]. The mode entered
+ *  goes in the retained trace.
  *
  ******************************************************************************/
 void enter_sleep(void){
   CORE_DECLARE_IRQ_STATE;
   CORE_ENTER_CRITICAL();
 
-  if(lowest_energy_mode[EM0] > 0 || lowest_energy_mode[EM1] > 0){}
+  if(lowest_energy_mode[EM0] > 0 || lowest_energy_mode[EM1] > 0){
+      trace(TRACE_SLEEP, EM0);
+  }
   else if(lowest_energy_mode[EM2] > 0){
+      trace(TRACE_SLEEP, EM1);
       EMU_EnterEM1();
   }
   else if(lowest_energy_mode[EM3] > 0){
+      trace(TRACE_SLEEP, EM2);
       EMU_EnterEM2(true);
   }
   else{
+      trace(TRACE_SLEEP, EM3);
       EMU_EnterEM3(true);
   }
 
@@ -166,7 +177,7 @@ void enter_sleep(void){
  *
  ******************************************************************************/
 uint32_t current_block_energy_mode(void){
-  for(int i = 0; i < MAX_ENERGY_MODES; i++){
+  for(uint32_t i = 0; i < MAX_ENERGY_MODES; i++){
       if(lowest_energy_mode[i] != EM0){
           return i;
       }
@@ -0,0 +1,204 @@
+/**
+ * @file sm.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Table driven hierarchical state machine
+ *
+ * @details
+ *  The tables are const, so they live in flash. A dispatch indexes the
+ *  current state's row by event and only falls back to the enclosing
+ *  states when the row leaves the event unhandled. The lookup, the exits
+ *  and the entries are each bounded by SM_MAX_DEPTH, so a dispatch costs
+ *  the same whatever the number of states or events.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "sm.h"
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+static const SM_State_TypeDef *sm_get(const SM_Table_TypeDef *table, uint32_t state){
+  EFM_ASSERT(state != SM_NONE && state <= table->num_states);
+  return &table->states[state - 1];
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Nesting depth of a state, 1 at the top level
+*
+******************************************************************************/
+static uint32_t sm_depth(const SM_Table_TypeDef *table, uint32_t state){
+  uint32_t depth = 0;
+
+  while(state != SM_NONE){
+      depth++;
+      state = sm_get(table, state)->parent;
+  }
+  EFM_ASSERT(depth <= SM_MAX_DEPTH);
+  return depth;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Run the entry actions from just below ancestor down to state, outermost first
+*
+******************************************************************************/
+static void sm_enter(const SM_Table_TypeDef *table, uint32_t ancestor, uint32_t state){
+  uint8_t path[SM_MAX_DEPTH];
+  uint32_t n = 0;
+
+  for(; state != ancestor; state = sm_get(table, state)->parent){
+      EFM_ASSERT(n < SM_MAX_DEPTH);
+      path[n++] = state;
+  }
+  while(n){
+      const SM_State_TypeDef *s = sm_get(table, path[--n]);
+      if(s->entry){
+          s->entry(path[n]);
+      }
+  }
+}
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start a state machine
+*
+* @details
+*  Enters the initial state, running the entry actions of every enclosing
+*  state first.
+*
+* @param [in] sm
+*  Machine instance
+*
+* @param [in] table
+*  States and transitions, must stay valid
+*
+******************************************************************************/
+void sm_open(SM_Machine_TypeDef *sm, const SM_Table_TypeDef *table){
+  sm->table = table;
+  sm->current = table->initial;
+  sm_depth(table, table->initial);              // checks the nesting limit
+  sm_enter(table, SM_NONE, table->initial);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Deliver an event
+*
+* @details
+*  The innermost state with a transition for the event handles it. For an
+*  external transition, states are exited from the current one up to the
+*  closest state enclosing both the handling state and the target, then the
+*  action runs, then states are entered down to the target. A transition
+*  to the handling state itself exits and re-enters it.
+*
+* @param [in] sm
+*  Machine instance
+*
+* @param [in] event
+*  Event number, less than the table's num_events
+*
+* @return
+*  false if no state handled the event
+*
+******************************************************************************/
+bool sm_dispatch(SM_Machine_TypeDef *sm, uint32_t event){
+  const SM_Table_TypeDef *table = sm->table;
+  const SM_Transition_TypeDef *t = NULL;
+  uint32_t source;
+
+  EFM_ASSERT(event < table->num_events);
+
+  for(source = sm->current; source != SM_NONE; source = sm_get(table, source)->parent){
+      const SM_State_TypeDef *s = sm_get(table, source);
+      if(s->on && (s->on[event].target != SM_NONE || s->on[event].action)){
+          t = &s->on[event];
+          break;
+      }
+  }
+  if(t == NULL){
+      return false;
+  }
+
+  if(t->target == SM_NONE){
+      t->action(sm->current);                   // internal transition
+      return true;
+  }
+
+  // closest state enclosing both source and target, the source is exited
+  // as well when it is the target
+  const SM_State_TypeDef *target = sm_get(table, t->target);
+  uint32_t a = sm_get(table, source)->parent;
+  if(a != target->parent){
+      uint32_t b = t->target;
+      uint32_t da = sm_depth(table, source);
+      uint32_t db = sm_depth(table, b);
+      a = source;
+      if(a == b){
+          a = b = target->parent;
+      }
+      while(da > db){ a = sm_get(table, a)->parent; da--; }
+      while(db > da){ b = sm_get(table, b)->parent; db--; }
+      while(a != b){
+          a = sm_get(table, a)->parent;
+          b = sm_get(table, b)->parent;
+      }
+  }
+
+  for(uint32_t s = sm->current; s != a; s = sm_get(table, s)->parent){
+      const SM_State_TypeDef *state = sm_get(table, s);
+      if(state->exit){
+          state->exit(s);
+      }
+  }
+  if(t->action){
+      t->action(source);
+  }
+  sm->current = t->target;
+  sm_enter(table, a, t->target);
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Current leaf state
+*
+******************************************************************************/
+uint32_t sm_state(const SM_Machine_TypeDef *sm){
+  return sm->current;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Check whether the machine is in a state or one of its sub states
+*
+******************************************************************************/
+bool sm_in(const SM_Machine_TypeDef *sm, uint32_t state){
+  for(uint32_t s = sm->current; s != SM_NONE; s = sm_get(sm->table, s)->parent){
+      if(s == state){
+          return true;
+      }
+  }
+  return false;
+}
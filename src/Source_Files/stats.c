@@ -0,0 +1,217 @@
+/**
+ * @file stats.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Streaming min, max, mean and variance over tumbling or sliding windows
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "stats.h"
+
+//***********************************************************************************
+// TypeDefs
+//***********************************************************************************
+
+// Welford accumulator for one hop of samples
+typedef struct{
+  uint32_t n;
+  int32_t mean;             // raw units << STATS_MEAN_SHIFT
+  uint64_t m2;              // sum of squared deviations << (2 * STATS_MEAN_SHIFT)
+  uint16_t min;
+  uint16_t max;
+} tSTATS_PANE;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static STATS_Open_TypeDef config;
+static tSTATS_PANE pane[STATS_MAX_PANES];
+static uint32_t num_panes;                // window / hop
+static uint32_t cur_pane;                 // pane taking new samples
+static uint32_t full_panes;               // panes holding a complete hop
+static STATS_Summary_TypeDef last_summary;
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Empty a pane
+*
+******************************************************************************/
+static void stats_pane_reset(tSTATS_PANE *p){
+  p->n = 0;
+  p->mean = 0;
+  p->m2 = 0;
+  p->min = UINT16_MAX;
+  p->max = 0;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Merge one pane into another
+*
+* @details
+*  Chan's parallel form of Welford's update, so a window is the exact
+*  combination of its hops without keeping any samples.
+*
+* @param [in] acc
+*  Accumulated panes, updated in place
+*
+* @param [in] p
+*  Pane to add
+*
+******************************************************************************/
+static void stats_pane_merge(tSTATS_PANE *acc, const tSTATS_PANE *p){
+  if(!p->n){
+      return;
+  }
+  if(!acc->n){
+      *acc = *p;
+      return;
+  }
+
+  uint32_t n = acc->n + p->n;
+  int32_t delta = p->mean - acc->mean;
+  uint64_t delta2 = (uint64_t)((int64_t)delta * delta);
+
+  acc->mean += (int32_t)(((int64_t)delta * p->n) / n);
+  acc->m2 += p->m2 + delta2 / n * acc->n * p->n;
+  acc->n = n;
+  if(p->min < acc->min) acc->min = p->min;
+  if(p->max > acc->max) acc->max = p->max;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Configure the statistics windows
+*
+* @details
+*  A tumbling window uses hop == window. A sliding window reports every hop
+*  samples over the last window samples, and window must be a multiple of
+*  hop. Memory is fixed at STATS_MAX_PANES accumulators regardless of the
+*  window length.
+*
+* @param [in] stats_open
+*  Window length, hop and the event to post when a summary is ready
+*
+******************************************************************************/
+void stats_open(STATS_Open_TypeDef *stats_open){
+  config = *stats_open;
+  last_summary.seq = 0;
+  stats_set_window(config.window, config.hop);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Change the window and hop
+*
+* @details
+*  The samples of the window being built are dropped, the next summary
+*  covers a full window at the new length. Summary numbers carry on.
+*
+* @param [in] window
+*  Samples covered by each summary
+*
+* @param [in] hop
+*  Samples between summaries
+*
+******************************************************************************/
+void stats_set_window(uint32_t window, uint32_t hop){
+  EFM_ASSERT(hop && window <= STATS_MAX_WINDOW);
+  EFM_ASSERT(window % hop == 0);
+  EFM_ASSERT(window / hop <= STATS_MAX_PANES);
+
+  config.window = window;
+  config.hop = hop;
+  num_panes = window / hop;
+  cur_pane = 0;
+  full_panes = 0;
+
+  for(uint32_t i = 0; i < num_panes; i++){
+      stats_pane_reset(&pane[i]);
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add a sample
+*
+* @details
+*  Welford's update in fixed point on the current pane, O(1) per sample.
+*  Once per hop the panes of the window are merged into a summary and the
+*  configured event is posted, so consumers only run once per hop.
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+******************************************************************************/
+void stats_update(uint32_t raw){
+  tSTATS_PANE *p = &pane[cur_pane];
+  int32_t x = (int32_t)raw << STATS_MEAN_SHIFT;
+
+  p->n++;
+  int32_t delta = x - p->mean;
+  p->mean += delta / (int32_t)p->n;
+  p->m2 += (uint64_t)((int64_t)delta * (x - p->mean));
+  if(raw < p->min) p->min = raw;
+  if(raw > p->max) p->max = raw;
+
+  if(p->n < config.hop){
+      return;
+  }
+
+  // hop complete, move on to the oldest pane
+  if(full_panes < num_panes){
+      full_panes++;
+  }
+  cur_pane = (cur_pane + 1) % num_panes;
+
+  if(full_panes == num_panes){
+      tSTATS_PANE acc;
+      stats_pane_reset(&acc);
+      for(uint32_t i = 0; i < num_panes; i++){
+          stats_pane_merge(&acc, &pane[i]);
+      }
+
+      last_summary.seq++;
+      last_summary.count = acc.n;
+      last_summary.min = acc.min;
+      last_summary.max = acc.max;
+      last_summary.mean = (acc.mean + (1 << (STATS_MEAN_SHIFT - 1))) >> STATS_MEAN_SHIFT;
+      last_summary.variance = (acc.m2 / acc.n) >> (2 * STATS_MEAN_SHIFT);
+
+      add_scheduled_event(config.cb);
+  }
+
+  stats_pane_reset(&pane[cur_pane]);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Get the latest window summary
+*
+* @param [out] summary
+*  Copy of the most recent summary
+*
+******************************************************************************/
+void stats_get_summary(STATS_Summary_TypeDef *summary){
+  *summary = last_summary;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file telemetry.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Framed binary telemetry over LEUART
+ *
+ * @details
+ *  Frames are built into one of two buffers and handed to the LEUART LDMA
+ *  transmit, so the core only wakes to build a frame and once more when it
+ *  has left the pin. While one buffer is on the wire the other can be
+ *  filled; a frame arriving while both are busy is dropped and counted.
+ *
+ *  At 9600 baud a full frame (38 bytes) is on the wire for about 40 ms,
+ *  which bounds the stream at roughly 25 frames per second.
+ *
+ *  The core time a frame costs is split over four probes that don't nest:
+ *  PROF_TELEMETRY_BUILD, PROF_TELEMETRY_SEND for the LDMA start,
+ *  PROF_LEUART0_IRQ for the transmit complete interrupt and
+ *  PROF_TELEMETRY_TX_DONE for releasing the buffer. sim_device adds them up
+ *  per frame.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "telemetry.h"
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+typedef enum{
+  TELEMETRY_FREE,
+  TELEMETRY_PENDING,            // built, waiting for the LEUART
+  TELEMETRY_SENDING             // owned by the LDMA until telemetry_tx_done()
+} TELEMETRY_Buffer_State;
+
+typedef struct{
+  TELEMETRY_Buffer_State state;
+  uint32_t len;
+  uint8_t data[TELEMETRY_MAX_FRAME];
+} TELEMETRY_Buffer_TypeDef;
+
+static TELEMETRY_Buffer_TypeDef buffer[TELEMETRY_BUFFERS];
+static LEUART_TypeDef *telemetry_leuart;
+static uint8_t telemetry_seq;
+
+// samples waiting for the next TELEMETRY_SAMPLES frame
+static CODEC_State_TypeDef sample_codec;
+static uint8_t sample_payload[TELEMETRY_MAX_PAYLOAD];
+static uint32_t sample_len;
+static uint32_t sample_count;
+static uint32_t samples_per_frame;
+
+static TELEMETRY_Stats_TypeDef telemetry_stats;
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start the next pending frame if the LEUART is idle
+*
+******************************************************************************/
+static void telemetry_kick(void){
+  for(uint32_t i = 0; i < TELEMETRY_BUFFERS; i++){
+      if(buffer[i].state == TELEMETRY_SENDING){
+          return;
+      }
+  }
+  for(uint32_t i = 0; i < TELEMETRY_BUFFERS; i++){
+      if(buffer[i].state == TELEMETRY_PENDING){
+          PROF_BEGIN(PROF_TELEMETRY_SEND);
+          buffer[i].state = TELEMETRY_SENDING;
+          leuart_tx_dma(telemetry_leuart, buffer[i].data, buffer[i].len);
+          PROF_END(PROF_TELEMETRY_SEND);
+          return;
+      }
+  }
+}
+
+//***********************************************************************************
+// Functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Start the telemetry stream
+*
+* @param [in] telemetry_open
+*  The LEUART to transmit on and the sample batching
+*
+******************************************************************************/
+void telemetry_open(TELEMETRY_Open_TypeDef *telemetry_open){
+  EFM_ASSERT(telemetry_open->samples_per_frame);
+
+  telemetry_leuart = telemetry_open->leuart;
+  samples_per_frame = telemetry_open->samples_per_frame;
+  telemetry_seq = 0;
+  sample_len = 0;
+  sample_count = 0;
+  codec_init(&sample_codec, CODEC_KEYFRAME_INTERVAL);
+  memset(buffer, 0, sizeof(buffer));
+  memset(&telemetry_stats, 0, sizeof(telemetry_stats));
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Frame and queue a payload
+*
+* @details
+*  The frame is built in a free buffer and goes out as soon as the LEUART
+*  is idle. The payload is copied, so the caller's buffer is free on return.
+*
+* @param [in] type
+*  Frame type, TELEMETRY_SAMPLES, TELEMETRY_SUMMARY or TELEMETRY_EVENT
+*
+* @param [in] payload
+*  Payload bytes
+*
+* @param [in] len
+*  Payload length, at most TELEMETRY_MAX_PAYLOAD
+*
+* @return
+*  false if both buffers were busy and the frame was dropped
+*
+******************************************************************************/
+bool telemetry_send(uint32_t type, const uint8_t *payload, uint32_t len){
+  TELEMETRY_Buffer_TypeDef *b = NULL;
+
+  EFM_ASSERT(len <= TELEMETRY_MAX_PAYLOAD);
+
+  for(uint32_t i = 0; i < TELEMETRY_BUFFERS; i++){
+      if(buffer[i].state == TELEMETRY_FREE){
+          b = &buffer[i];
+          break;
+      }
+  }
+  if(b == NULL){
+      telemetry_stats.dropped++;
+      telemetry_seq++;                              // receiver sees the gap
+      return false;
+  }
+
+  PROF_BEGIN(PROF_TELEMETRY_BUILD);
+  b->data[0] = TELEMETRY_SYNC;
+  b->data[1] = (uint8_t)type;
+  b->data[2] = telemetry_seq++;
+  b->data[3] = (uint8_t)len;
+  memcpy(&b->data[TELEMETRY_HEADER_SIZE], payload, len);
+
+  uint16_t crc = crc16(CRC16_INIT, &b->data[1], TELEMETRY_HEADER_SIZE - 1 + len);
+  b->data[TELEMETRY_HEADER_SIZE + len] = (uint8_t)(crc >> 8);
+  b->data[TELEMETRY_HEADER_SIZE + len + 1] = (uint8_t)crc;
+
+  b->len = TELEMETRY_HEADER_SIZE + len + TELEMETRY_CRC_SIZE;
+  b->state = TELEMETRY_PENDING;
+  PROF_END(PROF_TELEMETRY_BUILD);
+
+  telemetry_stats.frames++;
+  telemetry_stats.bytes += b->len;
+
+  telemetry_kick();
+  return true;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Add a sample to the next TELEMETRY_SAMPLES frame
+*
+* @details
+*  Samples are delta/varint encoded with the first one of every frame a
+*  keyframe, so a frame decodes on its own even after a dropped one. The
+*  frame is sent once samples_per_frame samples are in or another sample
+*  might not fit.
+*
+* @param [in] raw
+*  Raw sensor reading
+*
+******************************************************************************/
+void telemetry_add_sample(uint32_t raw){
+  if(sample_len == 0){
+      codec_keyframe(&sample_codec);
+  }
+  sample_len += codec_encode(&sample_codec, raw, &sample_payload[sample_len]);
+  sample_count++;
+
+  if(sample_count >= samples_per_frame || sample_len + CODEC_MAX_BYTES > TELEMETRY_MAX_PAYLOAD){
+      telemetry_flush_samples();
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Send the samples collected so far
+*
+******************************************************************************/
+void telemetry_flush_samples(void){
+  if(sample_len){
+      telemetry_send(TELEMETRY_SAMPLES, sample_payload, sample_len);
+      sample_len = 0;
+      sample_count = 0;
+  }
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Release the frame that just went out and start the next one
+*
+* @details
+*  Called from the scheduler on the LEUART tx done event.
+*
+******************************************************************************/
+void telemetry_tx_done(void){
+  PROF_BEGIN(PROF_TELEMETRY_TX_DONE);
+  for(uint32_t i = 0; i < TELEMETRY_BUFFERS; i++){
+      if(buffer[i].state == TELEMETRY_SENDING){
+          buffer[i].state = TELEMETRY_FREE;
+      }
+  }
+  PROF_END(PROF_TELEMETRY_TX_DONE);
+  telemetry_kick();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Read the telemetry counters
+*
+* @param [out] stats
+*  Filled with the counters since telemetry_open()
+*
+******************************************************************************/
+void telemetry_get_stats(TELEMETRY_Stats_TypeDef *stats){
+  *stats = telemetry_stats;
+}
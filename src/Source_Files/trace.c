@@ -0,0 +1,228 @@
+/**
+ * @file trace.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Event trace and fault record kept in retained RAM
+ *
+ * @details
+ *  The log lives in RETAINED RAM behind a magic word, like the assert log,
+ *  so the entries written up to a reset and the registers of a fault are
+ *  still there on the next boot. trace_open() copies out the entries the
+ *  previous boot wrote, from the head it marked at its own start, before the
+ *  new boot starts writing. Entries of earlier boots were handed out by the
+ *  boot after them, so each one is reported once. trace_last() and
+ *  trace_last_fault() hand the copy to whoever reports it.
+ *
+ *  On the target HardFault_Handler() records the exception frame and the
+ *  fault status registers. A failed EFM_ASSERT is recorded the same way when
+ *  built with DEBUG_EFM_USER, which makes emlib call the assertEFM() below.
+ *  Either one then stops at a breakpoint when a debugger is attached, and
+ *  resets the device otherwise.
+ *
+ */
+
+//***********************************************************************************
+// Include files
+//***********************************************************************************
+
+#include "trace.h"
+#include "em_core.h"
+
+//***********************************************************************************
+// Defined files
+//***********************************************************************************
+
+#define TRACE_MAGIC           0x7EACE10Du
+
+//***********************************************************************************
+// Global variables
+//***********************************************************************************
+
+RETAINED TRACE_Log_TypeDef trace_log;
+
+//***********************************************************************************
+// Private variables
+//***********************************************************************************
+
+static uint32_t last_entry[TRACE_ENTRIES];    // previous boot, oldest first
+static uint32_t last_count;
+static TRACE_Fault_TypeDef last_fault;
+
+//***********************************************************************************
+// Private functions
+//***********************************************************************************
+
+#ifdef SCB
+/***************************************************************************//**
+* @brief
+*  Hand a recorded fault to the debugger, or reset
+*
+******************************************************************************/
+static void trace_stop(void){
+  if(CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk){
+      __BKPT(0);
+  }
+  NVIC_SystemReset();
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Record a HardFault
+*
+* @param [in] frame
+*  Exception frame, r0 r1 r2 r3 r12 lr pc xpsr
+*
+******************************************************************************/
+__attribute__((used)) static void trace_hard_fault(uint32_t *frame){
+  TRACE_Fault_TypeDef *f = &trace_log.fault;
+  uint32_t cfsr = SCB->CFSR;
+
+  f->kind = TRACE_FAULT_HARD;
+  f->lr = frame[5];
+  f->pc = frame[6];
+  f->xpsr = frame[7];
+  f->cfsr = cfsr;
+  f->hfsr = SCB->HFSR;
+  f->addr = (cfsr & SCB_CFSR_BFARVALID_Msk) ? SCB->BFAR :
+            (cfsr & SCB_CFSR_MMARVALID_Msk) ? SCB->MMFAR : 0u;
+  f->sp = (uint32_t)frame;
+  trace_stop();
+}
+#endif
+
+//***********************************************************************************
+// Global functions
+//***********************************************************************************
+
+/***************************************************************************//**
+* @brief
+*  Keep the trace of the previous boot, or start an empty one
+*
+* @details
+*  Call once at boot, before anything writes to the trace. Only entries
+*  written since the previous boot's mark are kept, at most the last
+*  TRACE_ENTRIES of them, and the mark moves to the current head.
+*
+******************************************************************************/
+void trace_open(void){
+  uint32_t written;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_CRITICAL();
+
+  if(trace_log.magic != TRACE_MAGIC){
+      trace_log = (TRACE_Log_TypeDef){ .magic = TRACE_MAGIC };
+  }
+
+  written = trace_log.head - trace_log.boot_head;
+  last_count = written < TRACE_ENTRIES ? written : TRACE_ENTRIES;
+  for(uint32_t i = 0; i < last_count; i++){
+      last_entry[i] = trace_log.entry[(trace_log.head - last_count + i) & (TRACE_ENTRIES - 1u)];
+  }
+  trace_log.boot_head = trace_log.head;
+  last_fault = trace_log.fault;
+  trace_log.fault.kind = TRACE_FAULT_NONE;
+  trace_log.boots++;
+
+  CORE_EXIT_CRITICAL();
+
+  trace(TRACE_BOOT, trace_log.boots);
+}
+
+
+/***************************************************************************//**
+* @brief
+*  Copy out entries the previous boot wrote, oldest first
+*
+* @param [in] first
+*  Position of the first entry to copy, 0 for the oldest one kept
+*
+* @param [in] entries
+*  Destination
+*
+* @param [in] max
+*  Entries the destination holds
+*
+* @return
+*  Entries copied, 0 once first is past the last one
+*
+******************************************************************************/
+uint32_t trace_last(uint32_t first, uint32_t *entries, uint32_t max){
+  uint32_t n = 0;
+
+  while(first + n < last_count && n < max){
+      entries[n] = last_entry[first + n];
+      n++;
+  }
+  return n;
+}
+
+
+/***************************************************************************//**
+* @brief
+*  The fault that ended the previous boot
+*
+* @param [in] fault
+*  Filled in
+*
+* @return
+*  false when the previous boot did not end in a recorded fault
+*
+******************************************************************************/
+bool trace_last_fault(TRACE_Fault_TypeDef *fault){
+  *fault = last_fault;
+  return last_fault.kind != TRACE_FAULT_NONE;
+}
+
+
+#ifdef SCB
+/***************************************************************************//**
+* @brief
+*  HardFault entry, passes the exception frame of the stack in use to
+*  trace_hard_fault()
+*
+******************************************************************************/
+__attribute__((naked)) void HardFault_Handler(void){
+  __asm volatile(
+      "tst lr, #4             \n"
+      "ite eq                 \n"
+      "mrseq r0, msp          \n"
+      "mrsne r0, psp          \n"
+      "b trace_hard_fault     \n");
+}
+
+
+#ifdef DEBUG_EFM_USER
+/***************************************************************************//**
+* @brief
+*  Record a failed EFM_ASSERT
+*
+* @param [in] file
+*  Source file of the check
+*
+* @param [in] line
+*  Line of the check
+*
+******************************************************************************/
+void assertEFM(const char *file, int line){
+  TRACE_Fault_TypeDef *f = &trace_log.fault;
+
+  __disable_irq();
+  trace(TRACE_ASSERT, (uint32_t)line);
+  *f = (TRACE_Fault_TypeDef){ 0 };
+  f->kind = TRACE_FAULT_ASSERT;
+  f->pc = (uint32_t)__builtin_return_address(0);
+  f->lr = (uint32_t)line;
+  f->addr = (uint32_t)file;
+  f->sp = __get_MSP();
+  trace_stop();
+}
+#endif /* DEBUG_EFM_USER */
+#endif /* SCB */
@@ -17,11 +17,100 @@
 
 #include "main.h"
 
+/*
+ * Run the callback of every pending event, in this fixed order. Built into
+ * RAM with the interrupt handlers when RAM_HOT_PATHS is defined.
+ */
+HOT_PATH static void dispatch_events(void)
+{
+  if(get_scheduled_events() & APP_BTN0_CB){
+      remove_scheduled_event(APP_BTN0_CB);
+      PROF_BEGIN(PROF_APP_BTN0_CB);
+      scheduled_record_button_press_cb(APP_BTN0_CB);
+      PROF_END(PROF_APP_BTN0_CB);
+  }
+  if(get_scheduled_events() & APP_BTN1_CB){
+      remove_scheduled_event(APP_BTN1_CB);
+      PROF_BEGIN(PROF_APP_BTN1_CB);
+      scheduled_record_button_press_cb(APP_BTN1_CB);
+      PROF_END(PROF_APP_BTN1_CB);
+  }
+  if(get_scheduled_events() & LETIMER_COMP0_IRQ_CB){
+      remove_scheduled_event(LETIMER_COMP0_IRQ_CB);
+      PROF_BEGIN(PROF_LETIMER_COMP0_CB);
+      scheduled_letimer_comp0_cb();
+      PROF_END(PROF_LETIMER_COMP0_CB);
+  }
+  if(get_scheduled_events() & LETIMER_COMP1_IRQ_CB){
+      remove_scheduled_event(LETIMER_COMP1_IRQ_CB);
+      PROF_BEGIN(PROF_LETIMER_COMP1_CB);
+      scheduled_letimer_comp1_cb();
+      PROF_END(PROF_LETIMER_COMP1_CB);
+  }
+  if(get_scheduled_events() & LETIMER_UF_IRQ_CB){
+      remove_scheduled_event(LETIMER_UF_IRQ_CB);
+      PROF_BEGIN(PROF_LETIMER_UF_CB);
+      scheduled_letimer_uf_cb();
+      PROF_END(PROF_LETIMER_UF_CB);
+  }
+  if(get_scheduled_events() & SENSOR_SAMPLE_CB){
+      remove_scheduled_event(SENSOR_SAMPLE_CB);
+      PROF_BEGIN(PROF_SENSOR_SAMPLE_CB);
+      scheduled_sensor_sample_cb();
+      PROF_END(PROF_SENSOR_SAMPLE_CB);
+  }
+  if(get_scheduled_events() & ALARM_CB){
+      remove_scheduled_event(ALARM_CB);
+      PROF_BEGIN(PROF_ALARM_CB);
+      scheduled_alarm_cb();
+      PROF_END(PROF_ALARM_CB);
+  }
+  if(get_scheduled_events() & STATS_CB){
+      remove_scheduled_event(STATS_CB);
+      PROF_BEGIN(PROF_STATS_CB);
+      scheduled_stats_cb();
+      PROF_END(PROF_STATS_CB);
+  }
+  if(get_scheduled_events() & FLASH_LOG_CB){
+      remove_scheduled_event(FLASH_LOG_CB);
+      PROF_BEGIN(PROF_FLASH_LOG_CB);
+      scheduled_flash_log_cb();
+      PROF_END(PROF_FLASH_LOG_CB);
+  }
+  if(get_scheduled_events() & TELEMETRY_TX_CB){
+      remove_scheduled_event(TELEMETRY_TX_CB);
+      PROF_BEGIN(PROF_TELEMETRY_TX_CB);
+      scheduled_telemetry_tx_cb();
+      PROF_END(PROF_TELEMETRY_TX_CB);
+  }
+  if(get_scheduled_events() & SHELL_RX_CB){
+      remove_scheduled_event(SHELL_RX_CB);
+      PROF_BEGIN(PROF_SHELL_RX_CB);
+      scheduled_shell_rx_cb();
+      PROF_END(PROF_SHELL_RX_CB);
+  }
+  if(get_scheduled_events() & SENSOR_STEP_CB){
+      remove_scheduled_event(SENSOR_STEP_CB);
+      PROF_BEGIN(PROF_SENSOR_STEP_CB);
+      scheduled_sensor_step_cb();
+      PROF_END(PROF_SENSOR_STEP_CB);
+  }
+  if(get_scheduled_events() & SENSOR_ERROR_CB){
+      remove_scheduled_event(SENSOR_ERROR_CB);
+      PROF_BEGIN(PROF_SENSOR_ERROR_CB);
+      scheduled_sensor_error_cb();
+      PROF_END(PROF_SENSOR_ERROR_CB);
+  }
+}
+
 int main(void)
 {
   EMU_DCDCInit_TypeDef dcdcInit = EMU_DCDCINIT_DEFAULT;
   CMU_HFXOInit_TypeDef hfxoInit = CMU_HFXOINIT_DEFAULT;
 
+  /* Paint the free stack for the high water mark */
+  mem_paint_stack();
+
   /* Chip errata */
   CHIP_Init();
 
@@ -48,46 +137,13 @@ int main(void)
       CORE_DECLARE_IRQ_STATE;
       CORE_ENTER_CRITICAL();
       if(!get_scheduled_events()){
+          PROF_SLEEP();
           enter_sleep();
+          PROF_WAKE();
       }
       CORE_EXIT_CRITICAL();
 
-      if(get_scheduled_events() & GPIO_ODD_IRQ_CB){
-          remove_scheduled_event(GPIO_ODD_IRQ_CB);
-          scheduled_gpio_odd_irq_cb();
-      }
-      if(get_scheduled_events() & GPIO_EVEN_IRQ_CB){
-          remove_scheduled_event(GPIO_EVEN_IRQ_CB);
-          scheduled_gpio_even_irq_cb();
-      }
-      if(get_scheduled_events() & APP_BTN0_CB){
-          remove_scheduled_event(APP_BTN0_CB);
-          scheduled_record_button_press_cb(APP_BTN0_CB);
-      }
-      if(get_scheduled_events() & APP_BTN1_CB){
-          remove_scheduled_event(APP_BTN1_CB);
-          scheduled_record_button_press_cb(APP_BTN1_CB);
-      }
-      if(get_scheduled_events() & APP_CHK_INPUT_CB){
-          remove_scheduled_event(APP_CHK_INPUT_CB);
-          app_state_machine();
-      }
-      if(get_scheduled_events() & LETIMER_COMP0_IRQ_CB){
-          remove_scheduled_event(LETIMER_COMP0_IRQ_CB);
-          scheduled_letimer_comp0_cb();
-      }
-      if(get_scheduled_events() & LETIMER_COMP1_IRQ_CB){
-          remove_scheduled_event(LETIMER_COMP1_IRQ_CB);
-          scheduled_letimer_comp1_cb();
-      }
-      if(get_scheduled_events() & LETIMER_UF_IRQ_CB){
-          remove_scheduled_event(LETIMER_UF_IRQ_CB);
-          scheduled_letimer_uf_cb();
-      }
-      if(get_scheduled_events() & SI7021_TEMP_READ_CB){
-          remove_scheduled_event(SI7021_TEMP_READ_CB);
-          scheduled_read_i2c_cb();
-      }
+      dispatch_events();
   }
 }
 
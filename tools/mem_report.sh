@@ -0,0 +1,59 @@
+#!/bin/sh
+#
+# @file mem_report.sh
+#
+# @brief
+#  Flash and RAM used by each firmware module
+#
+# @details
+#  Runs size over the object files of a build and prints one line per module,
+#  largest RAM user first, then the totals. Flash is text + data (the
+#  initial values of .data live in flash), RAM is data + bss. The stack and
+#  heap are reserved by the linker script and not counted here, mem_get()
+#  reports the stack at run time.
+#
+#  Usage:
+#    tools/mem_report.sh <build dir | object files>...
+#
+#  SIZE picks the size tool, arm-none-eabi-size when it is installed and the
+#  host size otherwise, e.g. for the host build:
+#    tools/mem_report.sh build/host/CMakeFiles/firmware.dir
+#
+
+if [ $# -eq 0 ]; then
+  echo "usage: $0 <build dir | object files>..." >&2
+  exit 1
+fi
+
+if [ -z "$SIZE" ]; then
+  if command -v arm-none-eabi-size >/dev/null 2>&1; then
+    SIZE=arm-none-eabi-size
+  else
+    SIZE=size
+  fi
+fi
+
+objects=$(for arg in "$@"; do
+  if [ -d "$arg" ]; then
+    find "$arg" -name '*.o' -o -name '*.obj'
+  else
+    echo "$arg"
+  fi
+done | sort)
+
+if [ -z "$objects" ]; then
+  echo "$0: no object files found" >&2
+  exit 1
+fi
+
+# berkeley format: text data bss dec hex filename
+$SIZE -B $objects | awk '
+  NR > 1 {
+    n = split($6, path, "/")
+    module = path[n]
+    sub(/\.(c\.)?o(bj)?$/, "", module)
+    printf "%8d %8d %8d %8d  %s\n", $2 + $3, $1 + $2, $2, $3, module
+  }' | sort -rn | awk '
+  BEGIN { printf "%8s %8s %8s %8s  %s\n", "ram", "flash", "data", "bss", "module" }
+  { print; ram += $1; flash += $2 }
+  END { printf "%8d %8d %8s %8s  %s\n", ram, flash, "", "", "total" }'
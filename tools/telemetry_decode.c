@@ -0,0 +1,262 @@
+/**
+ * @file telemetry_decode.c
+ *
+ * @author
+ *  Ginn Sato
+ *
+ * @date
+ *  10/18/2026
+ *
+ * @brief
+ *  Host decoder for the LEUART telemetry stream
+ *
+ * @details
+ *  Reads frames from a serial port, pty or capture file (stdin if no path is
+ *  given), checks the CRC and prints one line per record. A tty is switched
+ *  to raw mode at the firmware baud rate. Resyncs on TELEMETRY_SYNC after a
+ *  bad frame, and reports sequence gaps and the frame rate on exit.
+ *
+ *  With -r only the samples are printed, one raw Si7021 code per line, the
+ *  trace format host/bench/bench_codec reads.
+ *
+ *  Build:
+ *    cc -O2 -Isrc/Header_Files -o telemetry_decode tools/telemetry_decode.c \
+ *       src/Source_Files/codec.c src/Source_Files/crc.c
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include "telemetry_frame.h"
+#include "codec.h"
+#include "crc.h"
+
+#define SI7021_RAW_TO_C(raw)    ((175.72 * (raw)) / 65536.0 - 46.85)
+
+typedef struct{
+  unsigned long frames;
+  unsigned long crc_errors;
+  unsigned long lost;
+  unsigned long resync_bytes;
+} decode_stats_t;
+
+static double now(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool raw_only;                   // -r, sample codes only
+
+static void print_frame(const uint8_t *frame){
+  uint32_t type = frame[1];
+  uint32_t seq = frame[2];
+  uint32_t len = frame[3];
+  const uint8_t *p = &frame[TELEMETRY_HEADER_SIZE];
+
+  if(raw_only && type != TELEMETRY_SAMPLES){
+      return;
+  }
+  switch(type){
+    case TELEMETRY_SAMPLES: {
+      CODEC_State_TypeDef codec;
+      uint16_t raw;
+      uint32_t used;
+
+      codec_init(&codec, CODEC_KEYFRAME_INTERVAL);
+      if(raw_only){
+          while(len && (used = codec_decode(&codec, p, len, &raw)) != 0){
+              printf("%u\n", (unsigned)raw);
+              p += used;
+              len -= used;
+          }
+          break;
+      }
+      printf("%3u samples", (unsigned)seq);
+      while(len && (used = codec_decode(&codec, p, len, &raw)) != 0){
+          printf(" %.2f", SI7021_RAW_TO_C(raw));
+          p += used;
+          len -= used;
+      }
+      printf(len ? " (truncated)\n" : "\n");
+      break;
+    }
+    case TELEMETRY_SUMMARY:
+      if(len < TELEMETRY_SUMMARY_SIZE){
+          printf("%3u summary (short)\n", (unsigned)seq);
+          break;
+      }
+      printf("%3u summary #%u n=%u min=%.2f max=%.2f mean=%.2f var=%u reported=%u\n", (unsigned)seq,
+             (unsigned)telemetry_get32(&p[TELEMETRY_SUMMARY_SEQ]),
+             (unsigned)telemetry_get16(&p[TELEMETRY_SUMMARY_COUNT]),
+             SI7021_RAW_TO_C(telemetry_get16(&p[TELEMETRY_SUMMARY_MIN])),
+             SI7021_RAW_TO_C(telemetry_get16(&p[TELEMETRY_SUMMARY_MAX])),
+             SI7021_RAW_TO_C(telemetry_get16(&p[TELEMETRY_SUMMARY_MEAN])),
+             (unsigned)telemetry_get32(&p[TELEMETRY_SUMMARY_VARIANCE]),
+             (unsigned)telemetry_get16(&p[TELEMETRY_SUMMARY_REPORTED]));
+      break;
+    case TELEMETRY_EVENT:
+      if(len < TELEMETRY_EVENT_SIZE){
+          printf("%3u event (short)\n", (unsigned)seq);
+          break;
+      }
+      printf("%3u event state=0x%x changed=0x%x at %.2f\n", (unsigned)seq,
+             (unsigned)telemetry_get32(&p[TELEMETRY_EVENT_STATE]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_EVENT_CHANGED]),
+             SI7021_RAW_TO_C(telemetry_get16(&p[TELEMETRY_EVENT_RAW])));
+      break;
+    case TELEMETRY_MEMORY:
+      if(len < TELEMETRY_MEMORY_SIZE){
+          printf("%3u memory (short)\n", (unsigned)seq);
+          break;
+      }
+      printf("%3u memory stack %u/%u bytes, static ram %u bytes\n", (unsigned)seq,
+             (unsigned)telemetry_get16(&p[TELEMETRY_MEMORY_STACK_PEAK]),
+             (unsigned)telemetry_get16(&p[TELEMETRY_MEMORY_STACK_SIZE]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_MEMORY_STATIC_RAM]));
+      break;
+    case TELEMETRY_TRACE: {
+      static const char *tag[] = { "?", "boot", "post", "dispatch", "i2c", "sleep", "assert" };     // by TRACE_* tag
+      uint32_t first;
+      if(len < TELEMETRY_TRACE_ENTRIES){
+          printf("%3u trace (short)\n", (unsigned)seq);
+          break;
+      }
+      first = p[TELEMETRY_TRACE_FIRST];
+      for(uint32_t i = 0; TELEMETRY_TRACE_ENTRIES + 4 * i + 4 <= len; i++){
+          uint32_t e = telemetry_get32(&p[TELEMETRY_TRACE_ENTRIES + 4 * i]);
+          uint32_t t = e >> 24;
+          printf("%3u trace %2u %-8s 0x%06x\n", (unsigned)seq, (unsigned)(first + i),
+                 t < sizeof(tag) / sizeof(tag[0]) ? tag[t] : "?", (unsigned)(e & 0xFFFFFFu));
+      }
+      break;
+    }
+    case TELEMETRY_FAULT:
+      if(len < TELEMETRY_FAULT_SIZE){
+          printf("%3u fault (short)\n", (unsigned)seq);
+          break;
+      }
+      printf("%3u fault %s pc=0x%08x lr=0x%08x xpsr=0x%08x cfsr=0x%08x hfsr=0x%08x addr=0x%08x sp=0x%08x\n",
+             (unsigned)seq, p[TELEMETRY_FAULT_KIND] == 1 ? "hardfault" : "assert",     // TRACE_FAULT_HARD
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_PC]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_LR]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_XPSR]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_CFSR]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_HFSR]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_ADDR]),
+             (unsigned)telemetry_get32(&p[TELEMETRY_FAULT_SP]));
+      break;
+    case TELEMETRY_REPLY: {
+      static const char *status[] = { "ok", "unknown command", "out of range", "syntax error", "bad crc" };
+      uint32_t s;
+      if(len < TELEMETRY_REPLY_SIZE){
+          printf("%3u reply (short)\n", (unsigned)seq);
+          break;
+      }
+      s = p[TELEMETRY_REPLY_STATUS];
+      printf("%3u reply cmd %u: %s, %d\n", (unsigned)seq, (unsigned)p[TELEMETRY_REPLY_ID],
+             s < sizeof(status) / sizeof(status[0]) ? status[s] : "?",
+             (int)(int32_t)telemetry_get32(&p[TELEMETRY_REPLY_VALUE]));
+      break;
+    }
+    default:
+      printf("%3u type 0x%02x, %u bytes\n", (unsigned)seq, (unsigned)type, (unsigned)len);
+      break;
+  }
+  fflush(stdout);
+}
+
+static uint8_t frame[TELEMETRY_MAX_FRAME];
+static uint32_t have;
+static int next_seq = -1;
+static decode_stats_t st;
+static double start;
+
+static void decode_byte(uint8_t byte){
+  if(have == 0 && byte != TELEMETRY_SYNC){
+      st.resync_bytes++;
+      return;
+  }
+  frame[have++] = byte;
+  if(have == TELEMETRY_HEADER_SIZE && frame[3] > TELEMETRY_MAX_PAYLOAD){
+      have = 0;                                     // not a header, hunt for the next sync
+      st.resync_bytes += TELEMETRY_HEADER_SIZE;
+      return;
+  }
+  if(have < TELEMETRY_HEADER_SIZE || have < TELEMETRY_HEADER_SIZE + frame[3] + TELEMETRY_CRC_SIZE){
+      return;
+  }
+
+  uint32_t len = frame[3];
+  uint16_t crc = crc16(CRC16_INIT, &frame[1], TELEMETRY_HEADER_SIZE - 1 + len);
+  uint16_t got = (uint16_t)((frame[TELEMETRY_HEADER_SIZE + len] << 8) | frame[TELEMETRY_HEADER_SIZE + len + 1]);
+  if(crc != got){
+      // the sync byte was probably payload, rescan what followed it
+      uint8_t rest[TELEMETRY_MAX_FRAME];
+      uint32_t n = have - 1;
+
+      st.crc_errors++;
+      st.resync_bytes++;
+      memcpy(rest, &frame[1], n);
+      have = 0;
+      for(uint32_t i = 0; i < n; i++){
+          decode_byte(rest[i]);
+      }
+      return;
+  }
+
+  if(st.frames == 0){
+      start = now();
+  }
+  if(next_seq >= 0 && frame[2] != next_seq){
+      st.lost += (uint8_t)(frame[2] - next_seq);
+  }
+  next_seq = (uint8_t)(frame[2] + 1);
+  st.frames++;
+  print_frame(frame);
+  have = 0;
+}
+
+int main(int argc, char **argv){
+  uint8_t buf[256];
+  ssize_t n;
+  int fd = STDIN_FILENO;
+
+  if(argc > 1 && !strcmp(argv[1], "-r")){
+      raw_only = true;
+      argc--;
+      argv++;
+  }
+  if(argc > 1 && (fd = open(argv[1], O_RDONLY | O_NOCTTY)) < 0){
+      perror(argv[1]);
+      return 1;
+  }
+  if(isatty(fd)){
+      struct termios tio;
+      tcgetattr(fd, &tio);
+      cfmakeraw(&tio);
+      cfsetispeed(&tio, B9600);
+      tcsetattr(fd, TCSANOW, &tio);
+  }
+
+  while((n = read(fd, buf, sizeof(buf))) > 0){
+      for(ssize_t i = 0; i < n; i++){
+          decode_byte(buf[i]);
+      }
+  }
+
+  double elapsed = now() - start;
+  fprintf(stderr, "%lu frames, %lu lost, %lu crc errors, %lu bytes skipped",
+          st.frames, st.lost, st.crc_errors, st.resync_bytes);
+  if(st.frames > 1 && elapsed > 0){
+      fprintf(stderr, ", %.2f frames/s", (st.frames - 1) / elapsed);
+  }
+  fprintf(stderr, "\n");
+  return 0;
+}